@@ -18,6 +18,9 @@
 #include "psp_interrupts_eh1.h"
 #include "psp_api.h"
 #include "bsp_printf.h"
+#ifdef BSP_USING_UART
+#include "drv_uart.h"
+#endif
 
 
 // Updates the variable SystemCoreClock and must be called 
@@ -30,6 +33,33 @@ extern void SystemCoreClockUpdate(void);
 extern uint32_t SystemCoreClock;
 
 #if defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP)
+#ifdef RT_USING_HEAP_LINKER
+// 堆从 .bss 结束处一直到启动栈底, 由链接脚本的符号决定, 换更大内存的板子时自动变大.
+// 这段内存不在 .bss 里, 启动代码不再清零; 各个分配器自己初始化所需的管理信息.
+#ifndef RT_HEAP_LINKER_BEGIN
+#define RT_HEAP_LINKER_BEGIN    _end
+#endif
+#ifndef RT_HEAP_LINKER_END
+#define RT_HEAP_LINKER_END      _sp
+#endif
+// 启动栈在 RT_HEAP_LINKER_END 之下, 调度器启动前仍在使用
+#ifndef RT_HEAP_STACK_RESERVE
+#define RT_HEAP_STACK_RESERVE   (4 * 1024)
+#endif
+
+extern char RT_HEAP_LINKER_BEGIN[];
+extern char RT_HEAP_LINKER_END[];
+
+RT_WEAK void *rt_heap_begin_get(void)
+{
+    return (void *)RT_ALIGN((rt_ubase_t)RT_HEAP_LINKER_BEGIN, RT_ALIGN_SIZE);
+}
+
+RT_WEAK void *rt_heap_end_get(void)
+{
+    return (void *)RT_ALIGN_DOWN((rt_ubase_t)RT_HEAP_LINKER_END - RT_HEAP_STACK_RESERVE, RT_ALIGN_SIZE);
+}
+#else
 #define RT_HEAP_SIZE 1024 * 10
 static uint32_t rt_heap[RT_HEAP_SIZE];     // heap default size: 10(1024 * 10)
 RT_WEAK void *rt_heap_begin_get(void)
@@ -42,18 +72,40 @@ RT_WEAK void *rt_heap_end_get(void)
     return rt_heap + RT_HEAP_SIZE;
 }
 #endif
+#endif
+
+#if defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP_FAST)
+// 堆的快速区域: SweRV DCCM 的一部分, 单周期访问. 链接脚本不能占用这段地址
+#ifndef RT_HEAP_FAST_BEGIN
+#define RT_HEAP_FAST_BEGIN  0xF0040000
+#endif
+#ifndef RT_HEAP_FAST_SIZE
+#define RT_HEAP_FAST_SIZE   (16 * 1024)
+#endif
+#endif
 
 /**
  * This function will initial your board.
  */
 void rt_hw_board_init()
 {
+#ifdef RT_USING_STACK_GUARD
+    /* before the first context switch programs the guard */
+    rt_hw_stack_guard_init();
+#endif
+
     /* Initialize system clock */
 
+#ifdef BSP_USING_UART
+    // 中断方式的串口设备, 控制台从这里开始经过设备输出
+    rt_hw_uart_init();
+    rt_console_set_device(RT_CONSOLE_DEVICE_NAME);
+#else
     // uart Init 
     uartInit();
 
     // rt_console_set_device(RT_CONSOLE_DEVICE_NAME);
+#endif
     
     /* Call components board initial (use INIT_BOARD_EXPORT()) */
 #ifdef RT_USING_COMPONENTS_INIT
@@ -61,8 +113,23 @@ void rt_hw_board_init()
 #endif
 
 #if defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP)
+#ifdef RT_USING_HEAP_LINKER
+    RT_ASSERT((rt_ubase_t)rt_heap_end_get() > (rt_ubase_t)rt_heap_begin_get());
+#endif
     rt_system_heap_init(rt_heap_begin_get(), rt_heap_end_get());
 #endif
+#if defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP_FAST)
+    rt_system_heap_fast_init((void *)RT_HEAP_FAST_BEGIN,
+                             (void *)(RT_HEAP_FAST_BEGIN + RT_HEAP_FAST_SIZE));
+#endif
+
+#if defined(RT_DEBUG) && defined(RT_USING_USER_MAIN) && defined(RT_USING_HEAP)
+    // 调试时打印堆范围, mcycle 从复位开始计数
+    rt_kprintf("heap 0x%08x - 0x%08x, %d KB, board init at %u cycles\n",
+               (rt_ubase_t)rt_heap_begin_get(), (rt_ubase_t)rt_heap_end_get(),
+               ((rt_ubase_t)rt_heap_end_get() - (rt_ubase_t)rt_heap_begin_get()) / 1024,
+               rt_hw_cycle_get());
+#endif
 }
 
 void SysTick_Handler(void)
@@ -82,6 +149,9 @@ void SysTick_Handler(void)
 void tick_init()
 {
     pspInterruptsSetVectorTableAddress(&psp_vect_table);
+#ifdef RT_USING_STACK_GUARD
+    rt_hw_stack_guard_trap_init();
+#endif
 
     pspRegisterInterruptHandler(SysTick_Handler, E_MACHINE_TIMER_CAUSE);
 
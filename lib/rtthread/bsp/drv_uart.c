@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Interrupt driven UART device "uart0" of the 16550 register set: the
+ * uart16550 of SweRVolf on Nexys A7, or with BSP_UART_QEMU the NS16550A of
+ * QEMU virt.
+ *
+ * Received bytes go from the RX FIFO to a ring in the interrupt and are taken
+ * in bulk by rt_device_read. rx_indicate is called once per interrupt, when
+ * the ring holds rx_watermark bytes or the line went idle (the character
+ * timeout of the FIFO), not once per byte. rt_device_write queues into a TX
+ * ring which the THR empty interrupt moves to the FIFO 16 bytes at a time; a
+ * writer finding the ring full sleeps until tx_watermark bytes are free.
+ * With interrupts disabled (in an interrupt, before the scheduler starts, or
+ * on a fault) the write is polled after what is queued, so nothing is lost.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "psp_api.h"
+#include "drv_uart.h"
+
+#ifdef BSP_USING_UART
+
+#ifdef BSP_UART_QEMU
+/* NS16550A of QEMU virt on the PLIC, the divisor is ignored */
+#define UART_BASE                       0x10000000
+#define UART_REG_SHIFT                  0
+#define UART_CLOCK                      3686400
+#ifndef BSP_UART_IRQ
+#define BSP_UART_IRQ                    10
+#endif
+
+#define PLIC_BASE_ADDR                  0x0c000000
+#include "riscv-ops.h"
+#include "riscv-plic.h"
+#else
+/* uart16550 of SweRVolf, 32 bits registers, on the PIC of SweRV EH1 */
+#define UART_BASE                       0x80002000
+#define UART_REG_SHIFT                  2
+#define UART_CLOCK                      50000000
+#ifndef BSP_UART_IRQ
+#define BSP_UART_IRQ                    1
+#endif
+
+#define PIC_BASE                        0xf00c0000
+#define PIC_MEIPL(irq)                  (*(volatile rt_uint32_t *)(PIC_BASE + 0x0000 + (irq) * 4))
+#define PIC_MEIE(irq)                   (*(volatile rt_uint32_t *)(PIC_BASE + 0x2000 + (irq) * 4))
+#define PIC_MEIGWCTRL(irq)              (*(volatile rt_uint32_t *)(PIC_BASE + 0x4000 + (irq) * 4))
+#define PIC_MEIGWCLR(irq)               (*(volatile rt_uint32_t *)(PIC_BASE + 0x5000 + (irq) * 4))
+#endif
+
+#if UART_REG_SHIFT == 0
+#define UART_REG(reg)                   (*(volatile rt_uint8_t *)(UART_BASE + (reg)))
+#else
+#define UART_REG(reg)                   (*(volatile rt_uint32_t *)(UART_BASE + ((reg) << UART_REG_SHIFT)))
+#endif
+
+#if (BSP_UART_RX_BUFSZ & (BSP_UART_RX_BUFSZ - 1)) || (BSP_UART_TX_BUFSZ & (BSP_UART_TX_BUFSZ - 1)) || \
+    BSP_UART_RX_BUFSZ > 0x8000 || BSP_UART_TX_BUFSZ > 0x8000
+#error "BSP_UART_RX_BUFSZ and BSP_UART_TX_BUFSZ must be powers of 2, 32KB at most"
+#endif
+
+/* registers */
+#define UART_RBR                        0   /* receive buffer, DLAB = 0 */
+#define UART_THR                        0   /* transmit holding, DLAB = 0 */
+#define UART_DLL                        0   /* divisor low, DLAB = 1 */
+#define UART_IER                        1   /* interrupt enable, DLAB = 0 */
+#define UART_DLM                        1   /* divisor high, DLAB = 1 */
+#define UART_IIR                        2   /* interrupt identification, read */
+#define UART_FCR                        2   /* FIFO control, write */
+#define UART_LCR                        3
+#define UART_MCR                        4
+#define UART_LSR                        5
+#define UART_MSR                        6
+
+#define UART_IER_RDI                    0x01
+#define UART_IER_THRI                   0x02
+#define UART_IER_RLSI                   0x04
+
+#define UART_IIR_NO_INT                 0x01
+#define UART_IIR_ID                     0x0e
+#define UART_IIR_THRI                   0x02
+#define UART_IIR_RDI                    0x04
+#define UART_IIR_RLSI                   0x06
+#define UART_IIR_CTI                    0x0c
+
+#define UART_FCR_ENABLE                 0x01
+#define UART_FCR_CLEAR_RX               0x02
+#define UART_FCR_CLEAR_TX               0x04
+
+#define UART_LCR_WLEN8                  0x03
+#define UART_LCR_DLAB                   0x80
+
+#define UART_MCR_DTR                    0x01
+#define UART_MCR_RTS                    0x02
+#define UART_MCR_OUT2                   0x08
+
+#define UART_LSR_DR                     0x01
+#define UART_LSR_THRE                   0x20
+
+#define UART_FIFO_SIZE                  16
+
+/* mstatus.MIE in the level of rt_hw_interrupt_disable */
+#define MSTATUS_MIE                     0x08
+
+struct uart_device
+{
+    struct rt_device parent;
+
+    struct uart_config config;
+    rt_uint8_t ier;
+
+    /* free running indexes, the ISR moves rx_put and tx_get */
+    volatile rt_uint16_t rx_put, rx_get;
+    volatile rt_uint16_t tx_put, tx_get;
+    rt_uint8_t rx_buf[BSP_UART_RX_BUFSZ];
+    rt_uint8_t tx_buf[BSP_UART_TX_BUFSZ];
+
+    rt_uint8_t tx_waiting;      /* writers sleeping on tx_sem */
+    struct rt_semaphore tx_sem;
+
+    rt_uint32_t rx_dropped;     /* bytes lost on a full RX ring */
+};
+
+static struct uart_device _uart;
+
+/* FCR bits of the RX trigger level, 0 for an invalid one */
+static rt_uint8_t uart_fcr_trigger(rt_uint8_t rx_trigger)
+{
+    switch (rx_trigger)
+    {
+    case 1:  return 0x00 | UART_FCR_ENABLE;
+    case 4:  return 0x40 | UART_FCR_ENABLE;
+    case 8:  return 0x80 | UART_FCR_ENABLE;
+    case 14: return 0xc0 | UART_FCR_ENABLE;
+    }
+
+    return 0;
+}
+
+static void uart_set_config(struct uart_device *uart, const struct uart_config *config)
+{
+    rt_uint32_t divisor;
+
+    divisor = (UART_CLOCK + 8 * config->baud_rate) / (16 * config->baud_rate);
+
+    UART_REG(UART_IER) = 0;
+    UART_REG(UART_LCR) = UART_LCR_DLAB;
+    UART_REG(UART_DLL) = divisor & 0xff;
+    UART_REG(UART_DLM) = (divisor >> 8) & 0xff;
+    UART_REG(UART_LCR) = UART_LCR_WLEN8;
+    UART_REG(UART_FCR) = uart_fcr_trigger(config->rx_trigger);
+    UART_REG(UART_MCR) = UART_MCR_DTR | UART_MCR_RTS | UART_MCR_OUT2;
+    UART_REG(UART_IER) = uart->ier;
+
+    uart->config = *config;
+}
+
+rt_inline void uart_putc(rt_uint8_t ch)
+{
+    while (!(UART_REG(UART_LSR) & UART_LSR_THRE));
+    UART_REG(UART_THR) = ch;
+}
+
+/* write by polling, after what is queued; interrupts are disabled */
+static void uart_tx_poll(struct uart_device *uart, const rt_uint8_t *data, rt_size_t size)
+{
+    while (uart->tx_get != uart->tx_put)
+    {
+        uart_putc(uart->tx_buf[uart->tx_get & (BSP_UART_TX_BUFSZ - 1)]);
+        uart->tx_get ++;
+    }
+
+    while (size--)
+        uart_putc(*data++);
+}
+
+static void uart_tx_put(struct uart_device *uart, const rt_uint8_t *data, rt_size_t size)
+{
+    rt_base_t level;
+    rt_size_t length, offset, part;
+
+    while (size > 0)
+    {
+        level = rt_hw_interrupt_disable();
+
+        /* no THR empty interrupt will come, nor can this thread sleep */
+        if (!(level & MSTATUS_MIE) || rt_thread_self() == RT_NULL)
+        {
+            uart_tx_poll(uart, data, size);
+            rt_hw_interrupt_enable(level);
+            return;
+        }
+
+        length = BSP_UART_TX_BUFSZ - (rt_uint16_t)(uart->tx_put - uart->tx_get);
+        if (length > size)
+            length = size;
+
+        offset = uart->tx_put & (BSP_UART_TX_BUFSZ - 1);
+        part = BSP_UART_TX_BUFSZ - offset;
+        if (part > length)
+            part = length;
+        rt_memcpy(&uart->tx_buf[offset], data, part);
+        rt_memcpy(&uart->tx_buf[0], data + part, length - part);
+        uart->tx_put += length;
+        data += length;
+        size -= length;
+
+        /* THR is empty, the interrupt comes right away */
+        if (length > 0 && !(uart->ier & UART_IER_THRI))
+        {
+            uart->ier |= UART_IER_THRI;
+            UART_REG(UART_IER) = uart->ier;
+        }
+
+        if (size > 0)
+        {
+            /* full, but the idle thread or a locked scheduler can't sleep */
+            if (rt_thread_self() == rt_thread_idle_gethandler() || rt_critical_level() > 0)
+            {
+                uart_tx_poll(uart, data, size);
+                rt_hw_interrupt_enable(level);
+                return;
+            }
+            uart->tx_waiting ++;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (size > 0)
+            rt_sem_take(&uart->tx_sem, RT_WAITING_FOREVER);
+    }
+}
+
+static rt_err_t uart_init(rt_device_t dev)
+{
+    struct uart_device *uart = (struct uart_device *)dev;
+    const struct uart_config config = UART_CONFIG_DEFAULT;
+
+    uart->rx_put = uart->rx_get = 0;
+    uart->tx_put = uart->tx_get = 0;
+
+    /* receive from now on, transmit when there is something queued */
+    uart->ier = UART_IER_RDI | UART_IER_RLSI;
+    UART_REG(UART_FCR) = UART_FCR_ENABLE | UART_FCR_CLEAR_RX | UART_FCR_CLEAR_TX;
+    uart_set_config(uart, &config);
+
+    return RT_EOK;
+}
+
+static rt_err_t uart_open(rt_device_t dev, rt_uint16_t oflag)
+{
+    /* the console opens it for stream, finsh for stream and INT_RX */
+    dev->open_flag |= oflag & 0xff;
+
+    return RT_EOK;
+}
+
+static rt_size_t uart_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct uart_device *uart = (struct uart_device *)dev;
+    rt_uint8_t *data = (rt_uint8_t *)buffer;
+    rt_size_t length, offset, part;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+
+    length = (rt_uint16_t)(uart->rx_put - uart->rx_get);
+    if (length > size)
+        length = size;
+
+    offset = uart->rx_get & (BSP_UART_RX_BUFSZ - 1);
+    part = BSP_UART_RX_BUFSZ - offset;
+    if (part > length)
+        part = length;
+    rt_memcpy(data, &uart->rx_buf[offset], part);
+    rt_memcpy(data + part, &uart->rx_buf[0], length - part);
+    uart->rx_get += length;
+
+    rt_hw_interrupt_enable(level);
+
+    return length;
+}
+
+static rt_size_t uart_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct uart_device *uart = (struct uart_device *)dev;
+    const rt_uint8_t *data = (const rt_uint8_t *)buffer;
+    const rt_uint8_t *end = data + size;
+    const rt_uint8_t *line;
+
+    if (!(dev->open_flag & RT_DEVICE_FLAG_STREAM))
+    {
+        uart_tx_put(uart, data, size);
+        return size;
+    }
+
+    /* stream mode: "\n" goes out as "\r\n" */
+    while (data < end)
+    {
+        for (line = data; data < end && *data != '\n'; data ++);
+        uart_tx_put(uart, line, data - line);
+        if (data < end)
+        {
+            uart_tx_put(uart, (const rt_uint8_t *)"\r\n", 2);
+            data ++;
+        }
+    }
+
+    return size;
+}
+
+static rt_err_t uart_control(rt_device_t dev, int cmd, void *args)
+{
+    struct uart_device *uart = (struct uart_device *)dev;
+    struct uart_config *config = (struct uart_config *)args;
+    rt_base_t level;
+
+    switch (cmd)
+    {
+    case UART_CTRL_CONFIG:
+        if (config == RT_NULL || config->baud_rate == 0 ||
+            uart_fcr_trigger(config->rx_trigger) == 0 ||
+            config->rx_watermark == 0 || config->rx_watermark > BSP_UART_RX_BUFSZ ||
+            config->tx_watermark == 0 || config->tx_watermark > BSP_UART_TX_BUFSZ)
+            return -RT_EINVAL;
+
+        level = rt_hw_interrupt_disable();
+        uart_set_config(uart, config);
+        rt_hw_interrupt_enable(level);
+        break;
+
+    default:
+        return -RT_ENOSYS;
+    }
+
+    return RT_EOK;
+}
+
+/* move the RX FIFO to the ring, return the bytes received */
+static rt_size_t uart_isr_rx(struct uart_device *uart)
+{
+    rt_size_t count = 0;
+    rt_uint8_t ch;
+
+    /* reading LSR also clears the line status interrupt */
+    while (UART_REG(UART_LSR) & UART_LSR_DR)
+    {
+        ch = UART_REG(UART_RBR);
+        if ((rt_uint16_t)(uart->rx_put - uart->rx_get) < BSP_UART_RX_BUFSZ)
+        {
+            uart->rx_buf[uart->rx_put & (BSP_UART_RX_BUFSZ - 1)] = ch;
+            uart->rx_put ++;
+            count ++;
+        }
+        else
+            uart->rx_dropped ++;
+    }
+
+    return count;
+}
+
+/* fill the empty TX FIFO from the ring, return RT_TRUE when the ring drained */
+static rt_bool_t uart_isr_tx(struct uart_device *uart)
+{
+    int count;
+
+    for (count = 0; count < UART_FIFO_SIZE && uart->tx_get != uart->tx_put; count ++)
+    {
+        UART_REG(UART_THR) = uart->tx_buf[uart->tx_get & (BSP_UART_TX_BUFSZ - 1)];
+        uart->tx_get ++;
+    }
+
+    if (uart->tx_get == uart->tx_put)
+    {
+        uart->ier &= ~UART_IER_THRI;
+        UART_REG(UART_IER) = uart->ier;
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+static void uart_irq_complete(int irq)
+{
+#ifdef BSP_UART_QEMU
+    __plic_irq_complete(irq);
+#else
+    /* level triggered, the source drops the request when served */
+#endif
+}
+
+static void uart_isr(struct uart_device *uart, int irq)
+{
+    rt_size_t received = 0;
+    rt_bool_t idle = RT_FALSE, drained = RT_FALSE;
+    rt_uint8_t wakeup = 0;
+    rt_uint32_t iir;
+
+    while (!((iir = UART_REG(UART_IIR)) & UART_IIR_NO_INT))
+    {
+        switch (iir & UART_IIR_ID)
+        {
+        case UART_IIR_CTI:
+            idle = RT_TRUE;
+            /* fall through */
+        case UART_IIR_RDI:
+        case UART_IIR_RLSI:
+            received += uart_isr_rx(uart);
+            break;
+
+        case UART_IIR_THRI:
+            drained = uart_isr_tx(uart);
+            break;
+
+        default:
+            (void)UART_REG(UART_MSR);
+            break;
+        }
+    }
+
+    if (uart->tx_waiting &&
+        BSP_UART_TX_BUFSZ - (rt_uint16_t)(uart->tx_put - uart->tx_get) >= uart->config.tx_watermark)
+    {
+        wakeup = uart->tx_waiting;
+        uart->tx_waiting = 0;
+    }
+
+    uart_irq_complete(irq);
+
+    /* the callbacks go last, they may switch thread right here as the tick does */
+    if (received > 0 && uart->parent.rx_indicate != RT_NULL &&
+        ((rt_uint16_t)(uart->rx_put - uart->rx_get) >= uart->config.rx_watermark ||
+         idle || uart->config.rx_trigger == 1))
+    {
+        uart->parent.rx_indicate(&uart->parent, (rt_uint16_t)(uart->rx_put - uart->rx_get));
+    }
+    while (wakeup--)
+        rt_sem_release(&uart->tx_sem);
+    if (drained && uart->parent.tx_complete != RT_NULL)
+        uart->parent.tx_complete(&uart->parent, RT_NULL);
+}
+
+/* machine external interrupt */
+static void uart_irq_handler(void)
+{
+    int irq;
+
+#ifdef BSP_UART_QEMU
+    irq = __plic_irq_claim();
+#else
+    rt_ubase_t meihap;
+
+    /* meicpct captures the claimed source into meihap */
+    asm volatile ("csrw 0xbca, zero");
+    asm volatile ("csrr %0, 0xfc8" : "=r"(meihap));
+    irq = (meihap >> 2) & 0xff;
+#endif
+
+    if (irq == BSP_UART_IRQ)
+        uart_isr(&_uart, irq);
+    else if (irq != 0)
+        uart_irq_complete(irq);
+}
+
+static void uart_irq_install(void)
+{
+#ifdef BSP_UART_QEMU
+    __plic_set_priority(BSP_UART_IRQ, 1);
+    __plic_set_threshold(0);
+    __plic_irq_enable(BSP_UART_IRQ);
+#else
+    /* level triggered, active high, priority 1 over the threshold 0 */
+    PIC_MEIGWCTRL(BSP_UART_IRQ) = 0;
+    PIC_MEIGWCLR(BSP_UART_IRQ) = 0;
+    PIC_MEIPL(BSP_UART_IRQ) = 1;
+    asm volatile ("csrw 0xbc9, zero");
+    PIC_MEIE(BSP_UART_IRQ) = 1;
+#endif
+
+    pspRegisterInterruptHandler(uart_irq_handler, E_MACHINE_EXTERNAL_CAUSE);
+    pspEnableInterruptNumberMachineLevel(D_PSP_INTERRUPTS_MACHINE_EXT);
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops uart_ops =
+{
+    uart_init,
+    uart_open,
+    RT_NULL,
+    uart_read,
+    uart_write,
+    uart_control
+};
+#endif
+
+/**
+ * This function will register the UART device "uart0" and hook its interrupt.
+ * It's invoked by rt_hw_board_init before the console is set to the device.
+ *
+ * @return the error code, RT_EOK on successfully.
+ */
+int rt_hw_uart_init(void)
+{
+    struct rt_device *device = &_uart.parent;
+
+    device->type        = RT_Device_Class_Char;
+    device->rx_indicate = RT_NULL;
+    device->tx_complete = RT_NULL;
+
+#ifdef RT_USING_DEVICE_OPS
+    device->ops         = &uart_ops;
+#else
+    device->init        = uart_init;
+    device->open        = uart_open;
+    device->close       = RT_NULL;
+    device->read        = uart_read;
+    device->write       = uart_write;
+    device->control     = uart_control;
+#endif
+    device->user_data   = RT_NULL;
+
+    rt_sem_init(&_uart.tx_sem, "uart_tx", 0, RT_IPC_FLAG_FIFO);
+    uart_irq_install();
+
+    return rt_device_register(device, "uart0",
+                              RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX | RT_DEVICE_FLAG_INT_TX);
+}
+
+#endif /* BSP_USING_UART */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __DRV_UART_H__
+#define __DRV_UART_H__
+
+#include <rtthread.h>
+
+/* bytes of the receive and transmit rings, powers of 2 */
+#ifndef BSP_UART_RX_BUFSZ
+#define BSP_UART_RX_BUFSZ               256
+#endif
+#ifndef BSP_UART_TX_BUFSZ
+#define BSP_UART_TX_BUFSZ               512
+#endif
+
+/* control command of the uart device, args is a struct uart_config */
+#define UART_CTRL_CONFIG                RT_DEVICE_CTRL_CONFIG
+
+struct uart_config
+{
+    rt_uint32_t baud_rate;
+    rt_uint8_t  rx_trigger;     /* bytes in RX FIFO for an interrupt: 1, 4, 8 or 14 */
+    rt_uint16_t rx_watermark;   /* rx_indicate when RX ring holds as many, or the line is idle;
+                                 * bytes exactly filling the FIFO trigger get no idle interrupt,
+                                 * so above 1 it suits continuous streams */
+    rt_uint16_t tx_watermark;   /* a blocked writer resumes when TX ring has as many free */
+};
+
+#define UART_CONFIG_DEFAULT             \
+{                                       \
+    115200,     /* 115200 8N1 */        \
+    8,                                  \
+    1,                                  \
+    BSP_UART_TX_BUFSZ / 4,              \
+}
+
+int rt_hw_uart_init(void);
+
+#endif
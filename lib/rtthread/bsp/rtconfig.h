@@ -47,6 +47,22 @@
 //  <i>Default: 512
 #define RT_MAIN_THREAD_STACK_SIZE 512
 
+// <c1>Using object cache
+//  <i>Threads, timers and IPC objects come from static caches first, released stacks and IPC buffers are kept for reuse, see RT_OBJECT_CACHE_xxx in object.c
+// #define RT_USING_OBJECT_CACHE
+// </c>
+// <c1>Using object name hash
+//  <i>rt_object_find/rt_device_find/rt_thread_find check one bucket, see RT_OBJECT_HASH_SIZE in object.c
+#define RT_USING_OBJECT_HASH
+// </c>
+// <c1>Using thread pool
+//  <i>Pre-created workers run short jobs, rt_thread_pool_submit/rt_thread_pool_wait
+// #define RT_USING_THREAD_POOL
+// </c>
+// <c1>Using protothread
+//  <i>Stackless coroutines sharing the pt thread and its stack, see rtpt.h
+// #define RT_USING_PT
+// </c>
 // </h>
 
 // <h>Debug Configuration
@@ -61,6 +77,15 @@
 //  <i> Diable Thread stack over flow detect
 // #define RT_USING_OVERFLOW_CHECK
 // </c>
+// <c1>PMP stack guard
+//  <i>Trap on stack overflow with a locked PMP region at the stack bottom, need PMP and Smepmp (e.g. QEMU virt)
+// #define RT_USING_STACK_GUARD
+// #define RT_STACK_GUARD_TRAP_CHAIN psp_vect_table
+// </c>
+// <c1>stack watermark scan in idle thread
+//  <i>Record the peak stack usage of each thread, see stack command
+// #define RT_USING_STACK_WATERMARK
+// </c>
 // </h>
 
 // <h>Hook Configuration
@@ -109,6 +134,14 @@
 //  <i>Using Message Queue
 #define RT_USING_MESSAGEQUEUE
 // </c>
+// <c1>Using IPC statistics
+//  <i>Record takes, blocked time histogram and mutex hold time of each IPC object, see ipc_stat
+// #define RT_USING_IPC_STATS
+// </c>
+// <c1>Using Topic
+//  <i>Using publish/subscribe topic
+#define RT_USING_TOPIC
+// </c>
 // </h>
 
 // <h>Memory Management Configuration
@@ -124,6 +157,42 @@
 //  <i>using tiny size of memory
 // #define RT_USING_TINY_SIZE
 // </c>
+// <c1>Using heap from linker symbols
+//  <i>Use all memory between the end of .bss and the boot stack (_end/_sp) as heap instead of the 40KB rt_heap array
+// #define RT_USING_HEAP_LINKER
+// </c>
+// <c1>Using fast heap region
+//  <i>Fast region (DCCM) for rt_malloc_hint(size, RT_MEM_FAST), kernel objects and thread stacks go there by default, need RT_USING_MEMHEAP_AS_HEAP
+// #define RT_USING_HEAP_FAST
+// </c>
+// <c1>Using heap profiler
+//  <i>Record allocation site, thread and time of each heap block, see memprof
+// #define RT_USING_MEMPROF
+// </c>
+// <c1>Using slab magazine
+//  <i>Per-thread magazines in front of slab zones, 8~64 bytes alloc/free without lock
+// #define RT_USING_SLAB_MAGAZINE
+// </c>
+// <c1>Using TLSF allocator
+//  <i>TLSF memory pool with O(1) alloc/free
+// #define RT_USING_TLSF
+// </c>
+// <c1>Using TLSF as system heap
+//  <i>Need RT_USING_TLSF, and RT_USING_SMALL_MEM and RT_USING_SLAB disabled
+// #define RT_USING_TLSF_MEM
+// </c>
+// <c1>Using interrupt memory
+//  <i>Small blocks allocated in interrupt, rt_isr_malloc/rt_isr_free
+// #define RT_USING_ISR_MEM
+// </c>
+// <c1>Using scratch arena
+//  <i>Bump pointer allocation released at once by rt_arena_mark/rt_arena_reset, can be attached to a thread
+#define RT_USING_ARENA
+// </c>
+// <c1>Using size class allocator
+//  <i>rt_mp_class_malloc/rt_mp_class_free over memory pools, O(1) for 16~256 bytes, pages move between classes on demand
+// #define RT_USING_MP_CLASS
+// </c>
 // </h>
 
 // <h>Console Configuration
@@ -137,6 +206,26 @@
 //  <i>the buffer size of console
 //  <i>Default: 128  (128Byte)
 #define RT_CONSOLEBUF_SIZE 128
+// <c1>Using asynchronous console
+//  <i>rt_kprintf only writes a ring buffer printed by a low priority console thread, lines are dropped and counted when it is full
+// #define RT_USING_CONSOLE_ASYNC
+// </c>
+// <c1>Using binary log
+//  <i>RT_BINLOG only outputs the format string index and arguments, tools/binlog.py restores the text with the ELF
+// #define RT_USING_BINLOG
+// </c>
+// <c1>Using float in rt_kprintf
+//  <i>%f (at most 9 decimals) and %q (Q16.16 fixed point) converted from IEEE 754 bits without float library
+#define RT_PRINTF_FLOAT
+// </c>
+// <c1>Using interrupt driven UART
+//  <i>UART device "uart0" as console, with receive and transmit ring buffers
+#define BSP_USING_UART
+// </c>
+// <c1>Using QEMU virt UART
+//  <i>16550 of QEMU virt (0x10000000, PLIC IRQ 10) instead of the Nexys board UART
+// #define BSP_UART_QEMU
+// </c>
 // </h>
 
 #if defined(RT_USING_FINSH)
@@ -156,6 +245,10 @@
 //  <i>the history lines of finsh thread
 //  <i>Default: 5
 #define FINSH_HISTORY_LINES 1
+// <c1>Using command index
+//  <i>Commands sorted by name at first use, binary search for dispatch and prefix range for completion
+#define FINSH_USING_CMD_INDEX
+// </c>
 
 //#define FINSH_USING_SYMTAB
 // </h>
@@ -228,6 +228,10 @@ long list_thread(void)
                             thread->error);
 #else
                     ptr = (rt_uint8_t *)thread->stack_addr;
+#ifdef RT_USING_STACK_GUARD
+                    /* the guard of the running thread can't be read */
+                    ptr += rt_hw_stack_guard_skip(thread);
+#endif
                     while (*ptr == '#')ptr ++;
 
                     rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %03d\n",
@@ -249,6 +253,133 @@ long list_thread(void)
 FINSH_FUNCTION_EXPORT(list_thread, list thread);
 MSH_CMD_EXPORT(list_thread, list thread);
 
+#ifdef RT_USING_STACK_WATERMARK
+/* margin on top of the peak usage for the recommended stack size, in percent */
+#ifndef RT_STACK_WATERMARK_MARGIN
+#define RT_STACK_WATERMARK_MARGIN       25
+#endif
+
+/* least margin and rounding of the recommended stack size, in bytes */
+#ifndef RT_STACK_WATERMARK_ROUND
+#define RT_STACK_WATERMARK_ROUND        64
+#endif
+
+static rt_uint32_t stack_recommend(rt_uint32_t used)
+{
+    rt_uint32_t margin;
+
+    margin = used * RT_STACK_WATERMARK_MARGIN / 100;
+    if (margin < RT_STACK_WATERMARK_ROUND)
+        margin = RT_STACK_WATERMARK_ROUND;
+
+    return RT_ALIGN(used + margin, RT_STACK_WATERMARK_ROUND);
+}
+
+int cmd_stack(int argc, char **argv)
+{
+    rt_ubase_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t*)RT_NULL;
+    const char *item_title = "thread";
+    rt_uint32_t total = 0, total_recommend = 0;
+    int maxlen, code = 0;
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "-c") != 0)
+        {
+            rt_kprintf("Usage: stack [-c]\n");
+            rt_kprintf("  -c  print recommended sizes as C macros\n");
+            return -1;
+        }
+        code = 1;
+    }
+
+    list_find_init(&find_arg, RT_Object_Class_Thread, obj_list, sizeof(obj_list)/sizeof(obj_list[0]));
+
+    maxlen = RT_NAME_MAX;
+
+    if (!code)
+    {
+        rt_kprintf("%-*.s stack size peak used  usage recommend\n", maxlen, item_title); object_split(maxlen);
+        rt_kprintf(     " ---------- ---------- ----- ---------\n");
+    }
+
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+                char name[RT_NAME_MAX + 1];
+                rt_uint32_t size, used, recommend;
+                int n;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+                rt_strncpy(name, obj->name, RT_NAME_MAX);
+                name[RT_NAME_MAX] = '\0';
+                size = ((struct rt_thread *)obj)->stack_size;
+                used = size - ((struct rt_thread *)obj)->stack_free;
+                rt_hw_interrupt_enable(level);
+
+                /* not scanned yet, the initial frame is always touched */
+                if (used == 0)
+                    recommend = size;
+                else
+                    recommend = stack_recommend(used);
+                total += size;
+                total_recommend += recommend;
+
+                if (code)
+                {
+                    /* upper case identifier for a #define */
+                    for (n = 0; name[n] != '\0'; n ++)
+                    {
+                        if (name[n] >= 'a' && name[n] <= 'z')
+                            name[n] = name[n] - 'a' + 'A';
+                        else if (!((name[n] >= 'A' && name[n] <= 'Z') ||
+                                   (name[n] >= '0' && name[n] <= '9')))
+                            name[n] = '_';
+                    }
+                    rt_kprintf("#define %s_STACK_SIZE %d    /* peak %d of %d */\n",
+                               name, recommend, used, size);
+                }
+                else
+                {
+                    rt_kprintf("%-*.*s 0x%08x 0x%08x  %3d%% %9d%s\n",
+                               maxlen, RT_NAME_MAX, name, size, used,
+                               used * 100 / size, recommend,
+                               recommend > size ? " !" : "");
+                }
+            }
+        }
+    }
+    while (next != (rt_list_t*)RT_NULL);
+
+    if (!code)
+    {
+        rt_kprintf("stack total %d, recommended %d", total, total_recommend);
+        if (total > total_recommend)
+            rt_kprintf(", %d bytes can be reclaimed", total - total_recommend);
+        rt_kprintf("\n(peak of the watermark scan in idle, %d%% margin; ! larger than now)\n",
+                   RT_STACK_WATERMARK_MARGIN);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT_ALIAS(cmd_stack, stack, show stack peak usage and recommended size: stack [-c]);
+#endif
+
 static void show_wait_queue(struct rt_list_node *list)
 {
     struct rt_thread *thread;
@@ -592,6 +723,187 @@ FINSH_FUNCTION_EXPORT(list_msgqueue, list message queue in system);
 MSH_CMD_EXPORT(list_msgqueue, list message queue in system);
 #endif
 
+#ifdef RT_USING_TOPIC
+long list_topic(void)
+{
+    rt_ubase_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t*)RT_NULL;
+
+    int maxlen;
+    const char *item_title = "topic";
+
+    list_find_init(&find_arg, RT_Object_Class_Topic, obj_list, sizeof(obj_list)/sizeof(obj_list[0]));
+
+    maxlen = RT_NAME_MAX;
+
+    rt_kprintf("%-*.s size generation last tick  subs   suspend thread\n", maxlen, item_title); object_split(maxlen);
+    rt_kprintf(     " ---- ---------- ---------- ------ --------------\n");
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+                struct rt_topic *t;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+
+                rt_hw_interrupt_enable(level);
+
+                t = (struct rt_topic *)obj;
+                rt_kprintf("%-*.*s %04d %010d 0x%08x %06d %d",
+                        maxlen, RT_NAME_MAX,
+                        t->parent.parent.name,
+                        t->size,
+                        t->generation,
+                        t->timestamp,
+                        rt_list_len(&t->sub_list),
+                        rt_list_len(&t->parent.suspend_thread));
+                if (!rt_list_isempty(&t->parent.suspend_thread))
+                {
+                    rt_kprintf(":");
+                    show_wait_queue(&(t->parent.suspend_thread));
+                }
+                rt_kprintf("\n");
+            }
+        }
+    }
+    while (next != (rt_list_t*)RT_NULL);
+
+    return 0;
+}
+FINSH_FUNCTION_EXPORT(list_topic, list topic in system);
+MSH_CMD_EXPORT(list_topic, list topic in system);
+#endif
+
+#ifdef RT_USING_IPC_STATS
+static void show_ipc_stats(struct rt_ipc_object *ipc, const char *type, int maxlen)
+{
+    struct rt_ipc_stats *stats = &(ipc->stats);
+    rt_uint32_t avg;
+    int i;
+
+    avg = stats->contended ? (rt_uint32_t)(stats->wait_total / stats->contended) : 0;
+
+    rt_kprintf("%-*.*s %-5s %010u %010u %07u %010u %010u %010u\n",
+               maxlen, RT_NAME_MAX, ipc->parent.name, type,
+               stats->take, stats->contended, stats->timeout,
+               avg, stats->wait_max, stats->hold_max);
+
+    if (stats->contended == 0)
+        return;
+
+    /* only the buckets hit, labelled by the lower bound in cycles */
+    rt_kprintf("%*s", maxlen + 1, "");
+    for (i = 0; i < RT_IPC_STATS_HIST_NR; i++)
+    {
+        if (stats->wait_hist[i] == 0)
+            continue;
+
+        if (i == 0)
+            rt_kprintf(" <2^%d:%u", RT_IPC_STATS_HIST_SHIFT + 1, stats->wait_hist[i]);
+        else
+            rt_kprintf(" 2^%d:%u", RT_IPC_STATS_HIST_SHIFT + i, stats->wait_hist[i]);
+    }
+    rt_kprintf("\n");
+}
+
+static void list_ipc_stats(rt_uint8_t type, const char *type_name, int reset)
+{
+    rt_ubase_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t*)RT_NULL;
+
+    list_find_init(&find_arg, type, obj_list, sizeof(obj_list)/sizeof(obj_list[0]));
+
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+
+                rt_hw_interrupt_enable(level);
+
+                if (reset)
+                    rt_ipc_stats_reset((struct rt_ipc_object *)obj);
+                else
+                    show_ipc_stats((struct rt_ipc_object *)obj, type_name, RT_NAME_MAX);
+            }
+        }
+    }
+    while (next != (rt_list_t*)RT_NULL);
+}
+
+int ipc_stat(int argc, char **argv)
+{
+    int maxlen;
+    int reset = 0;
+    const char *item_title = "object";
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "-r") != 0)
+        {
+            rt_kprintf("Usage: ipc_stat [-r]\n");
+            rt_kprintf("  -r  reset the statistics of all IPC objects\n");
+            return -1;
+        }
+        reset = 1;
+    }
+
+    maxlen = RT_NAME_MAX;
+
+    if (!reset)
+    {
+        rt_kprintf("%-*.s type  take       blocked    timeout avg wait   max wait   max hold\n", maxlen, item_title); object_split(maxlen);
+        rt_kprintf(     " ----- ---------- ---------- ------- ---------- ---------- ----------\n");
+    }
+
+#ifdef RT_USING_SEMAPHORE
+    list_ipc_stats(RT_Object_Class_Semaphore, "sem", reset);
+#endif
+#ifdef RT_USING_MUTEX
+    list_ipc_stats(RT_Object_Class_Mutex, "mutex", reset);
+#endif
+#ifdef RT_USING_MAILBOX
+    list_ipc_stats(RT_Object_Class_MailBox, "mb", reset);
+#endif
+#ifdef RT_USING_MESSAGEQUEUE
+    list_ipc_stats(RT_Object_Class_MessageQueue, "mq", reset);
+#endif
+
+    if (reset)
+        rt_kprintf("IPC statistics cleared.\n");
+    else
+        rt_kprintf("(wait and hold time in cycles)\n");
+
+    return 0;
+}
+MSH_CMD_EXPORT(ipc_stat, show or reset IPC contention statistics: ipc_stat [-r]);
+#endif
+
 #ifdef RT_USING_MEMHEAP
 long list_memheap(void)
 {
@@ -10,6 +10,7 @@
  * 2017-07-19     Aubr.Cool    limit argc to RT_FINSH_ARG_MAX
  */
 #include <rtthread.h>
+#include <rthw.h>
 
 #ifdef FINSH_USING_MSH
 
@@ -190,11 +191,124 @@ static int msh_split(char *cmd, rt_size_t length, char *argv[FINSH_ARG_MAX])
     return argc;
 }
 
+#ifdef FINSH_USING_CMD_INDEX
+/* "__cmd_" entries of the syscall table sorted by command name */
+static struct finsh_syscall **msh_cmd_index = RT_NULL;
+static int msh_cmd_count = 0;
+
+/*
+ * This function will return the command index, building it at the first
+ * call. It returns RT_NULL when there is no command or no memory, then the
+ * callers scan the syscall table instead.
+ */
+static struct finsh_syscall **msh_get_index(void)
+{
+    struct finsh_syscall *index;
+    struct finsh_syscall **table;
+    register rt_base_t temp;
+    int count, i;
+
+    if (msh_cmd_index != RT_NULL)
+        return msh_cmd_index;
+
+    count = 0;
+    for (index = _syscall_table_begin;
+            index < _syscall_table_end;
+            FINSH_NEXT_SYSCALL(index))
+    {
+        if (strncmp(index->name, "__cmd_", 6) == 0)
+            count ++;
+    }
+    if (count == 0)
+        return RT_NULL;
+
+    table = (struct finsh_syscall **)rt_malloc(count * sizeof(struct finsh_syscall *));
+    if (table == RT_NULL)
+        return RT_NULL;
+
+    /* insertion sort, the same names stay in table order as the scan found them */
+    count = 0;
+    for (index = _syscall_table_begin;
+            index < _syscall_table_end;
+            FINSH_NEXT_SYSCALL(index))
+    {
+        if (strncmp(index->name, "__cmd_", 6) != 0) continue;
+
+        for (i = count; i > 0 && strcmp(&table[i - 1]->name[6], &index->name[6]) > 0; i --)
+            table[i] = table[i - 1];
+        table[i] = index;
+        count ++;
+    }
+
+    /* another thread may have built the index meanwhile */
+    temp = rt_hw_interrupt_disable();
+    if (msh_cmd_index == RT_NULL)
+    {
+        msh_cmd_count = count;
+        msh_cmd_index = table;
+        table = RT_NULL;
+    }
+    rt_hw_interrupt_enable(temp);
+
+    if (table != RT_NULL)
+        rt_free(table);
+
+    return msh_cmd_index;
+}
+
+/* compare a command name with the first size chars of cmd, as strcmp */
+static int msh_cmd_compare(const char *name, const char *cmd, int size)
+{
+    int result;
+
+    result = strncmp(name, cmd, size);
+    if (result == 0 && name[size] != '\0')
+        result = 1;
+
+    return result;
+}
+
+/* the first position in the index whose name is not less than cmd[0..size) */
+static int msh_cmd_lower_bound(struct finsh_syscall **table, const char *cmd, int size)
+{
+    int low, high, mid;
+
+    low = 0;
+    high = msh_cmd_count;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (msh_cmd_compare(&table[mid]->name[6], cmd, size) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+#endif
+
 static cmd_function_t msh_get_cmd(char *cmd, int size)
 {
     struct finsh_syscall *index;
     cmd_function_t cmd_func = RT_NULL;
 
+#ifdef FINSH_USING_CMD_INDEX
+    struct finsh_syscall **table;
+    int position;
+
+    table = msh_get_index();
+    if (table != RT_NULL)
+    {
+        position = msh_cmd_lower_bound(table, cmd, size);
+        if (position < msh_cmd_count &&
+                msh_cmd_compare(&table[position]->name[6], cmd, size) == 0)
+            cmd_func = (cmd_function_t)table[position]->func;
+
+        return cmd_func;
+    }
+#endif
+
     for (index = _syscall_table_begin;
             index < _syscall_table_end;
             FINSH_NEXT_SYSCALL(index))
@@ -441,6 +555,26 @@ static int str_common(const char *str1, const char *str2)
     return (str - str1);
 }
 
+/* print a completion candidate and shorten the common part of all candidates */
+static void msh_complete_cmd(const char *cmd_name, const char **name_ptr, int *min_length)
+{
+    int length;
+
+    if (*min_length == 0)
+    {
+        /* set name_ptr */
+        *name_ptr = cmd_name;
+        /* set initial length */
+        *min_length = strlen(cmd_name);
+    }
+
+    length = str_common(*name_ptr, cmd_name);
+    if (length < *min_length)
+        *min_length = length;
+
+    rt_kprintf("%s\n", cmd_name);
+}
+
 #ifdef RT_USING_DFS
 void msh_auto_complete_path(char *path)
 {
@@ -566,9 +700,13 @@ void msh_auto_complete_path(char *path)
 
 void msh_auto_complete(char *prefix)
 {
-    int length, min_length;
+    int min_length;
     const char *name_ptr, *cmd_name;
     struct finsh_syscall *index;
+#ifdef FINSH_USING_CMD_INDEX
+    struct finsh_syscall **table;
+    int position, length;
+#endif
 
     min_length = 0;
     name_ptr = RT_NULL;
@@ -608,6 +746,24 @@ void msh_auto_complete(char *prefix)
 #endif
 
     /* checks in internal command */
+#ifdef FINSH_USING_CMD_INDEX
+    table = msh_get_index();
+    if (table != RT_NULL)
+    {
+        /* the commands with this prefix are adjacent in the index */
+        length = strlen(prefix);
+        for (position = msh_cmd_lower_bound(table, prefix, length);
+                position < msh_cmd_count;
+                position ++)
+        {
+            cmd_name = (const char *) &table[position]->name[6];
+            if (strncmp(prefix, cmd_name, length) != 0) break;
+
+            msh_complete_cmd(cmd_name, &name_ptr, &min_length);
+        }
+    }
+    else
+#endif
     {
         for (index = _syscall_table_begin; index < _syscall_table_end; FINSH_NEXT_SYSCALL(index))
         {
@@ -616,21 +772,7 @@ void msh_auto_complete(char *prefix)
 
             cmd_name = (const char *) &index->name[6];
             if (strncmp(prefix, cmd_name, strlen(prefix)) == 0)
-            {
-                if (min_length == 0)
-                {
-                    /* set name_ptr */
-                    name_ptr = cmd_name;
-                    /* set initial length */
-                    min_length = strlen(name_ptr);
-                }
-
-                length = str_common(name_ptr, cmd_name);
-                if (length < min_length)
-                    min_length = length;
-
-                rt_kprintf("%s\n", cmd_name);
-            }
+                msh_complete_cmd(cmd_name, &name_ptr, &min_length);
         }
     }
 
@@ -170,13 +170,18 @@ static int finsh_getchar(void)
 #ifdef RT_USING_POSIX
     return getchar();
 #else
-    char ch = 0;
-
     RT_ASSERT(shell != RT_NULL);
-    while (rt_device_read(shell->device, -1, &ch, 1) != 1)
-        rt_sem_take(&shell->rx_sem, RT_WAITING_FOREVER);
 
-    return (int)ch;
+    /* read what the device has, then hand it out a char at a time */
+    while (shell->rx_pos == shell->rx_len)
+    {
+        shell->rx_pos = 0;
+        shell->rx_len = rt_device_read(shell->device, -1, shell->rx_buf, sizeof(shell->rx_buf));
+        if (shell->rx_len == 0)
+            rt_sem_take(&shell->rx_sem, RT_WAITING_FOREVER);
+    }
+
+    return (int)shell->rx_buf[shell->rx_pos++];
 #endif
 #else
     extern char rt_hw_console_getchar(void);
@@ -230,6 +235,7 @@ void finsh_set_device(const char *device_name)
         /* clear line buffer before switch to new device */
         memset(shell->line, 0, sizeof(shell->line));
         shell->line_curpos = shell->line_position = 0;
+        shell->rx_pos = shell->rx_len = 0;
 
         shell->device = dev;
         rt_device_set_rx_indicate(dev, finsh_rx_ind);
@@ -23,6 +23,10 @@
 #ifndef FINSH_CMD_SIZE
 #define FINSH_CMD_SIZE      80
 #endif
+/* bytes taken from the device by one read */
+#ifndef FINSH_RX_BUFSZ
+#define FINSH_RX_BUFSZ      16
+#endif
 
 #define FINSH_OPTION_ECHO   0x01
 
@@ -84,6 +88,9 @@ struct finsh_shell
 
 #if !defined(RT_USING_POSIX) && defined(RT_USING_DEVICE)
     rt_device_t device;
+
+    char rx_buf[FINSH_RX_BUFSZ];
+    rt_uint8_t rx_pos, rx_len;
 #endif
 
 #ifdef FINSH_USING_AUTH
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Deferred binary logging
+ *
+ * RT_BINLOG takes the arguments of rt_kprintf, but the format string is not
+ * parsed on target: it is put in the section "rt_binlog" of the firmware, and
+ * only its offset in that section and the raw argument values go out on the
+ * console, to be formatted on the host by tools/binlog.py with the ELF file.
+ *
+ *     RT_BINLOG("adc %d: %d mV\n", channel, mv);
+ *
+ * A frame on the console is the byte 0xFF, then the offset of format (2 bytes,
+ * little endian), the length of payload (1 byte) and the payload: each
+ * argument as an unsigned LEB128 number of its 32 bits value, a string (char
+ * pointer argument, for "%s") as its length and bytes. Bytes 0x00, '\n', '\r',
+ * '%', 0xFE and 0xFF after the 0xFF are escaped as 0xFE and the byte xor 0x20,
+ * so a frame is a C string, passes rt_kputs and never starts a frame by
+ * accident; text output keeps going on the same console as UTF-8 never has
+ * 0xFE or 0xFF.
+ *
+ * At most RT_BINLOG_ARGS_MAX arguments are taken. Pass %p a void pointer, as a
+ * char pointer is sent as a string; a float or double is sent as the 32 bits
+ * of a float, for %f. Without RT_USING_BINLOG, RT_BINLOG is rt_kprintf.
+ */
+
+#ifndef __RT_BINLOG_H__
+#define __RT_BINLOG_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_BINLOG_ARGS_MAX              8
+
+#define RT_BINLOG_TYPE_WORD             0
+#define RT_BINLOG_TYPE_STRING           1
+#define RT_BINLOG_TYPE_FLOAT            2
+
+#ifdef RT_USING_BINLOG
+
+/* count the arguments, 0 to RT_BINLOG_ARGS_MAX */
+#define _RT_BINLOG_NARGS(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define RT_BINLOG_NARGS(...) \
+    _RT_BINLOG_NARGS(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/* apply m to each argument */
+#define _RT_BINLOG_MAP0(m, ...)
+#define _RT_BINLOG_MAP1(m, a)      m(a)
+#define _RT_BINLOG_MAP2(m, a, ...) m(a), _RT_BINLOG_MAP1(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP3(m, a, ...) m(a), _RT_BINLOG_MAP2(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP4(m, a, ...) m(a), _RT_BINLOG_MAP3(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP5(m, a, ...) m(a), _RT_BINLOG_MAP4(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP6(m, a, ...) m(a), _RT_BINLOG_MAP5(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP7(m, a, ...) m(a), _RT_BINLOG_MAP6(m, __VA_ARGS__)
+#define _RT_BINLOG_MAP8(m, a, ...) m(a), _RT_BINLOG_MAP7(m, __VA_ARGS__)
+#define _RT_BINLOG_CAT(a, b)       a##b
+#define _RT_BINLOG_MAPN(n)         _RT_BINLOG_CAT(_RT_BINLOG_MAP, n)
+#define _RT_BINLOG_MAP(m, ...) \
+    _RT_BINLOG_MAPN(RT_BINLOG_NARGS(__VA_ARGS__))(m, ##__VA_ARGS__)
+
+/* the type is known at compile time, the controlling expression isn't evaluated */
+#define _RT_BINLOG_TYPE(x)                                                  \
+    _Generic((x), char *: RT_BINLOG_TYPE_STRING,                            \
+                  const char *: RT_BINLOG_TYPE_STRING,                      \
+                  float: RT_BINLOG_TYPE_FLOAT,                              \
+                  double: RT_BINLOG_TYPE_FLOAT,                             \
+                  default: RT_BINLOG_TYPE_WORD)
+
+/* every branch must compile for any argument, so a float takes two _Generic */
+#define _RT_BINLOG_FLOAT(x)                                                 \
+    _Generic((x), float: (x), double: (x), default: 0.0f)
+#define _RT_BINLOG_WORD(x)                                                  \
+    _Generic((x), float: _rt_binlog_float(_RT_BINLOG_FLOAT(x)),             \
+                  double: _rt_binlog_float(_RT_BINLOG_FLOAT(x)),            \
+                  default: (rt_ubase_t)(x))
+
+rt_inline rt_ubase_t _rt_binlog_float(float value)
+{
+    union
+    {
+        float value;
+        rt_uint32_t bits;
+    } v;
+
+    v.value = value;
+
+    return v.bits;
+}
+
+#define RT_BINLOG(fmt, ...)                                                 \
+    do                                                                      \
+    {                                                                       \
+        static const char _binlog_fmt[] SECTION("rt_binlog") RT_USED = fmt; \
+        static const rt_uint8_t _binlog_type[] =                            \
+            { 0, _RT_BINLOG_MAP(_RT_BINLOG_TYPE, ##__VA_ARGS__) };          \
+        const rt_ubase_t _binlog_args[] =                                   \
+            { 0, _RT_BINLOG_MAP(_RT_BINLOG_WORD, ##__VA_ARGS__) };          \
+        rt_binlog_write(_binlog_fmt, &_binlog_type[1], &_binlog_args[1],    \
+                        RT_BINLOG_NARGS(__VA_ARGS__));                      \
+    }                                                                       \
+    while (0)
+
+rt_size_t rt_binlog_write(const char *fmt, const rt_uint8_t *type,
+                          const rt_ubase_t *args, rt_size_t nargs);
+
+#else
+
+#define RT_BINLOG(fmt, ...)             rt_kprintf(fmt, ##__VA_ARGS__)
+
+#endif /* RT_USING_BINLOG */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,58 @@
 #endif
 #endif
 
+#ifdef RT_USING_TLSF_MEM
+#if !defined(RT_USING_TLSF)
+#error "TLSF heap need TLSF allocator(RT_USING_TLSF)"
+#endif
+
+#if defined(RT_USING_SMALL_MEM) || defined(RT_USING_SLAB) || defined(RT_USING_MEMHEAP_AS_HEAP)
+#error "TLSF heap can't be used with another heap(RT_USING_SMALL_MEM/RT_USING_SLAB/RT_USING_MEMHEAP_AS_HEAP)"
+#endif
+#endif
+
+#ifdef RT_USING_SLAB_MAGAZINE
+#if !defined(RT_USING_SLAB)
+#error "slab magazine need slab allocator(RT_USING_SLAB)"
+#endif
+#endif
+
+#ifdef RT_USING_MP_CLASS
+#if !defined(RT_USING_MEMPOOL) || !defined(RT_USING_HEAP)
+#error "size class allocator need memory pool(RT_USING_MEMPOOL) and heap(RT_USING_HEAP)"
+#endif
+#endif
+
+#ifdef RT_USING_HEAP_FAST
+#if !defined(RT_USING_MEMHEAP_AS_HEAP)
+#error "fast heap region need memheap as system heap(RT_USING_MEMHEAP_AS_HEAP)"
+#endif
+#endif
+
+#ifdef RT_USING_STACK_GUARD
+#if defined(RT_USING_SMP) || defined(ARCH_CPU_STACK_GROWS_UPWARD)
+#error "stack guard can't be used with SMP or upward growing stack"
+#endif
+#endif
+
+#ifdef RT_USING_BINLOG
+#if !defined(RT_USING_CONSOLE)
+#error "binary log need console(RT_USING_CONSOLE)"
+#endif
+#endif
+
+#ifdef BSP_USING_UART
+#if !defined(RT_USING_DEVICE) || !defined(RT_USING_CONSOLE)
+#error "uart device need device(RT_USING_DEVICE) and console(RT_USING_CONSOLE)"
+#endif
+#endif
+
+#ifdef FINSH_USING_CMD_INDEX
+#if !defined(RT_USING_HEAP)
+#error "msh command index need heap(RT_USING_HEAP)"
+#endif
+#endif
+
 /* Using this macro to control all kernel debug features. */
 // #define RT_DEBUG
 #ifdef RT_DEBUG
@@ -236,6 +236,27 @@ typedef int (*init_fn_t)(void);
 #define RT_MM_PAGE_MASK                 (RT_MM_PAGE_SIZE - 1)
 #define RT_MM_PAGE_BITS                 12
 
+/* slab per-thread magazines, cache chunks of the first zones (8..64 bytes) */
+#ifdef RT_USING_SLAB_MAGAZINE
+#define RT_SLAB_MAG_ZONES               8
+#ifndef RT_SLAB_MAG_SIZE
+#define RT_SLAB_MAG_SIZE                8
+#endif
+#if RT_SLAB_MAG_SIZE < 2 || RT_SLAB_MAG_SIZE > 255
+#error "RT_SLAB_MAG_SIZE should be in 2..255"
+#endif
+#endif
+
+/* heap region hints of rt_malloc_hint */
+#define RT_MEM_ANY                      0x00                /**< any region, as rt_malloc */
+#define RT_MEM_FAST                     0x01                /**< fast region (tightly coupled memory) first */
+#define RT_MEM_LARGE                    0x02                /**< any region but the fast one */
+
+/* kernel objects, thread stacks and IPC buffers go to the fast region */
+#if defined(RT_USING_HEAP_FAST) && !defined(RT_KERNEL_MALLOC)
+#define RT_KERNEL_MALLOC(sz)            rt_malloc_hint(sz, RT_MEM_FAST)
+#endif
+
 /* kernel malloc definitions */
 #ifndef RT_KERNEL_MALLOC
 #define RT_KERNEL_MALLOC(sz)            rt_malloc(sz)
@@ -245,6 +266,15 @@ typedef int (*init_fn_t)(void);
 #define RT_KERNEL_FREE(ptr)             rt_free(ptr)
 #endif
 
+/* buffers of kernel objects (thread stacks, IPC pools), kept for reuse by object cache */
+#if defined(RT_USING_HEAP) && defined(RT_USING_OBJECT_CACHE)
+#define RT_KERNEL_BUF_MALLOC(sz)        rt_object_buffer_alloc(sz)
+#define RT_KERNEL_BUF_FREE(ptr, sz)     rt_object_buffer_free(ptr, sz)
+#else
+#define RT_KERNEL_BUF_MALLOC(sz)        RT_KERNEL_MALLOC(sz)
+#define RT_KERNEL_BUF_FREE(ptr, sz)     RT_KERNEL_FREE(ptr)
+#endif
+
 #ifndef RT_KERNEL_REALLOC
 #define RT_KERNEL_REALLOC(ptr, size)    rt_realloc(ptr, size)
 #endif
@@ -339,6 +369,9 @@ struct rt_object
     void      *module_id;                               /**< id of application module */
 #endif
     rt_list_t  list;                                    /**< list node of kernel object */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object in the name hash bucket */
+#endif
 };
 typedef struct rt_object *rt_object_t;                  /**< Type for kernel objects. */
 
@@ -355,6 +388,7 @@ typedef struct rt_object *rt_object_t;                  /**< Type for kernel obj
  *  - MemPool
  *  - Device
  *  - Timer
+ *  - Topic
  *  - Module
  *  - Unknown
  *  - Static
@@ -372,6 +406,7 @@ enum rt_object_class_type
     RT_Object_Class_MemPool,                            /**< The object is a memory pool. */
     RT_Object_Class_Device,                             /**< The object is a device */
     RT_Object_Class_Timer,                              /**< The object is a timer. */
+    RT_Object_Class_Topic,                              /**< The object is a topic. */
     RT_Object_Class_Module,                             /**< The object is a module. */
     RT_Object_Class_Unknown,                            /**< The object is unknown. */
     RT_Object_Class_Static = 0x80                       /**< The object is a static object. */
@@ -397,6 +432,16 @@ struct rt_object_information
 #define RT_OBJECT_HOOK_CALL(func, argv)
 #endif
 
+/* heap profiler, invoked by heap backends with the return address of caller */
+#ifdef RT_USING_MEMPROF
+#define RT_MEMPROF_ALLOC(ptr, size)     \
+    rt_memprof_alloc((ptr), (size), __builtin_return_address(0))
+#define RT_MEMPROF_FREE(ptr)            rt_memprof_free(ptr)
+#else
+#define RT_MEMPROF_ALLOC(ptr, size)
+#define RT_MEMPROF_FREE(ptr)
+#endif
+
 /**@}*/
 
 /**
@@ -512,6 +557,9 @@ struct rt_thread
 #endif
 
     rt_list_t   list;                                   /**< the object list */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object in the name hash bucket */
+#endif
     rt_list_t   tlist;                                  /**< the thread list */
 
     /* stack point and entry */
@@ -557,6 +605,20 @@ struct rt_thread
 
     void (*cleanup)(struct rt_thread *tid);             /**< cleanup function when thread exit */
 
+#ifdef RT_USING_STACK_WATERMARK
+    rt_uint32_t stack_free;                             /**< least free stack seen by idle scan */
+    rt_uint32_t stack_scan;                             /**< bytes scanned in the current round */
+#endif
+
+#ifdef RT_USING_ARENA
+    struct rt_arena *arena;                             /**< scratch arena of thread */
+#endif
+
+#ifdef RT_USING_SLAB_MAGAZINE
+    void       *slab_mag[RT_SLAB_MAG_ZONES];            /**< cached free chunks of small slab zones */
+    rt_uint8_t  slab_mag_cnt[RT_SLAB_MAG_ZONES];        /**< number of cached chunks */
+#endif
+
     /* light weight process if present */
 #ifdef RT_USING_LWP
     void        *lwp;
@@ -586,6 +648,32 @@ typedef struct rt_thread *rt_thread_t;
 #define RT_WAITING_FOREVER              -1              /**< Block forever until get resource. */
 #define RT_WAITING_NO                   0               /**< Non-block. */
 
+#ifdef RT_USING_IPC_STATS
+#ifndef RT_IPC_STATS_HIST_NR
+#define RT_IPC_STATS_HIST_NR            16              /**< buckets of wait time histogram */
+#endif
+#ifndef RT_IPC_STATS_HIST_SHIFT
+#define RT_IPC_STATS_HIST_SHIFT         8               /**< bucket 0 holds waits below 2^(SHIFT+1) cycles */
+#endif
+
+/**
+ * contention statistics of IPC object, times are in CPU cycles
+ */
+struct rt_ipc_stats
+{
+    rt_uint32_t      take;                              /**< successful takes */
+    rt_uint32_t      contended;                         /**< takes which have been blocked */
+    rt_uint32_t      timeout;                           /**< blocked takes failed by timeout or error */
+
+    rt_uint64_t      wait_total;                        /**< total blocked time */
+    rt_uint32_t      wait_max;                          /**< maximal blocked time */
+    rt_uint32_t      wait_hist[RT_IPC_STATS_HIST_NR];   /**< log2 histogram of blocked time */
+
+    rt_uint32_t      hold_start;                        /**< mutex only, time of the owner got it */
+    rt_uint32_t      hold_max;                          /**< mutex only, maximal hold time */
+};
+#endif
+
 /**
  * Base structure of IPC object
  */
@@ -594,6 +682,10 @@ struct rt_ipc_object
     struct rt_object parent;                            /**< inherit from rt_object */
 
     rt_list_t        suspend_thread;                    /**< threads pended on this resource */
+
+#ifdef RT_USING_IPC_STATS
+    struct rt_ipc_stats stats;                          /**< contention statistics */
+#endif
 };
 
 #ifdef RT_USING_SEMAPHORE
@@ -691,7 +783,61 @@ struct rt_messagequeue
 typedef struct rt_messagequeue *rt_mq_t;
 #endif
 
+#ifdef RT_USING_TOPIC
+/**
+ * topic structure, one sample buffer shared by all subscribers
+ */
+struct rt_topic
+{
+    struct rt_ipc_object parent;                        /**< inherit from ipc_object */
+
+    void                *buffer;                        /**< the latest published sample */
+    rt_uint16_t          size;                          /**< size of one sample */
+    rt_uint16_t          reserved;                      /**< reserved field */
+
+    rt_uint32_t          generation;                    /**< publish counter, 0 means no sample yet */
+    rt_tick_t            timestamp;                     /**< tick of the latest publish */
+
+    rt_list_t            sub_list;                      /**< all subscribers */
+};
+typedef struct rt_topic *rt_topic_t;
+
+/**
+ * topic subscriber, only a cursor into the topic, samples are never queued
+ */
+struct rt_topic_sub
+{
+    rt_topic_t           topic;                         /**< subscribed topic */
+    rt_uint32_t          generation;                    /**< generation of the last read sample */
+
+    rt_list_t            list;                          /**< node on topic subscriber list */
+    void (*notify)(struct rt_topic_sub *sub, void *parameter); /**< publish callback */
+    void                *parameter;                     /**< callback parameter */
+};
+typedef struct rt_topic_sub *rt_topic_sub_t;
+#endif
+
+/**@}*/
+
+#ifdef RT_USING_THREAD_POOL
+/**
+ * @addtogroup Thread
+ */
+
+/**@{*/
+
+/*
+ * thread pool bands, from the highest priority to the lowest
+ */
+#define RT_THREAD_POOL_HIGH             0x00                /**< High priority workers */
+#define RT_THREAD_POOL_NORMAL           0x01                /**< Normal priority workers */
+#define RT_THREAD_POOL_LOW              0x02                /**< Low priority workers */
+#define RT_THREAD_POOL_BAND_NR          3                   /**< Number of bands */
+
+typedef struct rt_pool_job *rt_pool_job_t;                  /**< Type for thread pool job handle. */
+
 /**@}*/
+#endif
 
 /**
  * @addtogroup MM
@@ -704,6 +850,14 @@ typedef struct rt_messagequeue *rt_mq_t;
  * heap & partition
  */
 
+#ifdef RT_USING_TLSF
+/**
+ * Two-Level Segregated Fit pool, the control structure lives at the head of
+ * the managed memory
+ */
+typedef struct rt_tlsf *rt_tlsf_t;
+#endif
+
 #ifdef RT_USING_MEMHEAP
 /**
  * memory item on the heap
@@ -754,7 +908,8 @@ struct rt_mempool
     rt_size_t        size;                              /**< size of memory pool */
 
     rt_size_t        block_size;                        /**< size of memory blocks */
-    rt_uint8_t      *block_list;                        /**< memory blocks list */
+    rt_uint32_t      block_list;                        /**< memory blocks list, version and code of first block */
+    rt_uint32_t      block_mask;                        /**< code bits of block_list */
 
     rt_size_t        block_total_count;                 /**< numbers of memory block */
     rt_size_t        block_free_count;                  /**< numbers of free memory block */
@@ -765,6 +920,27 @@ struct rt_mempool
 typedef struct rt_mempool *rt_mp_t;
 #endif
 
+#ifdef RT_USING_ARENA
+#define RT_ARENA_FLAG_STATIC            0x00                /**< region given by rt_arena_init */
+#define RT_ARENA_FLAG_HEAP              0x01                /**< region allocated by rt_arena_create */
+
+/**
+ * Scratch arena, blocks are taken by bumping a pointer and released all
+ * at once by resetting it to a mark
+ */
+struct rt_arena
+{
+    rt_uint8_t      *begin;                             /**< region start */
+    rt_uint8_t      *end;                               /**< region end */
+    rt_uint8_t      *top;                               /**< first free byte */
+    rt_uint8_t      *peak;                              /**< highest top seen */
+
+    rt_uint8_t       flag;                              /**< RT_ARENA_FLAG_xxx */
+};
+typedef struct rt_arena *rt_arena_t;
+typedef rt_size_t rt_arena_mark_t;                      /**< Type for arena mark, bytes in use */
+#endif
+
 /**@}*/
 
 #ifdef RT_USING_DEVICE
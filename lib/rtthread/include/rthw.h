@@ -117,6 +117,20 @@ void rt_hw_exception_install(rt_err_t (*exception_handle)(void *context));
  */
 void rt_hw_us_delay(rt_uint32_t us);
 
+/*
+ * cycle counter interface, free running counter of CPU clock
+ */
+rt_uint32_t rt_hw_cycle_get(void);
+
+#ifdef RT_USING_STACK_GUARD
+/*
+ * stack guard interfaces
+ */
+void rt_hw_stack_guard_init(void);
+void rt_hw_stack_guard_trap_init(void);
+rt_size_t rt_hw_stack_guard_skip(struct rt_thread *thread);
+#endif
+
 #define RT_DEFINE_SPINLOCK(x)  
 #define RT_DECLARE_SPINLOCK(x)    rt_ubase_t x
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Stackless protothreads
+ *
+ * A protothread is a C function resumed from where it last waited, by a
+ * switch on the line number saved in its control block. All protothreads
+ * are run by one kernel thread on one stack, which sleeps until the earliest
+ * timeout or until rt_pt_notify is invoked.
+ *
+ * A protothread function looks like:
+ *
+ * struct blink
+ * {
+ *     struct rt_pt pt;
+ *     int count;                      // kept across waits, unlike locals
+ * };
+ *
+ * static int blink_entry(struct rt_pt *pt)
+ * {
+ *     struct blink *blink = rt_container_of(pt, struct blink, pt);
+ *
+ *     RT_PT_BEGIN(pt);
+ *     while (1)
+ *     {
+ *         blink->count ++;
+ *         RT_PT_DELAY(pt, 500);
+ *     }
+ *     RT_PT_END(pt);
+ * }
+ *
+ * Local variables are not kept across RT_PT_xxx waits, and a switch
+ * statement can't be used around them. The waits never block: a kernel
+ * object is polled without waiting each time the runner wakes up, so the
+ * producer should invoke rt_pt_notify after a release or send to have the
+ * protothread resumed at once, otherwise it's resumed within RT_PT_POLL_TICKS.
+ */
+
+#ifndef __RT_PT_H__
+#define __RT_PT_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_PT_WAITING                   0x00                /**< waits for a condition or timeout */
+#define RT_PT_YIELDED                   0x01                /**< runs again in the next round */
+#define RT_PT_EXITED                    0x02                /**< has completed */
+
+/**
+ * protothread control block
+ */
+struct rt_pt
+{
+    rt_list_t    list;                                  /**< node on runner list */
+    const char  *name;                                  /**< name of protothread */
+
+    int (*entry)(struct rt_pt *pt);                     /**< protothread function */
+    void        *parameter;                             /**< parameter of protothread function */
+
+    rt_uint16_t  lc;                                    /**< local continuation, line to resume */
+    rt_uint8_t   stat;                                  /**< RT_PT_xxx of the last run */
+    rt_uint8_t   poll;                                  /**< condition polled at each wakeup */
+
+    rt_uint8_t   timed;                                 /**< wakeup tick is valid */
+    rt_tick_t    wakeup;                                /**< tick to time out */
+
+    rt_err_t     result;                                /**< result of the last wait */
+};
+typedef struct rt_pt *rt_pt_t;
+
+void rt_pt_init(struct rt_pt *pt,
+                const char   *name,
+                int (*entry)(struct rt_pt *pt),
+                void         *parameter);
+rt_err_t rt_pt_startup(struct rt_pt *pt);
+void rt_pt_notify(void);
+
+void rt_pt_wait_prepare(struct rt_pt *pt, rt_int32_t timeout, rt_uint8_t poll);
+rt_bool_t rt_pt_timeout(struct rt_pt *pt);
+
+/**
+ * start of protothread function body
+ */
+#define RT_PT_BEGIN(pt)                                                       \
+    switch ((pt)->lc) { case 0:
+
+/**
+ * end of protothread function body, the protothread exits
+ */
+#define RT_PT_END(pt)                                                         \
+    } (pt)->lc = 0; return RT_PT_EXITED
+
+/**
+ * exit the protothread
+ */
+#define RT_PT_EXIT(pt)                                                        \
+    do { (pt)->lc = 0; return RT_PT_EXITED; } while (0)
+
+/**
+ * let the other protothreads run, then continue
+ */
+#define RT_PT_YIELD(pt)                                                       \
+    do {                                                                      \
+        (pt)->lc = __LINE__; return RT_PT_YIELDED;                            \
+        case __LINE__:;                                                       \
+    } while (0)
+
+/**
+ * wait until cond is true or timeout, (pt)->result is RT_EOK or -RT_ETIMEOUT
+ */
+#define RT_PT_WAIT_UNTIL(pt, cond, timeout)                                   \
+    do {                                                                      \
+        rt_pt_wait_prepare((pt), (timeout), 1);                               \
+        (pt)->lc = __LINE__;                                                  \
+        case __LINE__:                                                        \
+        if (cond)                                                             \
+            (pt)->result = RT_EOK;                                            \
+        else if (rt_pt_timeout(pt))                                           \
+            (pt)->result = -RT_ETIMEOUT;                                      \
+        else                                                                  \
+            return RT_PT_WAITING;                                             \
+    } while (0)
+
+/**
+ * sleep for some ticks
+ */
+#define RT_PT_DELAY(pt, tick)                                                 \
+    do {                                                                      \
+        rt_pt_wait_prepare((pt), (tick), 0);                                  \
+        (pt)->lc = __LINE__;                                                  \
+        case __LINE__:                                                        \
+        if (!rt_pt_timeout(pt))                                               \
+            return RT_PT_WAITING;                                             \
+        (pt)->result = RT_EOK;                                                \
+    } while (0)
+
+/**
+ * take a semaphore
+ */
+#define RT_PT_SEM_TAKE(pt, sem, timeout)                                      \
+    RT_PT_WAIT_UNTIL(pt, rt_sem_take((sem), RT_WAITING_NO) == RT_EOK, timeout)
+
+#ifdef RT_USING_MAILBOX
+/**
+ * receive a mail, value points to a rt_uint32_t kept across waits
+ */
+#define RT_PT_MB_RECV(pt, mb, value, timeout)                                 \
+    RT_PT_WAIT_UNTIL(pt, rt_mb_recv((mb), (value), RT_WAITING_NO) == RT_EOK, timeout)
+#endif
+
+#ifdef RT_USING_MESSAGEQUEUE
+/**
+ * receive a message, buffer must be kept across waits
+ */
+#define RT_PT_MQ_RECV(pt, mq, buffer, size, timeout)                          \
+    RT_PT_WAIT_UNTIL(pt, rt_mq_recv((mq), (buffer), (size), RT_WAITING_NO) == RT_EOK, timeout)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -51,6 +51,11 @@ rt_bool_t rt_object_is_systemobject(rt_object_t object);
 rt_uint8_t rt_object_get_type(rt_object_t object);
 rt_object_t rt_object_find(const char *name, rt_uint8_t type);
 
+#if defined(RT_USING_HEAP) && defined(RT_USING_OBJECT_CACHE)
+void *rt_object_buffer_alloc(rt_size_t size);
+void rt_object_buffer_free(void *buffer, rt_size_t size);
+#endif
+
 #ifdef RT_USING_HOOK
 void rt_object_attach_sethook(void (*hook)(struct rt_object *object));
 void rt_object_detach_sethook(void (*hook)(struct rt_object *object));
@@ -155,6 +160,17 @@ void rt_thread_resume_sethook (void (*hook)(rt_thread_t thread));
 void rt_thread_inited_sethook (void (*hook)(rt_thread_t thread));
 #endif
 
+#ifdef RT_USING_THREAD_POOL
+/*
+ * thread pool interface
+ */
+rt_pool_job_t rt_thread_pool_submit(void (*entry)(void *parameter),
+                                    void       *parameter,
+                                    rt_uint8_t  band);
+rt_err_t rt_thread_pool_wait(rt_pool_job_t job, rt_int32_t timeout);
+void rt_thread_pool_detach(rt_pool_job_t job);
+#endif
+
 /*
  * idle thread interface
  */
@@ -226,6 +242,8 @@ rt_err_t rt_mp_delete(rt_mp_t mp);
 
 void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time);
 void rt_mp_free(void *block);
+rt_size_t rt_mp_alloc_batch(rt_mp_t mp, void **blocks, rt_size_t count, rt_int32_t time);
+void rt_mp_free_batch(void **blocks, rt_size_t count);
 
 #ifdef RT_USING_HOOK
 void rt_mp_alloc_sethook(void (*hook)(struct rt_mempool *mp, void *block));
@@ -241,6 +259,12 @@ void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block));
 void rt_system_heap_init(void *begin_addr, void *end_addr);
 
 void *rt_malloc(rt_size_t nbytes);
+#ifdef RT_USING_HEAP_FAST
+void rt_system_heap_fast_init(void *begin_addr, void *end_addr);
+void *rt_malloc_hint(rt_size_t size, rt_uint32_t hint);
+#else
+#define rt_malloc_hint(size, hint)      rt_malloc(size)
+#endif
 void rt_free(void *ptr);
 void *rt_realloc(void *ptr, rt_size_t nbytes);
 void *rt_calloc(rt_size_t count, rt_size_t size);
@@ -250,10 +274,23 @@ void rt_free_align(void *ptr);
 void rt_memory_info(rt_uint32_t *total,
                     rt_uint32_t *used,
                     rt_uint32_t *max_used);
+void rt_memory_free_info(rt_uint32_t *free, rt_uint32_t *max_free);
+
+#ifdef RT_USING_MEMPROF
+void rt_memprof_alloc(void *ptr, rt_size_t size, void *caller);
+void rt_memprof_free(void *ptr);
+#endif
 
 #ifdef RT_USING_SLAB
 void *rt_page_alloc(rt_size_t npages);
 void rt_page_free(void *addr, rt_size_t npages);
+void rt_page_info(rt_uint32_t *total, rt_uint32_t *free, rt_uint32_t *max_free,
+                  rt_uint32_t *zone);
+#endif
+
+#ifdef RT_USING_SLAB_MAGAZINE
+void rt_slab_mag_flush(rt_thread_t thread);
+void rt_slab_mag_info(rt_uint32_t *hit, rt_uint32_t *exchange);
 #endif
 
 #ifdef RT_USING_HOOK
@@ -261,6 +298,32 @@ void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size));
 void rt_free_sethook(void (*hook)(void *ptr));
 #endif
 
+#ifdef RT_USING_ISR_MEM
+void *rt_isr_malloc(rt_size_t size);
+void rt_isr_free(void *ptr);
+#endif
+
+#ifdef RT_USING_MP_CLASS
+void *rt_mp_class_malloc(rt_size_t size);
+void rt_mp_class_free(void *ptr);
+#endif
+
+#endif
+
+#ifdef RT_USING_ARENA
+/*
+ * scratch arena interface
+ */
+rt_err_t rt_arena_init(struct rt_arena *arena, void *begin, rt_size_t size);
+#ifdef RT_USING_HEAP
+rt_arena_t rt_arena_create(rt_size_t size);
+void rt_arena_delete(rt_arena_t arena);
+#endif
+void *rt_arena_alloc(rt_arena_t arena, rt_size_t size);
+rt_arena_mark_t rt_arena_mark(rt_arena_t arena);
+void rt_arena_reset(rt_arena_t arena, rt_arena_mark_t mark);
+rt_arena_t rt_arena_attach(rt_thread_t thread, rt_arena_t arena);
+rt_arena_t rt_arena_self(void);
 #endif
 
 #ifdef RT_USING_MEMHEAP
@@ -277,6 +340,21 @@ void *rt_memheap_realloc(struct rt_memheap *heap, void *ptr, rt_size_t newsize);
 void rt_memheap_free(void *ptr);
 #endif
 
+#ifdef RT_USING_TLSF
+/**
+ * TLSF pool interface
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size);
+void rt_tlsf_detach(rt_tlsf_t tlsf);
+void *rt_tlsf_alloc(rt_tlsf_t tlsf, rt_size_t size);
+void *rt_tlsf_realloc(rt_tlsf_t tlsf, void *ptr, rt_size_t newsize);
+void rt_tlsf_free(rt_tlsf_t tlsf, void *ptr);
+void rt_tlsf_info(rt_tlsf_t    tlsf,
+                  rt_uint32_t *total,
+                  rt_uint32_t *used,
+                  rt_uint32_t *max_used);
+#endif
+
 /**@}*/
 
 /**
@@ -382,6 +460,37 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
 #endif
 
+#ifdef RT_USING_IPC_STATS
+/*
+ * IPC contention statistics interface
+ */
+void rt_ipc_stats_reset(struct rt_ipc_object *ipc);
+#endif
+
+#ifdef RT_USING_TOPIC
+/*
+ * topic interface
+ */
+rt_err_t rt_topic_init(rt_topic_t  topic,
+                       const char *name,
+                       void       *buffer,
+                       rt_size_t   size,
+                       rt_uint8_t  flag);
+rt_err_t rt_topic_detach(rt_topic_t topic);
+rt_topic_t rt_topic_create(const char *name, rt_size_t size, rt_uint8_t flag);
+rt_err_t rt_topic_delete(rt_topic_t topic);
+
+rt_err_t rt_topic_publish(rt_topic_t topic, const void *sample);
+rt_err_t rt_topic_subscribe(rt_topic_t     topic,
+                            rt_topic_sub_t sub,
+                            void (*notify)(rt_topic_sub_t sub, void *parameter),
+                            void          *parameter);
+rt_err_t rt_topic_unsubscribe(rt_topic_sub_t sub);
+rt_bool_t rt_topic_updated(rt_topic_sub_t sub);
+rt_err_t rt_topic_wait(rt_topic_sub_t sub, rt_int32_t timeout);
+rt_err_t rt_topic_read(rt_topic_sub_t sub, void *sample);
+#endif
+
 /**@}*/
 
 #ifdef RT_USING_DEVICE
@@ -466,9 +575,11 @@ void rt_components_board_init(void);
 #ifndef RT_USING_CONSOLE
 #define rt_kprintf(...)
 #define rt_kputs(str)
+#define rt_console_flush()
 #else
 void rt_kprintf(const char *fmt, ...);
 void rt_kputs(const char *str);
+void rt_console_flush(void);
 #endif
 rt_int32_t rt_vsprintf(char *dest, const char *format, va_list arg_ptr);
 rt_int32_t rt_vsnprintf(char *buf, rt_size_t size, const char *fmt, va_list args);
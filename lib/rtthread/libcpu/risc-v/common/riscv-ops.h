@@ -36,6 +36,38 @@
     else                                                                    \
         asm volatile ("csrrc %0, " #reg ", %1" : "=r"(__tmp) : "r"(bit));   \
             __tmp; })
+
+#ifdef __riscv_atomic
+/*
+ * Store new into the word at ptr if it still holds old, and return the value
+ * seen there, which equals old on success. Only lr/bne/sc are in the loop,
+ * a constrained sequence which is guaranteed to make progress. A trap
+ * between lr and sc on the same hart is caught only if the trap exit drops
+ * the reservation with a dummy sc before mret, as rt_hw_context_switch_exit
+ * does; mret itself is not required to.
+ */
+static inline unsigned long atomic_cas_w(volatile void *ptr, unsigned long old, unsigned long new)
+{
+    unsigned long seen, fail;
+
+    asm volatile (
+        "1: lr.w.aq  %0, (%2)\n"
+        "   bne      %0, %3, 2f\n"
+        "   sc.w.rl  %1, %4, (%2)\n"
+        "   bnez     %1, 1b\n"
+        "2:\n"
+        : "=&r"(seen), "=&r"(fail)
+        : "r"(ptr), "r"(old), "r"(new)
+        : "memory");
+
+    return seen;
+}
+
+/* add value to the word at ptr */
+#define atomic_add_w(ptr, value) ({                                         \
+    asm volatile ("amoadd.w zero, %1, %0"                                   \
+                  : "+A"(*(ptr)) : "r"(value) : "memory"); })
+#endif /* end of __riscv_atomic */
 #endif /* end of __GNUC__ */
 
 #endif
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Scratch arena
+ *
+ * An arena hands out blocks from one region by bumping a pointer, there is no
+ * block header and no free: a job takes a mark when it starts and resets the
+ * arena to it when it's done, which releases all its blocks at once. The
+ * region is a static buffer, a block of a memory pool or a single heap
+ * allocation, so scratch buffers never fragment the system heap.
+ *
+ * An arena has no lock, it belongs to one thread at a time. A thread can have
+ * its own arena attached, which is found by rt_arena_self.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_ARENA
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will initialize an arena on a region.
+ *
+ * @param arena the arena
+ * @param begin the start address of region
+ * @param size the size of region
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_arena_init(struct rt_arena *arena, void *begin, rt_size_t size)
+{
+    RT_ASSERT(arena != RT_NULL);
+    RT_ASSERT(begin != RT_NULL);
+
+    arena->begin = (rt_uint8_t *)RT_ALIGN((rt_ubase_t)begin, RT_ALIGN_SIZE);
+    arena->end   = (rt_uint8_t *)RT_ALIGN_DOWN((rt_ubase_t)begin + size, RT_ALIGN_SIZE);
+    if (arena->end < arena->begin)
+        arena->end = arena->begin;
+
+    arena->top  = arena->begin;
+    arena->peak = arena->begin;
+    arena->flag = RT_ARENA_FLAG_STATIC;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_arena_init);
+
+#ifdef RT_USING_HEAP
+/**
+ * This function will create an arena with the control block and the region
+ * in one heap allocation.
+ *
+ * @param size the size of region
+ *
+ * @return the created arena, RT_NULL on error
+ */
+rt_arena_t rt_arena_create(rt_size_t size)
+{
+    struct rt_arena *arena;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    size  = RT_ALIGN(size, RT_ALIGN_SIZE);
+    arena = (struct rt_arena *)rt_malloc(RT_ALIGN(sizeof(struct rt_arena), RT_ALIGN_SIZE) + size);
+    if (arena == RT_NULL)
+        return RT_NULL;
+
+    rt_arena_init(arena, (rt_uint8_t *)arena + RT_ALIGN(sizeof(struct rt_arena), RT_ALIGN_SIZE), size);
+    arena->flag = RT_ARENA_FLAG_HEAP;
+
+    return arena;
+}
+RTM_EXPORT(rt_arena_create);
+
+/**
+ * This function will delete an arena created by rt_arena_create.
+ *
+ * @param arena the arena
+ */
+void rt_arena_delete(rt_arena_t arena)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    RT_ASSERT(arena != RT_NULL);
+    RT_ASSERT(arena->flag == RT_ARENA_FLAG_HEAP);
+
+    rt_free(arena);
+}
+RTM_EXPORT(rt_arena_delete);
+#endif
+
+/**
+ * This function will allocate a block from an arena.
+ *
+ * @param arena the arena
+ * @param size the size of block
+ *
+ * @return the allocated block, RT_NULL if the arena has no room
+ */
+void *rt_arena_alloc(rt_arena_t arena, rt_size_t size)
+{
+    rt_uint8_t *block;
+
+    RT_ASSERT(arena != RT_NULL);
+
+    size = RT_ALIGN(size, RT_ALIGN_SIZE);
+    if (size > (rt_size_t)(arena->end - arena->top))
+        return RT_NULL;
+
+    block = arena->top;
+    arena->top += size;
+    if (arena->top > arena->peak)
+        arena->peak = arena->top;
+
+    return block;
+}
+RTM_EXPORT(rt_arena_alloc);
+
+/**
+ * This function will return a mark of the blocks allocated so far.
+ *
+ * @param arena the arena
+ *
+ * @return the mark to be given to rt_arena_reset
+ */
+rt_arena_mark_t rt_arena_mark(rt_arena_t arena)
+{
+    RT_ASSERT(arena != RT_NULL);
+
+    return arena->top - arena->begin;
+}
+RTM_EXPORT(rt_arena_mark);
+
+/**
+ * This function will release all blocks allocated after a mark.
+ *
+ * @param arena the arena
+ * @param mark the mark returned by rt_arena_mark, 0 to release all blocks
+ */
+void rt_arena_reset(rt_arena_t arena, rt_arena_mark_t mark)
+{
+    RT_ASSERT(arena != RT_NULL);
+    RT_ASSERT(mark <= (rt_arena_mark_t)(arena->top - arena->begin));
+
+    arena->top = arena->begin + mark;
+}
+RTM_EXPORT(rt_arena_reset);
+
+/**
+ * This function will attach an arena to a thread.
+ *
+ * @param thread the thread, RT_NULL for the current thread
+ * @param arena the arena, RT_NULL to detach
+ *
+ * @return the arena attached before
+ */
+rt_arena_t rt_arena_attach(rt_thread_t thread, rt_arena_t arena)
+{
+    rt_arena_t old;
+
+    if (thread == RT_NULL)
+        thread = rt_thread_self();
+    RT_ASSERT(thread != RT_NULL);
+
+    old = thread->arena;
+    thread->arena = arena;
+
+    return old;
+}
+RTM_EXPORT(rt_arena_attach);
+
+/**
+ * This function will return the arena of the current thread.
+ *
+ * @return the arena, RT_NULL if the thread has none or in ISR
+ */
+rt_arena_t rt_arena_self(void)
+{
+    rt_thread_t thread;
+
+    if (rt_interrupt_get_nest() != 0)
+        return RT_NULL;
+
+    thread = rt_thread_self();
+    if (thread == RT_NULL)
+        return RT_NULL;
+
+    return thread->arena;
+}
+RTM_EXPORT(rt_arena_self);
+
+/**@}*/
+
+#endif /* end of RT_USING_ARENA */
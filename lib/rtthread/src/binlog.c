@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Deferred binary logging, see rtbinlog.h for the frame.
+ *
+ * A log line costs a few shifts per argument instead of rt_vsnprintf, and
+ * a handful of bytes on the console instead of the text.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtbinlog.h>
+
+#ifdef RT_USING_BINLOG
+
+/* bytes of arguments in a frame, a longer string is cut */
+#ifndef RT_BINLOG_PAYLOAD_MAX
+#define RT_BINLOG_PAYLOAD_MAX           48
+#endif
+
+#if RT_BINLOG_PAYLOAD_MAX > 255 || RT_BINLOG_PAYLOAD_MAX < RT_BINLOG_ARGS_MAX * 5
+#error "RT_BINLOG_PAYLOAD_MAX must hold all arguments and fit in a byte"
+#endif
+
+#define BINLOG_FRAME_START              0xff
+#define BINLOG_ESCAPE                   0xfe
+
+/* defined by the linker for the section of formats */
+extern const char __start_rt_binlog[];
+
+rt_inline rt_uint8_t *binlog_put_number(rt_uint8_t *pos, rt_uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *pos++ = (rt_uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *pos++ = (rt_uint8_t)value;
+
+    return pos;
+}
+
+rt_inline char *binlog_put_byte(char *pos, rt_uint8_t byte)
+{
+    switch (byte)
+    {
+    case 0x00:
+    case '\n':
+    case '\r':
+    case '%':
+    case BINLOG_ESCAPE:
+    case BINLOG_FRAME_START:
+        *pos++ = (char)BINLOG_ESCAPE;
+        byte ^= 0x20;
+        break;
+    }
+    *pos++ = (char)byte;
+
+    return pos;
+}
+
+/**
+ * @addtogroup KernelService
+ */
+
+/**@{*/
+
+/**
+ * This function will write a frame of deferred binary log to the console.
+ * It's invoked by RT_BINLOG.
+ *
+ * @param fmt the format in the section "rt_binlog"
+ * @param type the type of each argument, RT_BINLOG_TYPE_xxx
+ * @param args the arguments
+ * @param nargs the number of arguments
+ *
+ * @return the bytes written to the console
+ */
+rt_size_t rt_binlog_write(const char *fmt, const rt_uint8_t *type,
+                          const rt_ubase_t *args, rt_size_t nargs)
+{
+    rt_uint8_t payload[RT_BINLOG_PAYLOAD_MAX];
+    char frame[1 + 2 * (3 + RT_BINLOG_PAYLOAD_MAX) + 1];
+    rt_uint8_t *end = payload;
+    const char *str;
+    rt_size_t length, index;
+    rt_ubase_t id;
+    char *pos;
+
+    id = fmt - __start_rt_binlog;
+    RT_ASSERT(id <= 0xffff);
+    RT_ASSERT(nargs <= RT_BINLOG_ARGS_MAX);
+
+    for (index = 0; index < nargs; index ++)
+    {
+        if (type[index] == RT_BINLOG_TYPE_STRING)
+        {
+            str = (const char *)args[index];
+            if (str == RT_NULL)
+                str = "(NULL)";
+
+            /* keep room for the numbers still to come */
+            length = rt_strlen(str);
+            if (length > (rt_size_t)(&payload[RT_BINLOG_PAYLOAD_MAX] - end) - 1 - (nargs - index - 1) * 5)
+                length = (rt_size_t)(&payload[RT_BINLOG_PAYLOAD_MAX] - end) - 1 - (nargs - index - 1) * 5;
+
+            *end++ = (rt_uint8_t)length;
+            rt_memcpy(end, str, length);
+            end += length;
+        }
+        else
+        {
+            end = binlog_put_number(end, (rt_uint32_t)args[index]);
+        }
+    }
+
+    pos = frame;
+    *pos++ = (char)BINLOG_FRAME_START;
+    pos = binlog_put_byte(pos, (rt_uint8_t)id);
+    pos = binlog_put_byte(pos, (rt_uint8_t)(id >> 8));
+    pos = binlog_put_byte(pos, (rt_uint8_t)(end - payload));
+    for (index = 0; index < (rt_size_t)(end - payload); index ++)
+        pos = binlog_put_byte(pos, payload[index]);
+    *pos = '\0';
+
+    rt_kputs(frame);
+
+    return pos - frame;
+}
+RTM_EXPORT(rt_binlog_write);
+
+/**@}*/
+
+#endif /* RT_USING_BINLOG */
@@ -55,6 +55,20 @@ struct rt_hw_stack_frame
     rt_ubase_t t6;         /* x31 - t6     - temporary register 6                */
 };
 
+/**
+ * This function will return the cycle counter of CPU (mcycle, low 32 bits)
+ *
+ * @return the current cycle count
+ */
+rt_uint32_t rt_hw_cycle_get(void)
+{
+    rt_uint32_t cycle;
+
+    asm volatile ("csrr %0, mcycle" : "=r"(cycle));
+
+    return cycle;
+}
+
 /**
  * This function will initialize thread stack
  *
@@ -115,10 +129,158 @@ void rt_hw_context_switch_interrupt(rt_ubase_t from, rt_ubase_t to)
 }
 #endif /* end of RT_USING_SMP */
 
+#ifdef RT_USING_STACK_GUARD
+/*
+ * PMP stack guard
+ *
+ * Threads run in machine mode, where only locked PMP entries are enforced,
+ * and a locked entry can't be changed until reset unless the rule locking
+ * bypass of Smepmp (mseccfg.RLB) is set. So this needs a core with PMP and
+ * Smepmp, e.g. QEMU: qemu-system-riscv32 -M virt -cpu rv32,pmp=true,smepmp=true
+ */
+
+#define CSR_MSECCFG         0x747
+#define MSECCFG_RLB         0x04
+
+/* STACK_GUARD_SET in context_gcc.S finds stack_addr 3 words after sp */
+typedef char stack_guard_layout_check[(__builtin_offsetof(struct rt_thread, stack_addr) -
+                                       __builtin_offsetof(struct rt_thread, sp)) == 3 * sizeof(void *) ? 1 : -1];
+
+ALIGN(16)
+static rt_uint8_t stack_guard_fault_stack[RT_STACK_GUARD_FAULT_STACK_SIZE];
+
+/**
+ * This function will allow the locked stack guard to be moved at each context
+ * switch, it must be invoked before the scheduler starts.
+ */
+void rt_hw_stack_guard_init(void)
+{
+    asm volatile ("csrs %0, %1" :: "i"(CSR_MSECCFG), "r"(MSECCFG_RLB));
+
+    /* entry 0 only holds the base of the TOR region of entry 1 */
+    asm volatile ("csrc pmpcfg0, %0" :: "r"(0xffff));
+}
+
+/**
+ * This function will put rt_hw_stack_guard_trap in front of the trap entry
+ * (or vector table) of the BSP, which must be RT_STACK_GUARD_TRAP_CHAIN. It
+ * must be invoked after the BSP has set up mtvec. mscratch is used to hold
+ * the fault stack.
+ */
+void rt_hw_stack_guard_trap_init(void)
+{
+    extern void rt_hw_stack_guard_trap(void);
+    extern void rt_hw_stack_guard_vector(void);
+    extern void RT_STACK_GUARD_TRAP_CHAIN(void);
+    rt_ubase_t mtvec;
+
+    asm volatile ("csrw mscratch, %0"
+                  :: "r"(&stack_guard_fault_stack[RT_STACK_GUARD_FAULT_STACK_SIZE]));
+
+    asm volatile ("csrr %0, mtvec" : "=r"(mtvec));
+    RT_ASSERT((mtvec & ~0x03) == (rt_ubase_t)RT_STACK_GUARD_TRAP_CHAIN);
+
+    /* vectored mode: only the exception vector is taken over */
+    if ((mtvec & 0x03) == 1)
+        mtvec = (rt_ubase_t)rt_hw_stack_guard_vector | 1;
+    else
+        mtvec = (rt_ubase_t)rt_hw_stack_guard_trap;
+    asm volatile ("csrw mtvec, %0" :: "r"(mtvec));
+}
+
+/**
+ * This function will return the bytes at the bottom of a thread stack that
+ * can't be read, for the stack scanners. Only the stack of the running
+ * thread is guarded.
+ *
+ * @param thread the thread
+ *
+ * @return the bytes from stack_addr to the end of the guard, 0 if the thread
+ *         is not guarded
+ */
+rt_size_t rt_hw_stack_guard_skip(struct rt_thread *thread)
+{
+    rt_ubase_t cfg, base, top;
+
+    asm volatile ("csrr %0, pmpcfg0" : "=r"(cfg));
+    if ((cfg & 0x1800) == 0)
+        return 0;
+
+    asm volatile ("csrr %0, pmpaddr0" : "=r"(base));
+    asm volatile ("csrr %0, pmpaddr1" : "=r"(top));
+    base <<= 2;
+    top  <<= 2;
+    if (RT_ALIGN((rt_ubase_t)thread->stack_addr, 4) != base)
+        return 0;
+
+    return top - (rt_ubase_t)thread->stack_addr;
+}
+
+/**
+ * This function is invoked by rt_hw_stack_guard_trap on the fault stack for
+ * an access fault. It reports the overflowed thread and stops if the address
+ * is in the stack guard, otherwise returns for the original trap entry.
+ *
+ * @param mcause the trap cause
+ * @param mepc the faulting instruction
+ * @param mtval the faulting address
+ */
+void rt_hw_stack_guard_fault(rt_ubase_t mcause, rt_ubase_t mepc, rt_ubase_t mtval)
+{
+    struct rt_object_information *information;
+    struct rt_thread *thread, *overflow;
+    struct rt_list_node *node;
+    rt_ubase_t base, top;
+
+    asm volatile ("csrr %0, pmpaddr0" : "=r"(base));
+    asm volatile ("csrr %0, pmpaddr1" : "=r"(top));
+    base <<= 2;
+    top  <<= 2;
+    if (mtval < base || mtval >= top)
+        return;
+
+    /* drop the guard, the report below reads thread stacks and may print from one */
+    asm volatile ("csrc pmpcfg0, %0" :: "r"(0xff00));
+
+    /*
+     * the guard is that of the outgoing thread while a switch saves its
+     * context, so find the owner by the stack rather than rt_current_thread
+     */
+    overflow = rt_thread_self();
+    information = rt_object_get_information(RT_Object_Class_Thread);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node = node->next)
+    {
+        thread = (struct rt_thread *)rt_list_entry(node, struct rt_object, list);
+        if (RT_ALIGN((rt_ubase_t)thread->stack_addr, 4) == base)
+        {
+            overflow = thread;
+            break;
+        }
+    }
+
+    rt_console_flush();
+    rt_kprintf("thread:%.*s stack overflow, %s 0x%08x at pc 0x%08x\n",
+               RT_NAME_MAX, overflow->name,
+               mcause == 7 ? "write" : "read", mtval, mepc);
+#ifdef RT_USING_FINSH
+    {
+        extern long list_thread(void);
+        list_thread();
+    }
+#endif
+
+    rt_hw_interrupt_disable();
+    while (1);
+}
+#endif /* RT_USING_STACK_GUARD */
+
 /** shutdown CPU */
 void rt_hw_cpu_shutdown()
 {
     rt_uint32_t level;
+    rt_console_flush();
     rt_kprintf("shutdown...\n");
 
     level = rt_hw_interrupt_disable();
@@ -24,4 +24,29 @@
 #define REGBYTES                4
 #endif
 
+#ifdef RT_USING_STACK_GUARD
+/* bytes at the bottom of each thread stack without any access */
+#ifndef RT_STACK_GUARD_SIZE
+#define RT_STACK_GUARD_SIZE             32
+#endif
+
+#if (RT_STACK_GUARD_SIZE & 0x03) != 0
+#error "RT_STACK_GUARD_SIZE must be a multiple of 4"
+#endif
+
+/* the trap entry (or vector table) installed by the BSP, taken over at init */
+#ifndef RT_STACK_GUARD_TRAP_CHAIN
+#define RT_STACK_GUARD_TRAP_CHAIN       trap_entry
+#endif
+
+/* entries of rt_hw_stack_guard_vector in vectored mode */
+#ifndef RT_STACK_GUARD_VECTORS
+#define RT_STACK_GUARD_VECTORS          32
+#endif
+
+#ifndef RT_STACK_GUARD_FAULT_STACK_SIZE
+#define RT_STACK_GUARD_FAULT_STACK_SIZE 1024
+#endif
+#endif
+
 #endif
@@ -214,13 +214,127 @@ void rt_thread_idle_excute(void)
 
 #ifdef RT_USING_HEAP
         /* release thread's stack */
-        RT_KERNEL_FREE(thread->stack_addr);
+        RT_KERNEL_BUF_FREE(thread->stack_addr, thread->stack_size);
         /* delete thread object */
         rt_object_delete((rt_object_t)thread);
 #endif
     }
 }
 
+#ifdef RT_USING_STACK_WATERMARK
+
+/* stack bytes checked in one idle loop */
+#ifndef RT_STACK_WATERMARK_STEP
+#define RT_STACK_WATERMARK_STEP         64
+#endif
+
+/* position of the thread being scanned in the thread object list */
+static rt_uint32_t stack_scan_index;
+
+/*
+ * Scan RT_STACK_WATERMARK_STEP bytes of one thread stack for the '#' fill of
+ * _rt_thread_init, starting from the far end of the stack. When the first
+ * touched byte is found, the free bytes before it become the new watermark
+ * of the thread and the scan moves to the next thread. The thread can't be
+ * deleted or detached while the scheduler is locked.
+ */
+static void rt_thread_stack_watermark(void)
+{
+    struct rt_object_information *information;
+    struct rt_thread *thread = RT_NULL;
+    struct rt_list_node *node;
+    rt_uint32_t index, pos, limit, step;
+    rt_uint8_t *bottom;
+    rt_bool_t touched = RT_FALSE;
+#ifdef RT_USING_STACK_GUARD
+    rt_size_t skip;
+#endif
+
+    information = rt_object_get_information(RT_Object_Class_Thread);
+
+    rt_enter_critical();
+
+    index = 0;
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node = node->next)
+    {
+        if (index ++ == stack_scan_index)
+        {
+            thread = (struct rt_thread *)rt_list_entry(node, struct rt_object, list);
+            break;
+        }
+    }
+    if (thread == RT_NULL)
+    {
+        /* round completed */
+        stack_scan_index = 0;
+        rt_exit_critical();
+
+        return;
+    }
+
+    /* the free bytes can only shrink, no need to look beyond the watermark */
+    limit  = thread->stack_free;
+    pos    = thread->stack_scan;
+    step   = RT_STACK_WATERMARK_STEP;
+    bottom = (rt_uint8_t *)thread->stack_addr;
+
+#ifdef ARCH_CPU_STACK_GROWS_UPWARD
+    while (pos < limit && step > 0)
+    {
+        if (bottom[thread->stack_size - 1 - pos] != '#')
+        {
+            touched = RT_TRUE;
+            break;
+        }
+        pos ++;
+        step --;
+    }
+#else
+#ifdef RT_USING_STACK_GUARD
+    /* the guard of the idle thread itself can't be read, and stays untouched */
+    skip = rt_hw_stack_guard_skip(thread);
+    if (pos < skip && skip <= limit)
+        pos = skip;
+#endif
+    if (((rt_ubase_t)bottom & 0x03) == 0)
+    {
+        /* a word at a time, then the bytes of the touched word */
+        while (pos + 4 <= limit && step >= 4 &&
+               *(rt_uint32_t *)(bottom + pos) == 0x23232323)
+        {
+            pos  += 4;
+            step -= 4;
+        }
+    }
+    while (pos < limit && step > 0)
+    {
+        if (bottom[pos] != '#')
+        {
+            touched = RT_TRUE;
+            break;
+        }
+        pos ++;
+        step --;
+    }
+#endif
+
+    if (touched || pos >= limit)
+    {
+        /* reached the first touched byte (or the previous watermark) */
+        thread->stack_free = pos;
+        thread->stack_scan = 0;
+        stack_scan_index ++;
+    }
+    else
+        thread->stack_scan = pos;
+
+    rt_exit_critical();
+}
+
+#endif
+
 extern void rt_system_power_manager(void);
 static void rt_thread_idle_entry(void *parameter)
 {
@@ -240,6 +354,9 @@ static void rt_thread_idle_entry(void *parameter)
 #endif
 
         rt_thread_idle_excute();
+#ifdef RT_USING_STACK_WATERMARK
+        rt_thread_stack_watermark();
+#endif
 #ifdef RT_USING_PM        
         rt_system_power_manager();
 #endif
@@ -61,6 +61,10 @@ rt_inline rt_err_t rt_ipc_object_init(struct rt_ipc_object *ipc)
     /* init ipc object */
     rt_list_init(&(ipc->suspend_thread));
 
+#ifdef RT_USING_IPC_STATS
+    rt_memset(&(ipc->stats), 0, sizeof(ipc->stats));
+#endif
+
     return RT_EOK;
 }
 
@@ -182,6 +186,81 @@ rt_inline rt_err_t rt_ipc_list_resume_all(rt_list_t *list)
     return RT_EOK;
 }
 
+#ifdef RT_USING_IPC_STATS
+/**
+ * This function will record a take on an IPC object.
+ *
+ * @param ipc the IPC object
+ * @param blocked RT_TRUE if the thread has been suspended on this object
+ * @param start the cycle count when the thread began to wait
+ * @param error the result of take
+ */
+static void rt_ipc_stats_take(struct rt_ipc_object *ipc,
+                              rt_bool_t             blocked,
+                              rt_uint32_t           start,
+                              rt_err_t              error)
+{
+    register rt_base_t temp;
+    rt_uint32_t wait, cycles;
+    int index;
+
+    wait  = 0;
+    index = 0;
+    if (blocked == RT_TRUE)
+    {
+        wait = rt_hw_cycle_get() - start;
+
+        /* bucket is the position of highest bit above the shift */
+        for (cycles = wait >> (RT_IPC_STATS_HIST_SHIFT + 1); cycles != 0; cycles >>= 1)
+            index ++;
+        if (index >= RT_IPC_STATS_HIST_NR)
+            index = RT_IPC_STATS_HIST_NR - 1;
+    }
+
+    temp = rt_hw_interrupt_disable();
+
+    if (error == RT_EOK)
+        ipc->stats.take ++;
+
+    if (blocked == RT_TRUE)
+    {
+        ipc->stats.contended ++;
+        if (error != RT_EOK)
+            ipc->stats.timeout ++;
+
+        ipc->stats.wait_total += wait;
+        if (wait > ipc->stats.wait_max)
+            ipc->stats.wait_max = wait;
+        ipc->stats.wait_hist[index] ++;
+    }
+
+    rt_hw_interrupt_enable(temp);
+}
+
+/**
+ * This function will clear the statistics of an IPC object.
+ *
+ * @param ipc the IPC object
+ */
+void rt_ipc_stats_reset(struct rt_ipc_object *ipc)
+{
+    register rt_base_t temp;
+    rt_uint32_t hold_start;
+
+    RT_ASSERT(ipc != RT_NULL);
+
+    temp = rt_hw_interrupt_disable();
+
+    /* a mutex may be held right now, keep the time it was taken */
+    hold_start = ipc->stats.hold_start;
+    rt_memset(&(ipc->stats), 0, sizeof(ipc->stats));
+    ipc->stats.hold_start = hold_start;
+
+    rt_hw_interrupt_enable(temp);
+}
+RTM_EXPORT(rt_ipc_stats_reset);
+#endif
+
 #ifdef RT_USING_SEMAPHORE
 /**
  * This function will initialize a semaphore and put it under control of
@@ -323,6 +402,10 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
 {
     register rt_base_t temp;
     struct rt_thread *thread;
+#ifdef RT_USING_IPC_STATS
+    rt_bool_t blocked = RT_FALSE;
+    rt_uint32_t wait_start = 0;
+#endif
 
     /* parameter check */
     RT_ASSERT(sem != RT_NULL);
@@ -370,6 +453,11 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
             RT_DEBUG_LOG(RT_DEBUG_IPC, ("sem take: suspend thread - %s\n",
                                         thread->name));
 
+#ifdef RT_USING_IPC_STATS
+            blocked    = RT_TRUE;
+            wait_start = rt_hw_cycle_get();
+#endif
+
             /* suspend thread */
             rt_ipc_list_suspend(&(sem->parent.suspend_thread),
                                 thread,
@@ -396,11 +484,18 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
 
             if (thread->error != RT_EOK)
             {
+#ifdef RT_USING_IPC_STATS
+                rt_ipc_stats_take(&(sem->parent), blocked, wait_start, thread->error);
+#endif
                 return thread->error;
             }
         }
     }
 
+#ifdef RT_USING_IPC_STATS
+    rt_ipc_stats_take(&(sem->parent), blocked, wait_start, RT_EOK);
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(sem->parent.parent)));
 
     return RT_EOK;
@@ -653,6 +748,10 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
 {
     register rt_base_t temp;
     struct rt_thread *thread;
+#ifdef RT_USING_IPC_STATS
+    rt_bool_t blocked = RT_FALSE;
+    rt_uint32_t wait_start = 0;
+#endif
 
     /* this function must not be used in interrupt even if time = 0 */
     RT_DEBUG_IN_THREAD_CONTEXT;
@@ -696,6 +795,9 @@ __again:
             mutex->owner             = thread;
             mutex->original_priority = thread->current_priority;
             mutex->hold ++;
+#ifdef RT_USING_IPC_STATS
+            mutex->parent.stats.hold_start = rt_hw_cycle_get();
+#endif
         }
         else
         {
@@ -725,6 +827,14 @@ __again:
                                       &thread->current_priority);
                 }
 
+#ifdef RT_USING_IPC_STATS
+                if (blocked == RT_FALSE)
+                {
+                    blocked    = RT_TRUE;
+                    wait_start = rt_hw_cycle_get();
+                }
+#endif
+
                 /* suspend current thread */
                 rt_ipc_list_suspend(&(mutex->parent.suspend_thread),
                                     thread,
@@ -755,6 +865,9 @@ __again:
                     /* interrupt by signal, try it again */
                     if (thread->error == -RT_EINTR) goto __again;
 
+#ifdef RT_USING_IPC_STATS
+                    rt_ipc_stats_take(&(mutex->parent), blocked, wait_start, thread->error);
+#endif
                     /* return error */
                     return thread->error;
                 }
@@ -771,6 +884,10 @@ __again:
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
 
+#ifdef RT_USING_IPC_STATS
+    rt_ipc_stats_take(&(mutex->parent), blocked, wait_start, RT_EOK);
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mutex->parent.parent)));
 
     return RT_EOK;
@@ -828,6 +945,17 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
     /* if no hold */
     if (mutex->hold == 0)
     {
+#ifdef RT_USING_IPC_STATS
+        {
+            rt_uint32_t now = rt_hw_cycle_get();
+
+            if (now - mutex->parent.stats.hold_start > mutex->parent.stats.hold_max)
+                mutex->parent.stats.hold_max = now - mutex->parent.stats.hold_start;
+            /* the next owner holds it from now on */
+            mutex->parent.stats.hold_start = now;
+        }
+#endif
+
         /* change the owner thread to original priority */
         if (mutex->original_priority != mutex->owner->current_priority)
         {
@@ -1375,7 +1503,7 @@ rt_mailbox_t rt_mb_create(const char *name, rt_size_t size, rt_uint8_t flag)
 
     /* init mailbox */
     mb->size     = size;
-    mb->msg_pool = RT_KERNEL_MALLOC(mb->size * sizeof(rt_uint32_t));
+    mb->msg_pool = RT_KERNEL_BUF_MALLOC(mb->size * sizeof(rt_uint32_t));
     if (mb->msg_pool == RT_NULL)
     {
         /* delete mailbox object */
@@ -1417,7 +1545,7 @@ rt_err_t rt_mb_delete(rt_mailbox_t mb)
     rt_ipc_list_resume_all(&(mb->suspend_sender_thread));
 
     /* free mailbox pool */
-    RT_KERNEL_FREE(mb->msg_pool);
+    RT_KERNEL_BUF_FREE(mb->msg_pool, mb->size * sizeof(rt_uint32_t));
 
     /* delete mailbox object */
     rt_object_delete(&(mb->parent.parent));
@@ -1590,6 +1718,10 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
     struct rt_thread *thread;
     register rt_ubase_t temp;
     rt_uint32_t tick_delta;
+#ifdef RT_USING_IPC_STATS
+    rt_bool_t blocked = RT_FALSE;
+    rt_uint32_t wait_start = 0;
+#endif
 
     /* parameter check */
     RT_ASSERT(mb != RT_NULL);
@@ -1626,11 +1758,23 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
             rt_hw_interrupt_enable(temp);
 
             thread->error = -RT_ETIMEOUT;
+#ifdef RT_USING_IPC_STATS
+            /* the wait of an earlier pass ran out of time */
+            rt_ipc_stats_take(&(mb->parent), blocked, wait_start, -RT_ETIMEOUT);
+#endif
 
             return -RT_ETIMEOUT;
         }
 
         RT_DEBUG_IN_THREAD_CONTEXT;
+#ifdef RT_USING_IPC_STATS
+        if (blocked == RT_FALSE)
+        {
+            blocked    = RT_TRUE;
+            wait_start = rt_hw_cycle_get();
+        }
+#endif
+
         /* suspend current thread */
         rt_ipc_list_suspend(&(mb->parent.suspend_thread),
                             thread,
@@ -1661,6 +1805,9 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
         /* resume from suspend state */
         if (thread->error != RT_EOK)
         {
+#ifdef RT_USING_IPC_STATS
+            rt_ipc_stats_take(&(mb->parent), blocked, wait_start, thread->error);
+#endif
             /* return error */
             return thread->error;
         }
@@ -1688,6 +1835,10 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_uint32_t *value, rt_int32_t timeout)
     /* decrease message entry */
     mb->entry --;
 
+#ifdef RT_USING_IPC_STATS
+    rt_ipc_stats_take(&(mb->parent), blocked, wait_start, RT_EOK);
+#endif
+
     /* resume suspended thread */
     if (!rt_list_isempty(&(mb->suspend_sender_thread)))
     {
@@ -1890,7 +2041,7 @@ rt_mq_t rt_mq_create(const char *name,
     mq->max_msgs = max_msgs;
 
     /* allocate message pool */
-    mq->msg_pool = RT_KERNEL_MALLOC((mq->msg_size + sizeof(struct rt_mq_message)) * mq->max_msgs);
+    mq->msg_pool = RT_KERNEL_BUF_MALLOC((mq->msg_size + sizeof(struct rt_mq_message)) * mq->max_msgs);
     if (mq->msg_pool == RT_NULL)
     {
         rt_mq_delete(mq);
@@ -1939,7 +2090,7 @@ rt_err_t rt_mq_delete(rt_mq_t mq)
     rt_ipc_list_resume_all(&(mq->parent.suspend_thread));
 
     /* free message queue pool */
-    RT_KERNEL_FREE(mq->msg_pool);
+    RT_KERNEL_BUF_FREE(mq->msg_pool, (mq->msg_size + sizeof(struct rt_mq_message)) * mq->max_msgs);
 
     /* delete message queue object */
     rt_object_delete(&(mq->parent.parent));
@@ -2143,6 +2294,10 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     register rt_ubase_t temp;
     struct rt_mq_message *msg;
     rt_uint32_t tick_delta;
+#ifdef RT_USING_IPC_STATS
+    rt_bool_t blocked = RT_FALSE;
+    rt_uint32_t wait_start = 0;
+#endif
 
     /* parameter check */
     RT_ASSERT(mq != RT_NULL);
@@ -2182,10 +2337,22 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
             rt_hw_interrupt_enable(temp);
 
             thread->error = -RT_ETIMEOUT;
+#ifdef RT_USING_IPC_STATS
+            /* the wait of an earlier pass ran out of time */
+            rt_ipc_stats_take(&(mq->parent), blocked, wait_start, -RT_ETIMEOUT);
+#endif
 
             return -RT_ETIMEOUT;
         }
 
+#ifdef RT_USING_IPC_STATS
+        if (blocked == RT_FALSE)
+        {
+            blocked    = RT_TRUE;
+            wait_start = rt_hw_cycle_get();
+        }
+#endif
+
         /* suspend current thread */
         rt_ipc_list_suspend(&(mq->parent.suspend_thread),
                             thread,
@@ -2216,6 +2383,9 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
         /* recv message */
         if (thread->error != RT_EOK)
         {
+#ifdef RT_USING_IPC_STATS
+            rt_ipc_stats_take(&(mq->parent), blocked, wait_start, thread->error);
+#endif
             /* return error */
             return thread->error;
         }
@@ -2248,6 +2418,10 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
 
+#ifdef RT_USING_IPC_STATS
+    rt_ipc_stats_take(&(mq->parent), blocked, wait_start, RT_EOK);
+#endif
+
     /* copy message */
     rt_memcpy(buffer, msg + 1, size > mq->msg_size ? mq->msg_size : size);
 
@@ -2325,4 +2499,497 @@ rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
 RTM_EXPORT(rt_mq_control);
 #endif /* end of RT_USING_MESSAGEQUEUE */
 
+#ifdef RT_USING_TOPIC
+/**
+ * This function will initialize a topic and put it under control of resource
+ * management. A topic holds only the latest sample, subscribers read it in
+ * place through their own generation cursor.
+ *
+ * @param topic the topic object
+ * @param name the name of topic
+ * @param buffer the buffer to save one sample
+ * @param size the size of one sample
+ * @param flag the flag of topic
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_topic_init(rt_topic_t  topic,
+                       const char *name,
+                       void       *buffer,
+                       rt_size_t   size,
+                       rt_uint8_t  flag)
+{
+    /* parameter check */
+    RT_ASSERT(topic != RT_NULL);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size > 0 && size <= 0xFFFF);
+
+    /* init object */
+    rt_object_init(&(topic->parent.parent), RT_Object_Class_Topic, name);
+
+    /* set parent flag */
+    topic->parent.parent.flag = flag;
+
+    /* init ipc object */
+    rt_ipc_object_init(&(topic->parent));
+
+    /* init sample buffer */
+    topic->buffer     = buffer;
+    topic->size       = size;
+    topic->generation = 0;
+    topic->timestamp  = 0;
+
+    /* init subscriber list */
+    rt_list_init(&(topic->sub_list));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_init);
+
+/* unlink all subscribers, they are left detached with topic RT_NULL */
+static void rt_topic_drop_subs(rt_topic_t topic)
+{
+    register rt_ubase_t temp;
+    struct rt_topic_sub *sub;
+
+    /* lock scheduler, publisher may be walking the subscriber list */
+    rt_enter_critical();
+
+    temp = rt_hw_interrupt_disable();
+    while (!rt_list_isempty(&(topic->sub_list)))
+    {
+        sub = rt_list_entry(topic->sub_list.next, struct rt_topic_sub, list);
+        rt_list_remove(&(sub->list));
+        sub->topic = RT_NULL;
+    }
+    rt_hw_interrupt_enable(temp);
+
+    rt_exit_critical();
+}
+
+/**
+ * This function will detach a topic object from resource management, all
+ * threads waiting on it will be waked up with -RT_ERROR, and all subscribers
+ * are left detached.
+ *
+ * @param topic the topic object
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_topic_detach(rt_topic_t topic)
+{
+    /* parameter check */
+    RT_ASSERT(topic != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&topic->parent.parent) == RT_Object_Class_Topic);
+    RT_ASSERT(rt_object_is_systemobject(&topic->parent.parent));
+
+    /* resume all suspended thread */
+    rt_ipc_list_resume_all(&(topic->parent.suspend_thread));
+
+    rt_topic_drop_subs(topic);
+
+    /* detach topic object */
+    rt_object_detach(&(topic->parent.parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_detach);
+
+#ifdef RT_USING_HEAP
+/**
+ * This function will create a topic object from system resource
+ *
+ * @param name the name of topic
+ * @param size the size of one sample
+ * @param flag the flag of topic
+ *
+ * @return the created topic, RT_NULL on error happen
+ */
+rt_topic_t rt_topic_create(const char *name, rt_size_t size, rt_uint8_t flag)
+{
+    rt_topic_t topic;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+    RT_ASSERT(size > 0 && size <= 0xFFFF);
+
+    /* allocate object */
+    topic = (rt_topic_t)rt_object_allocate(RT_Object_Class_Topic, name);
+    if (topic == RT_NULL)
+        return topic;
+
+    /* set parent */
+    topic->parent.parent.flag = flag;
+
+    /* init ipc object */
+    rt_ipc_object_init(&(topic->parent));
+
+    /* allocate sample buffer */
+    topic->size   = size;
+    topic->buffer = RT_KERNEL_BUF_MALLOC(RT_ALIGN(size, RT_ALIGN_SIZE));
+    if (topic->buffer == RT_NULL)
+    {
+        rt_object_delete(&(topic->parent.parent));
+
+        return RT_NULL;
+    }
+
+    topic->generation = 0;
+    topic->timestamp  = 0;
+    rt_list_init(&(topic->sub_list));
+
+    return topic;
+}
+RTM_EXPORT(rt_topic_create);
+
+/**
+ * This function will delete a topic object and release the memory, all
+ * subscribers are left detached.
+ *
+ * @param topic the topic object
+ *
+ * @return the error code
+ */
+rt_err_t rt_topic_delete(rt_topic_t topic)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* parameter check */
+    RT_ASSERT(topic != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&topic->parent.parent) == RT_Object_Class_Topic);
+    RT_ASSERT(rt_object_is_systemobject(&topic->parent.parent) == RT_FALSE);
+
+    /* resume all suspended thread */
+    rt_ipc_list_resume_all(&(topic->parent.suspend_thread));
+
+    rt_topic_drop_subs(topic);
+
+    /* free sample buffer */
+    RT_KERNEL_BUF_FREE(topic->buffer, RT_ALIGN(topic->size, RT_ALIGN_SIZE));
+
+    /* delete topic object */
+    rt_object_delete(&(topic->parent.parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_delete);
+#endif
+
+/**
+ * This function will publish a sample to a topic. The sample is copied once
+ * into the topic buffer, then every waiting subscriber is waked up and every
+ * notify callback is invoked in the context of publisher.
+ *
+ * @note the copy is done with interrupt disabled, so a sample shall be small
+ * (a few words), and it's safe to publish from ISR.
+ *
+ * @note a callback may unsubscribe its own subscriber, but no other one.
+ *
+ * @param topic the topic object
+ * @param sample the sample, size of it shall be the size of topic
+ *
+ * @return the error code
+ */
+rt_err_t rt_topic_publish(rt_topic_t topic, const void *sample)
+{
+    register rt_ubase_t temp;
+    register rt_bool_t need_schedule;
+    struct rt_list_node *node, *next;
+    struct rt_topic_sub *sub;
+
+    /* parameter check */
+    RT_ASSERT(topic != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&topic->parent.parent) == RT_Object_Class_Topic);
+    RT_ASSERT(sample != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(topic->parent.parent)));
+
+    need_schedule = RT_FALSE;
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    /* the only copy of this sample */
+    rt_memcpy(topic->buffer, sample, topic->size);
+    topic->generation ++;
+    /* generation 0 is reserved for never published */
+    if (topic->generation == 0)
+        topic->generation = 1;
+    topic->timestamp = rt_tick_get();
+
+    /* wake up all waiting subscribers, they keep RT_EOK as error */
+    while (!rt_list_isempty(&(topic->parent.suspend_thread)))
+    {
+        rt_ipc_list_resume(&(topic->parent.suspend_thread));
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    /* lock scheduler, other subscribers can't leave while walking the list */
+    rt_enter_critical();
+    for (node = topic->sub_list.next; node != &(topic->sub_list); node = next)
+    {
+        /* the callback may unsubscribe itself */
+        next = node->next;
+        sub  = rt_list_entry(node, struct rt_topic_sub, list);
+        if (sub->notify != RT_NULL)
+            sub->notify(sub, sub->parameter);
+    }
+    rt_exit_critical();
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_publish);
+
+/**
+ * This function will subscribe a topic. The subscriber starts at the current
+ * generation, so only samples published later are reported as updated.
+ *
+ * @param topic the topic object
+ * @param sub the subscriber, provided by caller
+ * @param notify the callback invoked on each publish, RT_NULL for none
+ * @param parameter the parameter of callback
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_topic_subscribe(rt_topic_t     topic,
+                            rt_topic_sub_t sub,
+                            void (*notify)(rt_topic_sub_t sub, void *parameter),
+                            void          *parameter)
+{
+    register rt_ubase_t temp;
+
+    /* parameter check */
+    RT_ASSERT(topic != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&topic->parent.parent) == RT_Object_Class_Topic);
+    RT_ASSERT(sub != RT_NULL);
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    sub->topic     = topic;
+    sub->notify    = notify;
+    sub->parameter = parameter;
+    rt_list_init(&(sub->list));
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    sub->generation = topic->generation;
+    rt_list_insert_before(&(topic->sub_list), &(sub->list));
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_subscribe);
+
+/**
+ * This function will unsubscribe a topic. A subscriber detached by deleting
+ * its topic needs no unsubscribe, but it's harmless.
+ *
+ * @param sub the subscriber
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_topic_unsubscribe(rt_topic_sub_t sub)
+{
+    register rt_ubase_t temp;
+
+    /* parameter check */
+    RT_ASSERT(sub != RT_NULL);
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* lock scheduler, publisher may be walking the subscriber list */
+    rt_enter_critical();
+
+    temp = rt_hw_interrupt_disable();
+    if (sub->topic != RT_NULL)
+    {
+        rt_list_remove(&(sub->list));
+        sub->topic = RT_NULL;
+    }
+    rt_hw_interrupt_enable(temp);
+
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_unsubscribe);
+
+/**
+ * This function will check whether there is a sample not read yet by the
+ * subscriber.
+ *
+ * @param sub the subscriber
+ *
+ * @return RT_TRUE if updated, RT_FALSE if not or the subscriber is detached
+ */
+rt_bool_t rt_topic_updated(rt_topic_sub_t sub)
+{
+    register rt_ubase_t temp;
+    rt_bool_t updated = RT_FALSE;
+
+    /* parameter check */
+    RT_ASSERT(sub != RT_NULL);
+
+    temp = rt_hw_interrupt_disable();
+    if (sub->topic != RT_NULL && sub->topic->generation != sub->generation)
+        updated = RT_TRUE;
+    rt_hw_interrupt_enable(temp);
+
+    return updated;
+}
+RTM_EXPORT(rt_topic_updated);
+
+/**
+ * This function will wait until there is a sample not read yet by the
+ * subscriber.
+ *
+ * @param sub the subscriber
+ * @param timeout the waiting time
+ *
+ * @return the error code, RT_EOK if updated, -RT_ETIMEOUT on timeout,
+ *         -RT_ERROR if the subscriber is detached
+ */
+rt_err_t rt_topic_wait(rt_topic_sub_t sub, rt_int32_t timeout)
+{
+    register rt_base_t temp;
+    struct rt_thread *thread;
+    rt_topic_t topic;
+
+    /* parameter check */
+    RT_ASSERT(sub != RT_NULL);
+
+    topic = sub->topic;
+    if (topic == RT_NULL)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(topic->parent.parent)));
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    /* the topic may have gone in the hook */
+    if (sub->topic == RT_NULL)
+    {
+        rt_hw_interrupt_enable(temp);
+
+        return -RT_ERROR;
+    }
+
+    if (topic->generation != sub->generation)
+    {
+        /* enable interrupt */
+        rt_hw_interrupt_enable(temp);
+    }
+    else
+    {
+        /* no waiting, return with timeout */
+        if (timeout == 0)
+        {
+            rt_hw_interrupt_enable(temp);
+
+            return -RT_ETIMEOUT;
+        }
+
+        /* current context checking */
+        RT_DEBUG_IN_THREAD_CONTEXT;
+
+        /* get current thread */
+        thread = rt_thread_self();
+
+        /* reset thread error number */
+        thread->error = RT_EOK;
+
+        RT_DEBUG_LOG(RT_DEBUG_IPC, ("topic wait: suspend thread - %s\n",
+                                    thread->name));
+
+        /* suspend thread */
+        rt_ipc_list_suspend(&(topic->parent.suspend_thread),
+                            thread,
+                            topic->parent.parent.flag);
+
+        /* has waiting time, start thread timer */
+        if (timeout > 0)
+        {
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(temp);
+
+        /* do schedule */
+        rt_schedule();
+
+        if (thread->error != RT_EOK)
+        {
+            return thread->error;
+        }
+    }
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(topic->parent.parent)));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_wait);
+
+/**
+ * This function will copy the latest sample of topic out and move the cursor
+ * of subscriber to it. Samples published in between are skipped, only the
+ * latest one is kept by a topic.
+ *
+ * @param sub the subscriber
+ * @param sample the buffer to save sample, size of it shall be the size of topic
+ *
+ * @return the error code, -RT_EEMPTY if nothing has been published, -RT_ERROR
+ *         if the subscriber is detached
+ */
+rt_err_t rt_topic_read(rt_topic_sub_t sub, void *sample)
+{
+    register rt_ubase_t temp;
+    rt_topic_t topic;
+
+    /* parameter check */
+    RT_ASSERT(sub != RT_NULL);
+    RT_ASSERT(sample != RT_NULL);
+
+    /* disable interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    topic = sub->topic;
+    if (topic == RT_NULL)
+    {
+        rt_hw_interrupt_enable(temp);
+
+        return -RT_ERROR;
+    }
+
+    if (topic->generation == 0)
+    {
+        rt_hw_interrupt_enable(temp);
+
+        return -RT_EEMPTY;
+    }
+
+    rt_memcpy(sample, topic->buffer, topic->size);
+    sub->generation = topic->generation;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_topic_read);
+#endif /* end of RT_USING_TOPIC */
+
 /**@}*/
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Interrupt-safe small block allocator.
+ *
+ * A few size classes of fixed blocks, each kept on a LIFO free list. Pop and
+ * push never block and never take a semaphore, so rt_isr_malloc/rt_isr_free
+ * can be called from ISR. The lists are refilled from (and trimmed back to)
+ * the system heap by a worker thread, which is woken up when a list falls
+ * below its low water mark or grows beyond twice its target.
+ *
+ * Like rt_mempool, the word in front of each block holds the next free block
+ * while it's free, and the owner size class while it's allocated.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef __riscv_atomic
+#include "riscv-ops.h"
+#endif
+
+#if defined (RT_USING_HEAP) && defined (RT_USING_ISR_MEM)
+
+/* free blocks kept in each size class */
+#ifndef RT_ISR_MEM_BLOCKS
+#define RT_ISR_MEM_BLOCKS               4
+#endif
+
+#ifndef RT_ISR_MEM_THREAD_PRIO
+#define RT_ISR_MEM_THREAD_PRIO          2
+#endif
+
+#ifndef RT_ISR_MEM_THREAD_STACK_SIZE
+#define RT_ISR_MEM_THREAD_STACK_SIZE    512
+#endif
+
+#define ISR_MEM_LOW_WATER               (RT_ISR_MEM_BLOCKS / 2)
+#define ISR_MEM_HIGH_WATER              (RT_ISR_MEM_BLOCKS * 2)
+
+/* prefix of each block */
+struct isr_mem_block
+{
+    void *link;                         /* next free block, or owner class */
+};
+
+struct isr_mem_class
+{
+    rt_size_t size;                     /* size of user data */
+
+    struct isr_mem_block *volatile free_list;
+    volatile rt_base_t free_count;
+
+    rt_base_t min_free;                 /* low water mark ever seen */
+    rt_uint32_t miss;                   /* allocations failed on empty list */
+};
+
+static struct isr_mem_class isr_mem_class[] =
+{
+    {16}, {32}, {64}, {128}, {256}
+};
+#define ISR_MEM_CLASS_NR    (sizeof(isr_mem_class) / sizeof(isr_mem_class[0]))
+
+static struct rt_semaphore isr_mem_sem;
+static volatile rt_base_t isr_mem_pending;
+
+static struct rt_thread isr_mem_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t isr_mem_thread_stack[RT_ISR_MEM_THREAD_STACK_SIZE];
+
+/*
+ * A pop reads the next block out of the head before replacing it, so a
+ * compare and swap alone can't tell whether the head block has been popped
+ * and pushed back in between (ABA), and the lists hold heap pointers with no
+ * room for a version. Pop therefore takes a few instructions with interrupt
+ * disabled. Push is not hurt by ABA: with the atomic extension it links the
+ * block to the head it saw and swaps the head in, retrying if it changed.
+ */
+rt_inline struct isr_mem_block *isr_mem_pop(struct isr_mem_class *class)
+{
+    struct isr_mem_block *block;
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    block = class->free_list;
+    if (block != RT_NULL)
+    {
+        class->free_list = (struct isr_mem_block *)block->link;
+        class->free_count --;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return block;
+}
+
+rt_inline void isr_mem_push(struct isr_mem_class *class, struct isr_mem_block *block)
+{
+#ifdef __riscv_atomic
+    struct isr_mem_block *head;
+
+    do
+    {
+        head = class->free_list;
+        block->link = head;
+    } while (atomic_cas_w(&class->free_list, (unsigned long)head, (unsigned long)block) !=
+             (unsigned long)head);
+
+    atomic_add_w(&class->free_count, 1);
+#else
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    block->link = class->free_list;
+    class->free_list = block;
+    class->free_count ++;
+    rt_hw_interrupt_enable(level);
+#endif
+}
+
+/* wake up the worker once, until it starts a new round */
+rt_inline void isr_mem_kick(void)
+{
+    register rt_base_t level;
+    rt_bool_t kick = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (!isr_mem_pending)
+    {
+        isr_mem_pending = 1;
+        kick = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (kick == RT_TRUE)
+        rt_sem_release(&isr_mem_sem);
+}
+
+/* bring every class back between the low and high water marks */
+static void isr_mem_balance(void)
+{
+    struct isr_mem_class *class;
+    struct isr_mem_block *block;
+    rt_size_t index;
+
+    for (index = 0; index < ISR_MEM_CLASS_NR; index ++)
+    {
+        class = &isr_mem_class[index];
+
+        while (class->free_count < RT_ISR_MEM_BLOCKS)
+        {
+            block = (struct isr_mem_block *)rt_malloc(sizeof(struct isr_mem_block) + class->size);
+            if (block == RT_NULL)
+                break;
+
+            isr_mem_push(class, block);
+        }
+
+        if (class->free_count <= ISR_MEM_HIGH_WATER)
+            continue;
+
+        while (class->free_count > RT_ISR_MEM_BLOCKS)
+        {
+            block = isr_mem_pop(class);
+            if (block == RT_NULL)
+                break;
+
+            rt_free(block);
+        }
+    }
+}
+
+static void isr_mem_thread_entry(void *parameter)
+{
+    while (1)
+    {
+        rt_sem_take(&isr_mem_sem, RT_WAITING_FOREVER);
+
+        /* requests from now on need another round */
+        isr_mem_pending = 0;
+
+        isr_mem_balance();
+    }
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will allocate a small block, it never blocks and can be
+ * invoked in ISR.
+ *
+ * @param size the size of memory to be allocated
+ *
+ * @return the allocated memory, RT_NULL if the size is too large or the
+ *         size class is exhausted at the moment
+ */
+void *rt_isr_malloc(rt_size_t size)
+{
+    struct isr_mem_class *class;
+    struct isr_mem_block *block;
+    rt_size_t index;
+
+    for (index = 0; index < ISR_MEM_CLASS_NR; index ++)
+    {
+        if (size <= isr_mem_class[index].size)
+            break;
+    }
+    if (index == ISR_MEM_CLASS_NR)
+        return RT_NULL;
+
+    class = &isr_mem_class[index];
+
+    block = isr_mem_pop(class);
+    if (block == RT_NULL)
+    {
+        class->miss ++;
+        isr_mem_kick();
+
+        return RT_NULL;
+    }
+
+    if (class->free_count < class->min_free)
+        class->min_free = class->free_count;
+    if (class->free_count < ISR_MEM_LOW_WATER)
+        isr_mem_kick();
+
+    /* remember the owner class */
+    block->link = class;
+
+    return (void *)(block + 1);
+}
+RTM_EXPORT(rt_isr_malloc);
+
+/**
+ * This function will release a block allocated by rt_isr_malloc, it never
+ * blocks and can be invoked in ISR.
+ *
+ * @param ptr the memory to be released
+ */
+void rt_isr_free(void *ptr)
+{
+    struct isr_mem_class *class;
+    struct isr_mem_block *block;
+
+    if (ptr == RT_NULL)
+        return;
+
+    block = (struct isr_mem_block *)ptr - 1;
+    class = (struct isr_mem_class *)block->link;
+
+    RT_ASSERT(class >= &isr_mem_class[0] &&
+              class < &isr_mem_class[ISR_MEM_CLASS_NR]);
+
+    isr_mem_push(class, block);
+
+    if (class->free_count > ISR_MEM_HIGH_WATER)
+        isr_mem_kick();
+}
+RTM_EXPORT(rt_isr_free);
+
+/**@}*/
+
+/**
+ * This function will fill all size classes and start the refill thread.
+ */
+int rt_isr_mem_init(void)
+{
+    rt_size_t index;
+
+    for (index = 0; index < ISR_MEM_CLASS_NR; index ++)
+    {
+        isr_mem_class[index].size       = RT_ALIGN(isr_mem_class[index].size, RT_ALIGN_SIZE);
+        isr_mem_class[index].free_list  = RT_NULL;
+        isr_mem_class[index].free_count = 0;
+        isr_mem_class[index].min_free   = RT_ISR_MEM_BLOCKS;
+        isr_mem_class[index].miss       = 0;
+    }
+
+    rt_sem_init(&isr_mem_sem, "isrmem", 0, RT_IPC_FLAG_FIFO);
+    isr_mem_pending = 0;
+
+    /* initial fill in the context of caller */
+    isr_mem_balance();
+
+    rt_thread_init(&isr_mem_thread,
+                   "isrmem",
+                   isr_mem_thread_entry,
+                   RT_NULL,
+                   &isr_mem_thread_stack[0],
+                   sizeof(isr_mem_thread_stack),
+                   RT_ISR_MEM_THREAD_PRIO,
+                   10);
+    rt_thread_startup(&isr_mem_thread);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(rt_isr_mem_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_isr_mem(void)
+{
+    rt_size_t index;
+
+    rt_kprintf("size free min  miss\n");
+    rt_kprintf("---- ---- ---- ----------\n");
+    for (index = 0; index < ISR_MEM_CLASS_NR; index ++)
+    {
+        rt_kprintf("%04d %04d %04d %010d\n",
+                   isr_mem_class[index].size,
+                   isr_mem_class[index].free_count,
+                   isr_mem_class[index].min_free,
+                   isr_mem_class[index].miss);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_isr_mem, list interrupt-safe allocator usage information);
+MSH_CMD_EXPORT(list_isr_mem, list interrupt-safe allocator usage information);
+#endif
+
+#endif /* end of RT_USING_HEAP && RT_USING_ISR_MEM */
@@ -115,6 +115,181 @@ int *_rt_errno(void)
 }
 RTM_EXPORT(_rt_errno);
 
+#ifndef RT_USING_TINY_SIZE
+/*
+ * Word at a time helpers of rt_memset, rt_memcpy, rt_memmove and rt_memcmp.
+ *
+ * The destination is aligned first. When the source is still misaligned, each
+ * word is merged from two aligned source words shifted by the source offset,
+ * so there is neither a byte loop nor a misaligned access, which traps or is
+ * emulated on RV32. Only aligned words holding some bytes of the source are
+ * read.
+ *
+ * The aligned loops move eight words per iteration, loaded back to back to
+ * hide the load latency of SweRV. Eight words plus pointers and count fit in
+ * the caller-saved registers of RV32, so the loops never spill to the stack.
+ */
+#define KS_WORD                 (sizeof(rt_ubase_t))
+#define KS_MASK                 (KS_WORD - 1)
+#define KS_BITS                 (KS_WORD * 8)
+#define KS_TOO_SMALL(LEN)       ((LEN) < (KS_WORD << 2))
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define KS_MERGE(lo, hi, shift) (((lo) << (shift)) | ((hi) >> (KS_BITS - (shift))))
+#else
+#define KS_MERGE(lo, hi, shift) (((lo) >> (shift)) | ((hi) << (KS_BITS - (shift))))
+#endif
+
+/* copy from the first byte up, safe for overlapped area with dst below src */
+static void ks_copy_forward(rt_uint8_t *dst, const rt_uint8_t *src, rt_ubase_t count)
+{
+    rt_ubase_t *dw;
+    const rt_ubase_t *sw;
+    rt_ubase_t w0, w1, w2, w3, w4, w5, w6, w7;
+    rt_ubase_t lo, shift;
+
+    if (!KS_TOO_SMALL(count))
+    {
+        while ((rt_ubase_t)dst & KS_MASK)
+        {
+            *dst++ = *src++;
+            count--;
+        }
+
+        dw = (rt_ubase_t *)dst;
+        shift = ((rt_ubase_t)src & KS_MASK) * 8;
+        if (shift == 0)
+        {
+            sw = (const rt_ubase_t *)src;
+            while (count >= KS_WORD * 8)
+            {
+                w0 = sw[0]; w1 = sw[1]; w2 = sw[2]; w3 = sw[3];
+                w4 = sw[4]; w5 = sw[5]; w6 = sw[6]; w7 = sw[7];
+                dw[0] = w0; dw[1] = w1; dw[2] = w2; dw[3] = w3;
+                dw[4] = w4; dw[5] = w5; dw[6] = w6; dw[7] = w7;
+                sw += 8;
+                dw += 8;
+                count -= KS_WORD * 8;
+            }
+
+            while (count >= KS_WORD)
+            {
+                *dw++ = *sw++;
+                count -= KS_WORD;
+            }
+            src = (const rt_uint8_t *)sw;
+        }
+        else
+        {
+            /* lo holds the source bytes not stored yet */
+            sw = (const rt_ubase_t *)(src - shift / 8);
+            lo = *sw++;
+            while (count >= KS_WORD * 4)
+            {
+                w0 = sw[0]; w1 = sw[1]; w2 = sw[2]; w3 = sw[3];
+                dw[0] = KS_MERGE(lo, w0, shift);
+                dw[1] = KS_MERGE(w0, w1, shift);
+                dw[2] = KS_MERGE(w1, w2, shift);
+                dw[3] = KS_MERGE(w2, w3, shift);
+                lo = w3;
+                sw += 4;
+                dw += 4;
+                count -= KS_WORD * 4;
+            }
+
+            while (count >= KS_WORD)
+            {
+                w0 = *sw++;
+                *dw++ = KS_MERGE(lo, w0, shift);
+                lo = w0;
+                count -= KS_WORD;
+            }
+            src = (const rt_uint8_t *)sw - KS_WORD + shift / 8;
+        }
+        dst = (rt_uint8_t *)dw;
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+
+/* copy from the last byte down, safe for overlapped area with dst above src */
+static void ks_copy_backward(rt_uint8_t *dst, const rt_uint8_t *src, rt_ubase_t count)
+{
+    rt_ubase_t *dw;
+    const rt_ubase_t *sw;
+    rt_ubase_t w0, w1, w2, w3, w4, w5, w6, w7;
+    rt_ubase_t hi, shift;
+
+    dst += count;
+    src += count;
+
+    if (!KS_TOO_SMALL(count))
+    {
+        while ((rt_ubase_t)dst & KS_MASK)
+        {
+            *--dst = *--src;
+            count--;
+        }
+
+        dw = (rt_ubase_t *)dst;
+        shift = ((rt_ubase_t)src & KS_MASK) * 8;
+        if (shift == 0)
+        {
+            sw = (const rt_ubase_t *)src;
+            while (count >= KS_WORD * 8)
+            {
+                sw -= 8;
+                dw -= 8;
+                w7 = sw[7]; w6 = sw[6]; w5 = sw[5]; w4 = sw[4];
+                w3 = sw[3]; w2 = sw[2]; w1 = sw[1]; w0 = sw[0];
+                dw[7] = w7; dw[6] = w6; dw[5] = w5; dw[4] = w4;
+                dw[3] = w3; dw[2] = w2; dw[1] = w1; dw[0] = w0;
+                count -= KS_WORD * 8;
+            }
+
+            while (count >= KS_WORD)
+            {
+                *--dw = *--sw;
+                count -= KS_WORD;
+            }
+            src = (const rt_uint8_t *)sw;
+        }
+        else
+        {
+            /* hi holds the source bytes not stored yet */
+            sw = (const rt_ubase_t *)(src - shift / 8);
+            hi = *sw;
+            while (count >= KS_WORD * 4)
+            {
+                sw -= 4;
+                dw -= 4;
+                w3 = sw[3]; w2 = sw[2]; w1 = sw[1]; w0 = sw[0];
+                dw[3] = KS_MERGE(w3, hi, shift);
+                dw[2] = KS_MERGE(w2, w3, shift);
+                dw[1] = KS_MERGE(w1, w2, shift);
+                dw[0] = KS_MERGE(w0, w1, shift);
+                hi = w0;
+                count -= KS_WORD * 4;
+            }
+
+            while (count >= KS_WORD)
+            {
+                w0 = *--sw;
+                *--dw = KS_MERGE(w0, hi, shift);
+                hi = w0;
+                count -= KS_WORD;
+            }
+            src = (const rt_uint8_t *)sw + shift / 8;
+        }
+        dst = (rt_uint8_t *)dw;
+    }
+
+    while (count--)
+        *--dst = *--src;
+}
+#endif
+
 /**
  * This function will set the content of memory to specified value
  *
@@ -134,66 +309,47 @@ void *rt_memset(void *s, int c, rt_ubase_t count)
 
     return s;
 #else
-#define LBLOCKSIZE (sizeof(long))
-#define UNALIGNED(X) ((long)X & (LBLOCKSIZE - 1))
-#define TOO_SMALL(LEN) ((LEN) < LBLOCKSIZE)
-
-    unsigned int i;
-    char *m = (char *)s;
-    unsigned long buffer;
-    unsigned long *aligned_addr;
-    unsigned int d = c & 0xff; /* To avoid sign extension, copy C to an
-                               unsigned variable.  */
-
-    if (!TOO_SMALL(count) && !UNALIGNED(s))
-    {
-        /* If we get this far, we know that n is large and m is word-aligned. */
-        aligned_addr = (unsigned long *)s;
+    rt_uint8_t *m = (rt_uint8_t *)s;
+    rt_uint8_t d = (rt_uint8_t)c;
+    rt_ubase_t buffer;
+    rt_ubase_t *aligned_addr;
 
-        /* Store D into each char sized location in BUFFER so that
-         * we can set large blocks quickly.
-         */
-        if (LBLOCKSIZE == 4)
-        {
-            buffer = (d << 8) | d;
-            buffer |= (buffer << 16);
-        }
-        else
+    if (!KS_TOO_SMALL(count))
+    {
+        while ((rt_ubase_t)m & KS_MASK)
         {
-            buffer = 0;
-            for (i = 0; i < LBLOCKSIZE; i++)
-                buffer = (buffer << 8) | d;
+            *m++ = d;
+            count--;
         }
 
-        while (count >= LBLOCKSIZE * 4)
+        /* Store D into each byte of BUFFER so that we can set large blocks quickly. */
+        buffer = (rt_ubase_t)-1 / 0xff * d;
+
+        aligned_addr = (rt_ubase_t *)m;
+        while (count >= KS_WORD * 8)
         {
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            count -= 4 * LBLOCKSIZE;
+            aligned_addr[0] = buffer; aligned_addr[1] = buffer;
+            aligned_addr[2] = buffer; aligned_addr[3] = buffer;
+            aligned_addr[4] = buffer; aligned_addr[5] = buffer;
+            aligned_addr[6] = buffer; aligned_addr[7] = buffer;
+            aligned_addr += 8;
+            count -= KS_WORD * 8;
         }
 
-        while (count >= LBLOCKSIZE)
+        while (count >= KS_WORD)
         {
             *aligned_addr++ = buffer;
-            count -= LBLOCKSIZE;
+            count -= KS_WORD;
         }
 
         /* Pick up the remainder with a bytewise loop. */
-        m = (char *)aligned_addr;
+        m = (rt_uint8_t *)aligned_addr;
     }
 
     while (count--)
-    {
-        *m++ = (char)d;
-    }
+        *m++ = d;
 
     return s;
-
-#undef LBLOCKSIZE
-#undef UNALIGNED
-#undef TOO_SMALL
 #endif
 }
 RTM_EXPORT(rt_memset);
@@ -227,56 +383,9 @@ void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
 
     return dst;
 #else
-
-#define UNALIGNED(X, Y) \
-    (((long)X & (sizeof(long) - 1)) | ((long)Y & (sizeof(long) - 1)))
-#define BIGBLOCKSIZE (sizeof(long) << 2)
-#define LITTLEBLOCKSIZE (sizeof(long))
-#define TOO_SMALL(LEN) ((LEN) < BIGBLOCKSIZE)
-
-    char *dst_ptr = (char *)dst;
-    char *src_ptr = (char *)src;
-    long *aligned_dst;
-    long *aligned_src;
-    int len = count;
-
-    /* If the size is small, or either SRC or DST is unaligned,
-    then punt into the byte copy loop.  This should be rare. */
-    if (!TOO_SMALL(len) && !UNALIGNED(src_ptr, dst_ptr))
-    {
-        aligned_dst = (long *)dst_ptr;
-        aligned_src = (long *)src_ptr;
-
-        /* Copy 4X long words at a time if possible. */
-        while (len >= BIGBLOCKSIZE)
-        {
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            len -= BIGBLOCKSIZE;
-        }
-
-        /* Copy one long word at a time if possible. */
-        while (len >= LITTLEBLOCKSIZE)
-        {
-            *aligned_dst++ = *aligned_src++;
-            len -= LITTLEBLOCKSIZE;
-        }
-
-        /* Pick up any residual with a byte copier. */
-        dst_ptr = (char *)aligned_dst;
-        src_ptr = (char *)aligned_src;
-    }
-
-    while (len--)
-        *dst_ptr++ = *src_ptr++;
+    ks_copy_forward((rt_uint8_t *)dst, (const rt_uint8_t *)src, count);
 
     return dst;
-#undef UNALIGNED
-#undef BIGBLOCKSIZE
-#undef LITTLEBLOCKSIZE
-#undef TOO_SMALL
 #endif
 }
 RTM_EXPORT(rt_memcpy);
@@ -295,6 +404,7 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
 {
     char *tmp = (char *)dest, *s = (char *)src;
 
+#ifdef RT_USING_TINY_SIZE
     if (s < tmp && tmp < s + n)
     {
         tmp += n;
@@ -308,6 +418,12 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
         while (n--)
             *tmp++ = *s++;
     }
+#else
+    if (s < tmp && tmp < s + n)
+        ks_copy_backward((rt_uint8_t *)tmp, (const rt_uint8_t *)s, n);
+    else if (tmp != s)
+        ks_copy_forward((rt_uint8_t *)tmp, (const rt_uint8_t *)s, n);
+#endif
 
     return dest;
 }
@@ -324,10 +440,58 @@ RTM_EXPORT(rt_memmove);
  */
 rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_ubase_t count)
 {
-    const unsigned char *su1, *su2;
+    const unsigned char *su1 = cs, *su2 = ct;
     int res = 0;
+#ifndef RT_USING_TINY_SIZE
+    const rt_ubase_t *w1, *w2;
+    rt_ubase_t lo, hi, shift;
+
+    if (!KS_TOO_SMALL(count))
+    {
+        while ((rt_ubase_t)su1 & KS_MASK)
+        {
+            if ((res = *su1 - *su2) != 0)
+                return res;
+            su1++;
+            su2++;
+            count--;
+        }
+
+        /* stop at the first word differing, the byte loop finds the byte */
+        w1 = (const rt_ubase_t *)su1;
+        shift = ((rt_ubase_t)su2 & KS_MASK) * 8;
+        if (shift == 0)
+        {
+            w2 = (const rt_ubase_t *)su2;
+            while (count >= KS_WORD && *w1 == *w2)
+            {
+                w1++;
+                w2++;
+                count -= KS_WORD;
+            }
+            su2 = (const unsigned char *)w2;
+        }
+        else
+        {
+            w2 = (const rt_ubase_t *)(su2 - shift / 8);
+            lo = *w2++;
+            while (count >= KS_WORD)
+            {
+                hi = *w2;
+                if (*w1 != KS_MERGE(lo, hi, shift))
+                    break;
+                lo = hi;
+                w1++;
+                w2++;
+                count -= KS_WORD;
+            }
+            su2 = (const unsigned char *)w2 - KS_WORD + shift / 8;
+        }
+        su1 = (const unsigned char *)w1;
+    }
+#endif
 
-    for (su1 = cs, su2 = ct; 0 < count; ++su1, ++su2, count--)
+    for (; 0 < count; ++su1, ++su2, count--)
         if ((res = *su1 - *su2) != 0)
             break;
 
@@ -421,6 +585,101 @@ char *rt_strncpy(char *dst, const char *src, rt_ubase_t n)
 }
 RTM_EXPORT(rt_strncpy);
 
+#ifndef RT_USING_TINY_SIZE
+/*
+ * Word at a time helpers of the string routines.
+ *
+ * ks_has_zero tells whether a word holds a null character, with the Zbb
+ * orc.b when the core has it, otherwise by the usual SWAR trick. Like the
+ * memory helpers only aligned words are read, and a word is only read when
+ * the string goes on into it, so a scan never crosses the end of a string
+ * into the next page or region.
+ */
+#define KS_ONES                 ((rt_ubase_t)-1 / 0xff)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define KS_LEAD_FILL(shift)     (~((rt_ubase_t)-1 >> (shift)))
+#else
+#define KS_LEAD_FILL(shift)     (((rt_ubase_t)1 << (shift)) - 1)
+#endif
+
+rt_inline rt_ubase_t ks_has_zero(rt_ubase_t w)
+{
+#ifdef __riscv_zbb
+    rt_ubase_t r;
+
+    __asm__ ("orc.b %0, %1" : "=r"(r) : "r"(w));
+
+    return ~r;
+#else
+    return (w - KS_ONES) & ~w & (KS_ONES << 7);
+#endif
+}
+
+/*
+ * Skip the leading bytes of cs and ct which are equal and not null, at most
+ * count, leaving the rest to the byte loop of the caller. cs is aligned first,
+ * and a misaligned ct is merged from aligned words as in ks_copy_forward.
+ */
+static rt_ubase_t ks_str_skip(const char **cs, const char **ct, rt_ubase_t count)
+{
+    const rt_uint8_t *s1 = (const rt_uint8_t *)*cs;
+    const rt_uint8_t *s2 = (const rt_uint8_t *)*ct;
+    const rt_ubase_t *w1, *w2;
+    rt_ubase_t lo, hi, shift, left = count;
+
+    if (KS_TOO_SMALL(count))
+        return 0;
+
+    while ((rt_ubase_t)s1 & KS_MASK)
+    {
+        if (*s1 != *s2 || *s1 == '\0')
+            goto __exit;
+        s1++;
+        s2++;
+        left--;
+    }
+
+    w1 = (const rt_ubase_t *)s1;
+    shift = ((rt_ubase_t)s2 & KS_MASK) * 8;
+    if (shift == 0)
+    {
+        w2 = (const rt_ubase_t *)s2;
+        while (left >= KS_WORD && *w1 == *w2 && !ks_has_zero(*w1))
+        {
+            w1++;
+            w2++;
+            left -= KS_WORD;
+        }
+        s2 = (const rt_uint8_t *)w2;
+    }
+    else
+    {
+        /* the next word of ct is read only when lo has no null character */
+        w2 = (const rt_ubase_t *)(s2 - shift / 8);
+        lo = *w2++;
+        while (left >= KS_WORD && !ks_has_zero(lo | KS_LEAD_FILL(shift)))
+        {
+            hi = *w2;
+            if (*w1 != KS_MERGE(lo, hi, shift) || ks_has_zero(*w1))
+                break;
+            lo = hi;
+            w1++;
+            w2++;
+            left -= KS_WORD;
+        }
+        s2 = (const rt_uint8_t *)w2 - KS_WORD + shift / 8;
+    }
+    s1 = (const rt_uint8_t *)w1;
+
+__exit:
+    *cs = (const char *)s1;
+    *ct = (const char *)s2;
+
+    return count - left;
+}
+#endif
+
 /**
  * This function will compare two strings with specified maximum length
  *
@@ -434,6 +693,10 @@ rt_int32_t rt_strncmp(const char *cs, const char *ct, rt_ubase_t count)
 {
     register signed char __res = 0;
 
+#ifndef RT_USING_TINY_SIZE
+    count -= ks_str_skip(&cs, &ct, count);
+#endif
+
     while (count)
     {
         if ((__res = *cs - *ct++) != 0 || !*cs++)
@@ -455,6 +718,10 @@ RTM_EXPORT(rt_strncmp);
  */
 rt_int32_t rt_strcmp(const char *cs, const char *ct)
 {
+#ifndef RT_USING_TINY_SIZE
+    ks_str_skip(&cs, &ct, (rt_ubase_t)-1);
+#endif
+
     while (*cs && *cs == *ct)
         cs++, ct++;
 
@@ -494,9 +761,23 @@ RTM_EXPORT(rt_strnlen);
  */
 rt_size_t rt_strlen(const char *s)
 {
-    const char *sc;
+    const char *sc = s;
+#ifndef RT_USING_TINY_SIZE
+    const rt_ubase_t *w;
+
+    while ((rt_ubase_t)sc & KS_MASK)
+    {
+        if (*sc == '\0')
+            return sc - s;
+        sc++;
+    }
 
-    for (sc = s; *sc != '\0'; ++sc) /* nothing */
+    for (w = (const rt_ubase_t *)sc; !ks_has_zero(*w); w++) /* nothing */
+        ;
+    sc = (const char *)w;
+#endif
+
+    for (; *sc != '\0'; ++sc) /* nothing */
         ;
 
     return sc - s;
@@ -545,45 +826,99 @@ RTM_EXPORT(rt_show_version);
 /* private function */
 #define isdigit(c) ((unsigned)((c) - '0') < 10)
 
-#ifdef RT_PRINTF_LONGLONG
-rt_inline int divide(long long *n, int base)
-{
-    int res;
+/* two decimal digits of 0 to 99 */
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
 
-    /* optimized for processor which does not support divide instructions. */
-    if (base == 10)
-    {
-        res = (int)(((unsigned long long)*n) % 10U);
-        *n = (long long)(((unsigned long long)*n) / 10U);
-    }
-    else
-    {
-        res = (int)(((unsigned long long)*n) % 16U);
-        *n = (long long)(((unsigned long long)*n) / 16U);
-    }
-
-    return res;
+/*
+ * Divide a 64 bits number by 10000 and return the remainder, by long division
+ * on 16 bits limbs. Each step divides a number below 10000 << 16 by a constant,
+ * which is a multiply on RV32, where a 64 bits division calls __udivdi3.
+ */
+rt_inline rt_uint32_t divide_10000(rt_uint64_t *n)
+{
+    rt_uint32_t hi = (rt_uint32_t)(*n >> 32);
+    rt_uint32_t lo = (rt_uint32_t)(*n & 0xffffffff);
+    rt_uint32_t q3, q2, q1, q0, r;
+
+    q3 = (hi >> 16) / 10000;
+    r  = (hi >> 16) % 10000;
+    q2 = ((r << 16) | (hi & 0xffff)) / 10000;
+    r  = ((r << 16) | (hi & 0xffff)) % 10000;
+    q1 = ((r << 16) | (lo >> 16)) / 10000;
+    r  = ((r << 16) | (lo >> 16)) % 10000;
+    q0 = ((r << 16) | (lo & 0xffff)) / 10000;
+    r  = ((r << 16) | (lo & 0xffff)) % 10000;
+
+    *n = ((rt_uint64_t)((q3 << 16) | q2) << 32) | ((q1 << 16) | q0);
+
+    return r;
 }
-#else
-rt_inline int divide(long *n, int base)
+
+/*
+ * Put the digits of a number backwards in front of pos: decimal digits two at
+ * a time from digit_pairs, hexadecimal and octal ones by a shift.
+ *
+ * @return the first digit
+ */
+static char *put_digits(char *pos, rt_uint64_t num, int base, const char *digits)
 {
-    int res;
+    rt_uint32_t n, r;
 
-    /* optimized for processor which does not support divide instructions. */
     if (base == 10)
     {
-        res = (int)(((unsigned long)*n) % 10U);
-        *n = (long)(((unsigned long)*n) / 10U);
+        /* four digits at a time while the number needs 64 bits */
+        while (num >> 32)
+        {
+            r = divide_10000(&num);
+            pos -= 4;
+            pos[0] = digit_pairs[(r / 100) * 2];
+            pos[1] = digit_pairs[(r / 100) * 2 + 1];
+            pos[2] = digit_pairs[(r % 100) * 2];
+            pos[3] = digit_pairs[(r % 100) * 2 + 1];
+        }
+
+        n = (rt_uint32_t)num;
+        while (n >= 100)
+        {
+            r = n % 100;
+            n /= 100;
+            pos -= 2;
+            pos[0] = digit_pairs[r * 2];
+            pos[1] = digit_pairs[r * 2 + 1];
+        }
+
+        if (n >= 10)
+        {
+            pos -= 2;
+            pos[0] = digit_pairs[n * 2];
+            pos[1] = digit_pairs[n * 2 + 1];
+        }
+        else
+            *--pos = '0' + n;
     }
     else
     {
-        res = (int)(((unsigned long)*n) % 16U);
-        *n = (long)(((unsigned long)*n) / 16U);
+        r = (base == 16) ? 4 : 3;
+        do
+        {
+            *--pos = digits[num & (base - 1)];
+            num >>= r;
+        }
+        while (num != 0);
     }
 
-    return res;
+    return pos;
 }
-#endif
 
 rt_inline int skip_atoi(const char **s)
 {
@@ -635,6 +970,7 @@ static char *print_number(char *buf,
 #endif
     int precision_bak = precision;
     const char *digits;
+    char *pos;
     static const char small_digits[] = "0123456789abcdef";
     static const char large_digits[] = "0123456789ABCDEF";
     register int i;
@@ -673,14 +1009,12 @@ static char *print_number(char *buf,
     }
 #endif
 
-    i = 0;
-    if (num == 0)
-        tmp[i++] = '0';
-    else
-    {
-        while (num != 0)
-            tmp[i++] = digits[divide(&num, base)];
-    }
+#ifdef RT_PRINTF_LONGLONG
+    pos = put_digits(&tmp[sizeof(tmp)], (unsigned long long)num, base, digits);
+#else
+    pos = put_digits(&tmp[sizeof(tmp)], (unsigned long)num, base, digits);
+#endif
+    i = &tmp[sizeof(tmp)] - pos;
 
 #ifdef RT_PRINTF_PRECISION
     if (i > precision)
@@ -760,7 +1094,8 @@ static char *print_number(char *buf,
     while (i-- > 0 && (precision_bak != 0))
     {
         if (buf < end)
-            *buf = tmp[i];
+            *buf = *pos;
+        ++pos;
         ++buf;
     }
 
@@ -774,6 +1109,210 @@ static char *print_number(char *buf,
     return buf;
 }
 
+#if defined(RT_PRINTF_FLOAT) && defined(RT_PRINTF_PRECISION)
+/* decimal places of %f and %q at most, more are taken as this */
+#define FLOAT_PRECISION_MAX     9
+
+/* fraction bits of the fixed point argument of %q */
+#ifndef RT_PRINTF_Q_BITS
+#define RT_PRINTF_Q_BITS        16
+#endif
+
+static const rt_uint32_t pow10_table[FLOAT_PRECISION_MAX + 1] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* put text with its sign into a field, zero padding goes after the sign */
+static char *print_field(char *buf, char *end, char sign, const char *text,
+                         int len, int width, int type)
+{
+    int size = width - len - (sign ? 1 : 0);
+
+    if (!(type & (LEFT | ZEROPAD)))
+    {
+        while (size-- > 0)
+        {
+            if (buf < end)
+                *buf = ' ';
+            ++buf;
+        }
+    }
+
+    if (sign)
+    {
+        if (buf < end)
+            *buf = sign;
+        ++buf;
+    }
+
+    if (!(type & LEFT))
+    {
+        while (size-- > 0)
+        {
+            if (buf < end)
+                *buf = '0';
+            ++buf;
+        }
+    }
+
+    while (len-- > 0)
+    {
+        if (buf < end)
+            *buf = *text;
+        ++text;
+        ++buf;
+    }
+
+    while (size-- > 0)
+    {
+        if (buf < end)
+            *buf = ' ';
+        ++buf;
+    }
+
+    return buf;
+}
+
+/*
+ * Print mant * 2^exp2 with precision decimal places, rounded half to even as
+ * by the C library. The fraction is exact in mant, and the fraction times
+ * 10^precision is taken as a product of 96 bits (below 2^83 for a mant below
+ * 2^53), so the digits and the rounding are exact with no floating point nor
+ * 64 bits division. The integer part must be below 2^64.
+ */
+static char *print_fixed(char *buf, char *end, rt_uint64_t mant, int exp2, char sign,
+                         int width, int precision, int type)
+{
+    char tmp[32];
+    char *pos, *digit;
+    rt_uint64_t integer, fraction, high, rest;
+    rt_uint32_t scale, low, decimal;
+    int k, round;
+
+    if (precision < 0)
+        precision = 6;
+    if (precision > FLOAT_PRECISION_MAX)
+        precision = FLOAT_PRECISION_MAX;
+    scale = pow10_table[precision];
+
+    decimal = 0;
+    if (exp2 >= 0)
+        integer = mant << exp2;
+    else
+    {
+        k = -exp2;
+        integer  = (k < 64) ? (mant >> k) : 0;
+        fraction = (k < 64) ? (mant & (((rt_uint64_t)1 << k) - 1)) : mant;
+
+        /* fraction * scale = high << 32 | low */
+        high = (fraction & 0xffffffff) * scale;
+        low  = (rt_uint32_t)(high & 0xffffffff);
+        high = (fraction >> 32) * scale + (high >> 32);
+
+        /* decimal = fraction * scale >> k, round: the rest against half */
+        if (k < 32)
+        {
+            decimal = (rt_uint32_t)((high << (32 - k)) | (low >> k));
+            low &= (1UL << k) - 1;
+            round = (low > (1UL << (k - 1))) - (low < (1UL << (k - 1)));
+        }
+        else if (k == 32)
+        {
+            decimal = (rt_uint32_t)high;
+            round = (low > 0x80000000UL) - (low < 0x80000000UL);
+        }
+        else if (k - 32 < 53)
+        {
+            k -= 32;
+            decimal = (rt_uint32_t)(high >> k);
+            rest = high & (((rt_uint64_t)1 << k) - 1);
+            if (rest != ((rt_uint64_t)1 << (k - 1)))
+                round = (rest > ((rt_uint64_t)1 << (k - 1))) ? 1 : -1;
+            else
+                round = (low != 0);
+        }
+        else
+        {
+            /* below 2^83, far below half */
+            round = -1;
+        }
+
+        if (round > 0 || (round == 0 && ((precision ? decimal : (rt_uint32_t)integer) & 1)))
+        {
+            if (++decimal == scale)
+            {
+                decimal = 0;
+                integer ++;
+            }
+        }
+    }
+
+    pos = &tmp[sizeof(tmp)];
+    if (precision > 0 || (type & SPECIAL))
+    {
+        digit = pos - precision;
+        if (precision > 0)
+            pos = put_digits(pos, decimal, 10, RT_NULL);
+        while (pos > digit)
+            *--pos = '0';
+        *--pos = '.';
+    }
+    pos = put_digits(pos, integer, 10, RT_NULL);
+
+    return print_field(buf, end, sign, pos, &tmp[sizeof(tmp)] - pos, width, type);
+}
+
+rt_inline char float_sign(int negative, int type)
+{
+    if (negative)
+        return '-';
+    if (type & PLUS)
+        return '+';
+    if (type & SPACE)
+        return ' ';
+
+    return 0;
+}
+
+/*
+ * Print a double for %f from its IEEE 754 bits, so with a soft float ABI it
+ * takes no call to the floating point library. A value of 2^64 or more is
+ * printed as "oor", out of range.
+ */
+static char *print_double(char *buf, char *end, double value,
+                          int width, int precision, int type)
+{
+    union
+    {
+        double value;
+        rt_uint64_t bits;
+    } v;
+    rt_uint64_t mant;
+    int exp2;
+    char sign;
+
+    v.value = value;
+    sign = float_sign((int)(v.bits >> 63), type);
+    exp2 = (int)(v.bits >> 52) & 0x7ff;
+    mant = v.bits & (((rt_uint64_t)1 << 52) - 1);
+
+    if (exp2 == 0x7ff || exp2 > 1075 + 11)
+    {
+        return print_field(buf, end, sign, exp2 != 0x7ff ? "oor" : (mant ? "nan" : "inf"),
+                           3, width, type & ~ZEROPAD);
+    }
+
+    /* subnormal numbers have no implicit bit */
+    if (exp2 == 0)
+        exp2 = 1;
+    else
+        mant |= (rt_uint64_t)1 << 52;
+
+    return print_fixed(buf, end, mant, exp2 - 1075, sign, width, precision, type);
+}
+#endif /* RT_PRINTF_FLOAT && RT_PRINTF_PRECISION */
+
 rt_int32_t rt_vsnprintf(char *buf,
                         rt_size_t size,
                         const char *fmt,
@@ -982,6 +1521,21 @@ rt_int32_t rt_vsnprintf(char *buf,
             ++str;
             continue;
 
+#if defined(RT_PRINTF_FLOAT) && defined(RT_PRINTF_PRECISION)
+        case 'f':
+            str = print_double(str, end, va_arg(args, double),
+                               field_width, precision, flags);
+            continue;
+
+        case 'q':
+            /* signed fixed point of RT_PRINTF_Q_BITS fraction bits */
+            i = va_arg(args, rt_int32_t);
+            str = print_fixed(str, end, i < 0 ? -(rt_uint64_t)i : (rt_uint64_t)i,
+                              -RT_PRINTF_Q_BITS, float_sign(i < 0, flags),
+                              field_width, precision, flags);
+            continue;
+#endif
+
         /* integer number formats - set up the flags and "break" */
         case 'o':
             base = 8;
@@ -1174,16 +1728,9 @@ RT_WEAK void rt_hw_console_output(const char *str)
 }
 RTM_EXPORT(rt_hw_console_output);
 
-/**
- * This function will put string to the console.
- *
- * @param str the string output to the console.
- */
-void rt_kputs(const char *str)
+/* write a string to the console device, or by the board before it is set */
+static void _console_output(const char *str, rt_size_t length)
 {
-    if (!str)
-        return;
-
 #ifdef RT_USING_DEVICE
     if (_console_device == RT_NULL)
     {
@@ -1194,7 +1741,7 @@ void rt_kputs(const char *str)
         rt_uint16_t old_flag = _console_device->open_flag;
 
         _console_device->open_flag |= RT_DEVICE_FLAG_STREAM;
-        rt_device_write(_console_device, 0, str, rt_strlen(str));
+        rt_device_write(_console_device, 0, str, length);
         _console_device->open_flag = old_flag;
     }
 #else
@@ -1202,6 +1749,272 @@ void rt_kputs(const char *str)
 #endif
 }
 
+#ifdef RT_USING_CONSOLE_ASYNC
+/*
+ * Asynchronous console
+ *
+ * rt_kprintf and rt_kputs append a record to a ring buffer and return, the
+ * console thread at a low priority writes the records out, so a thread or an
+ * ISR printing never waits for the UART. A record is reserved with interrupts
+ * disabled for a few instructions only, then formatted in place and committed;
+ * a record which doesn't fit is dropped and counted. The console thread polls
+ * the ring rather than being woken, as rt_kprintf is called with interrupts
+ * disabled or inside the scheduler, where nothing may be released.
+ *
+ * Before the console thread runs and after rt_console_flush, printing is
+ * synchronous as without the option.
+ */
+#ifndef RT_CONSOLE_ASYNC_BUF_SIZE
+#define RT_CONSOLE_ASYNC_BUF_SIZE       1024
+#endif
+
+#ifndef RT_CONSOLE_ASYNC_THREAD_PRIO
+#define RT_CONSOLE_ASYNC_THREAD_PRIO    (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+#ifndef RT_CONSOLE_ASYNC_THREAD_STACK_SIZE
+#define RT_CONSOLE_ASYNC_THREAD_STACK_SIZE 512
+#endif
+
+/* ticks the console thread sleeps when the ring is empty */
+#ifndef RT_CONSOLE_ASYNC_POLL_TICKS
+#define RT_CONSOLE_ASYNC_POLL_TICKS     (RT_TICK_PER_SECOND / 100 + 1)
+#endif
+
+#if (RT_CONSOLE_ASYNC_BUF_SIZE & (RT_CONSOLE_ASYNC_BUF_SIZE - 1)) != 0
+#error "RT_CONSOLE_ASYNC_BUF_SIZE must be a power of 2"
+#endif
+
+#if RT_CONSOLE_ASYNC_BUF_SIZE < 2 * (RT_CONSOLEBUF_SIZE + 4)
+#error "RT_CONSOLE_ASYNC_BUF_SIZE must hold two records of RT_CONSOLEBUF_SIZE"
+#endif
+
+#define CONSOLE_RECORD_BUSY             0xffff  /* reserved, not committed yet */
+#define CONSOLE_RECORD_PAD              0xfffe  /* skip to the start of ring */
+
+struct console_record
+{
+    volatile rt_uint16_t size;                  /* bytes of record, header included */
+    volatile rt_uint16_t length;                /* length of text, or BUSY/PAD */
+    char text[];                                /* null terminated */
+};
+
+ALIGN(4)
+static rt_uint8_t console_ring[RT_CONSOLE_ASYNC_BUF_SIZE];
+static volatile rt_uint32_t console_head;       /* free running offsets */
+static volatile rt_uint32_t console_tail;
+static volatile rt_uint32_t console_drops;
+static volatile rt_uint8_t console_async;       /* records go to the ring */
+static rt_uint8_t console_flushed;              /* synchronous for good */
+
+static struct rt_thread console_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t console_thread_stack[RT_CONSOLE_ASYNC_THREAD_STACK_SIZE];
+
+#define CONSOLE_RECORD(offset) \
+    ((struct console_record *)&console_ring[(offset) & (RT_CONSOLE_ASYNC_BUF_SIZE - 1)])
+
+/* reserve a record of length bytes of text, RT_NULL and counted if no room */
+static struct console_record *console_reserve(rt_size_t length)
+{
+    register rt_base_t level;
+    struct console_record *record;
+    rt_uint32_t size, pad;
+
+    size = RT_ALIGN(sizeof(struct console_record) + length + 1, 4);
+
+    level = rt_hw_interrupt_disable();
+    /* a record never wraps, pad the end of ring when it doesn't fit there */
+    pad = RT_CONSOLE_ASYNC_BUF_SIZE - (console_head & (RT_CONSOLE_ASYNC_BUF_SIZE - 1));
+    if (pad >= size)
+        pad = 0;
+
+    if (console_head + pad + size - console_tail > RT_CONSOLE_ASYNC_BUF_SIZE)
+    {
+        console_drops ++;
+        rt_hw_interrupt_enable(level);
+
+        return RT_NULL;
+    }
+
+    if (pad)
+    {
+        record = CONSOLE_RECORD(console_head);
+        record->size   = pad;
+        record->length = CONSOLE_RECORD_PAD;
+        console_head += pad;
+    }
+
+    record = CONSOLE_RECORD(console_head);
+    record->size   = size;
+    record->length = CONSOLE_RECORD_BUSY;
+    console_head += size;
+    rt_hw_interrupt_enable(level);
+
+    return record;
+}
+
+/* commit a record with its text, giving back the room left over if it's the last one */
+static void console_commit(struct console_record *record, rt_size_t length)
+{
+    register rt_base_t level;
+    rt_uint32_t size;
+
+    size = RT_ALIGN(sizeof(struct console_record) + length + 1, 4);
+
+    level = rt_hw_interrupt_disable();
+    if (CONSOLE_RECORD(console_head - record->size) == record &&
+        console_head - console_tail >= record->size)
+    {
+        console_head -= record->size - size;
+        record->size  = size;
+    }
+    record->length = length;
+    rt_hw_interrupt_enable(level);
+}
+
+/*
+ * Write out the committed records. The console thread stops at a record not
+ * committed yet; on panic such a record is skipped, as its writer may never
+ * run again.
+ */
+static void console_drain(rt_bool_t panic)
+{
+    register rt_base_t level;
+    struct console_record *record;
+    rt_uint32_t offset, drops;
+    rt_uint16_t length;
+    static rt_uint32_t drops_reported;
+    char notice[40];
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        offset = console_tail;
+        if (offset == console_head)
+        {
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+        record = CONSOLE_RECORD(offset);
+        length = record->length;
+        rt_hw_interrupt_enable(level);
+
+        if (length == CONSOLE_RECORD_BUSY && !panic)
+            break;
+        if (length < CONSOLE_RECORD_PAD)
+            _console_output(record->text, length);
+
+        /* on panic, the console thread may have taken the record already */
+        level = rt_hw_interrupt_disable();
+        if (console_tail == offset)
+            console_tail = offset + record->size;
+        rt_hw_interrupt_enable(level);
+    }
+
+    drops = console_drops;
+    if (drops != drops_reported)
+    {
+        rt_snprintf(notice, sizeof(notice), "\n[console: %d dropped]\n", drops - drops_reported);
+        _console_output(notice, rt_strlen(notice));
+        drops_reported = drops;
+    }
+}
+
+static void console_thread_entry(void *parameter)
+{
+    register rt_base_t level;
+
+    /* until here the boot output is written out, and not lost on a hang */
+    level = rt_hw_interrupt_disable();
+    if (!console_flushed)
+        console_async = 1;
+    rt_hw_interrupt_enable(level);
+
+    while (1)
+    {
+        console_drain(RT_FALSE);
+        rt_thread_delay(RT_CONSOLE_ASYNC_POLL_TICKS);
+    }
+}
+
+/**
+ * This function will start the console thread. Once it runs, rt_kprintf and
+ * rt_kputs return without waiting for the output.
+ */
+int rt_console_async_init(void)
+{
+    rt_thread_init(&console_thread,
+                   "console",
+                   console_thread_entry,
+                   RT_NULL,
+                   &console_thread_stack[0],
+                   sizeof(console_thread_stack),
+                   RT_CONSOLE_ASYNC_THREAD_PRIO,
+                   10);
+    rt_thread_startup(&console_thread);
+
+    return 0;
+}
+INIT_PREV_EXPORT(rt_console_async_init);
+#endif /* RT_USING_CONSOLE_ASYNC */
+
+/**
+ * This function will write out all pending console output and make the
+ * console synchronous from then on. It's invoked on a fatal error, before
+ * the message is printed, and may be invoked with interrupts disabled.
+ */
+void rt_console_flush(void)
+{
+#ifdef RT_USING_CONSOLE_ASYNC
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    console_async = 0;
+    console_flushed = 1;
+    console_drain(RT_TRUE);
+    rt_hw_interrupt_enable(level);
+#endif
+}
+RTM_EXPORT(rt_console_flush);
+
+/**
+ * This function will put string to the console.
+ *
+ * @param str the string output to the console.
+ */
+void rt_kputs(const char *str)
+{
+    rt_size_t length;
+#ifdef RT_USING_CONSOLE_ASYNC
+    struct console_record *record;
+#endif
+
+    if (!str)
+        return;
+
+    length = rt_strlen(str);
+#ifdef RT_USING_CONSOLE_ASYNC
+    if (console_async)
+    {
+        if (length > RT_CONSOLE_ASYNC_BUF_SIZE / 2)
+            length = RT_CONSOLE_ASYNC_BUF_SIZE / 2;
+
+        record = console_reserve(length);
+        if (record != RT_NULL)
+        {
+            rt_memcpy(record->text, str, length);
+            record->text[length] = '\0';
+            console_commit(record, length);
+        }
+
+        return;
+    }
+#endif
+
+    _console_output(str, length);
+}
+
 /**
  * This function will print a formatted string on system console
  *
@@ -1212,8 +2025,29 @@ void rt_kprintf(const char *fmt, ...)
     va_list args;
     rt_size_t length;
     static char rt_log_buf[RT_CONSOLEBUF_SIZE];
+#ifdef RT_USING_CONSOLE_ASYNC
+    struct console_record *record;
+#endif
 
     va_start(args, fmt);
+#ifdef RT_USING_CONSOLE_ASYNC
+    /* format in place of a record of the largest size, shrunk on commit */
+    if (console_async)
+    {
+        record = console_reserve(RT_CONSOLEBUF_SIZE - 1);
+        if (record != RT_NULL)
+        {
+            length = rt_vsnprintf(record->text, RT_CONSOLEBUF_SIZE, fmt, args);
+            if (length > RT_CONSOLEBUF_SIZE - 1)
+                length = RT_CONSOLEBUF_SIZE - 1;
+            console_commit(record, length);
+        }
+        va_end(args);
+
+        return;
+    }
+#endif
+
     /* the return value of vsnprintf is the number of bytes that would be
      * written to buffer had if the size of the buffer been sufficiently
      * large excluding the terminating null byte. If the output string
@@ -1222,24 +2056,7 @@ void rt_kprintf(const char *fmt, ...)
     length = rt_vsnprintf(rt_log_buf, sizeof(rt_log_buf) - 1, fmt, args);
     if (length > RT_CONSOLEBUF_SIZE - 1)
         length = RT_CONSOLEBUF_SIZE - 1;
-        // printfNexys(rt_log_buf);
-#ifdef RT_USING_DEVICE
-    if (_console_device == RT_NULL)
-    {
-        rt_hw_console_output(rt_log_buf);
-        // printfNexys(rt_log_buf);
-    }
-    else
-    {
-        rt_uint16_t old_flag = _console_device->open_flag;
-
-        _console_device->open_flag |= RT_DEVICE_FLAG_STREAM;
-        rt_device_write(_console_device, 0, rt_log_buf, length);
-        _console_device->open_flag = old_flag;
-    }
-#else
-    rt_hw_console_output(rt_log_buf);
-#endif
+    _console_output(rt_log_buf, length);
     va_end(args);
 }
 RTM_EXPORT(rt_kprintf);
@@ -1380,6 +2197,9 @@ void rt_assert_handler(const char *ex_string, const char *func, rt_size_t line)
 
     if (rt_assert_hook == RT_NULL)
     {
+#ifdef RT_USING_CONSOLE
+        rt_console_flush();
+#endif
 #ifdef RT_USING_MODULE
         if (dlmodule_self())
         {
@@ -403,6 +403,7 @@ void *rt_malloc(rt_size_t size)
 
             RT_OBJECT_HOOK_CALL(rt_malloc_hook,
                                 (((void *)((rt_uint8_t *)mem + SIZEOF_STRUCT_MEM)), size));
+            RT_MEMPROF_ALLOC((rt_uint8_t *)mem + SIZEOF_STRUCT_MEM, size);
 
             /* return the memory data except mem struct */
             return (rt_uint8_t *)mem + SIZEOF_STRUCT_MEM;
@@ -498,6 +499,7 @@ void *rt_realloc(void *rmem, rt_size_t newsize)
         plug_holes(mem2);
 
         rt_sem_release(&heap_sem);
+        RT_MEMPROF_ALLOC(rmem, newsize);
 
         return rmem;
     }
@@ -509,6 +511,7 @@ void *rt_realloc(void *rmem, rt_size_t newsize)
     {
         rt_memcpy(nmem, rmem, size < newsize ? size : newsize);
         rt_free(rmem);
+        RT_MEMPROF_ALLOC(nmem, newsize);
     }
 
     return nmem;
@@ -536,7 +539,10 @@ void *rt_calloc(rt_size_t count, rt_size_t size)
 
     /* zero the memory */
     if (p)
+    {
         rt_memset(p, 0, count * size);
+        RT_MEMPROF_ALLOC(p, count * size);
+    }
 
     return p;
 }
@@ -562,6 +568,7 @@ void rt_free(void *rmem)
               (rt_uint8_t *)rmem < (rt_uint8_t *)heap_end);
 
     RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
+    RT_MEMPROF_FREE(rmem);
 
     if ((rt_uint8_t *)rmem < (rt_uint8_t *)heap_ptr ||
         (rt_uint8_t *)rmem >= (rt_uint8_t *)heap_end)
@@ -614,6 +621,36 @@ void rt_free(void *rmem)
 }
 RTM_EXPORT(rt_free);
 
+/**
+ * This function will get the free memory of heap.
+ *
+ * @param free the total size of free blocks
+ * @param max_free the size of the largest free block
+ */
+void rt_memory_free_info(rt_uint32_t *free, rt_uint32_t *max_free)
+{
+    struct heap_mem *mem;
+    rt_uint32_t size, total = 0, max = 0;
+
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    for (mem = (struct heap_mem *)heap_ptr; mem != heap_end; mem = (struct heap_mem *)&heap_ptr[mem->next])
+    {
+        if (mem->used)
+            continue;
+
+        size = mem->next - ((rt_uint8_t *)mem - heap_ptr) - SIZEOF_STRUCT_MEM;
+        total += size;
+        if (size > max)
+            max = size;
+    }
+    rt_sem_release(&heap_sem);
+
+    if (free != RT_NULL)
+        *free = total;
+    if (max_free != RT_NULL)
+        *max_free = max;
+}
+
 #ifdef RT_MEM_STATS
 void rt_memory_info(rt_uint32_t *total,
                     rt_uint32_t *used,
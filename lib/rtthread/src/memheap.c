@@ -597,6 +597,9 @@ RTM_EXPORT(rt_memheap_free);
 
 #ifdef RT_USING_MEMHEAP_AS_HEAP
 static struct rt_memheap _heap;
+#ifdef RT_USING_HEAP_FAST
+static struct rt_memheap _fast_heap;
+#endif
 
 void rt_system_heap_init(void *begin_addr, void *end_addr)
 {
@@ -607,7 +610,26 @@ void rt_system_heap_init(void *begin_addr, void *end_addr)
                     (rt_uint32_t)end_addr - (rt_uint32_t)begin_addr);
 }
 
-void *rt_malloc(rt_size_t size)
+#ifdef RT_USING_HEAP_FAST
+/**
+ * This function will initialize the fast region of the system heap, e.g. in
+ * tightly coupled memory. It's used by rt_malloc_hint(size, RT_MEM_FAST), and
+ * by the other allocations only when the system heap is exhausted.
+ *
+ * @param begin_addr the beginning address of fast region
+ * @param end_addr the end address of fast region
+ */
+void rt_system_heap_fast_init(void *begin_addr, void *end_addr)
+{
+    rt_memheap_init(&_fast_heap,
+                    "fastheap",
+                    begin_addr,
+                    (rt_uint32_t)end_addr - (rt_uint32_t)begin_addr);
+}
+#endif
+
+/* allocate in the system heap, then in the other memory heaps except skip */
+static void *_heap_alloc(rt_size_t size, struct rt_memheap *skip)
 {
     void *ptr;
 
@@ -634,7 +656,7 @@ void *rt_malloc(rt_size_t size)
             RT_ASSERT(rt_object_get_type(&heap->parent) == RT_Object_Class_MemHeap);
 
             /* not allocate in the default system heap */
-            if (heap == &_heap)
+            if (heap == &_heap || heap == skip)
                 continue;
 
             ptr = rt_memheap_alloc(heap, size);
@@ -645,10 +667,46 @@ void *rt_malloc(rt_size_t size)
 
     return ptr;
 }
+
+void *rt_malloc(rt_size_t size)
+{
+    void *ptr;
+
+    ptr = _heap_alloc(size, RT_NULL);
+    RT_MEMPROF_ALLOC(ptr, size);
+
+    return ptr;
+}
 RTM_EXPORT(rt_malloc);
 
+#ifdef RT_USING_HEAP_FAST
+/**
+ * This function will allocate a block from the heap region given by hint.
+ *
+ * @param size the size of memory to be allocated
+ * @param hint RT_MEM_FAST for the fast region, falling back to the others;
+ *        RT_MEM_LARGE for any region but the fast one; RT_MEM_ANY as rt_malloc
+ *
+ * @return the allocated memory
+ */
+void *rt_malloc_hint(rt_size_t size, rt_uint32_t hint)
+{
+    void *ptr = RT_NULL;
+
+    if (hint == RT_MEM_FAST)
+        ptr = rt_memheap_alloc(&_fast_heap, size);
+    if (ptr == RT_NULL)
+        ptr = _heap_alloc(size, hint == RT_MEM_LARGE ? &_fast_heap : RT_NULL);
+    RT_MEMPROF_ALLOC(ptr, size);
+
+    return ptr;
+}
+RTM_EXPORT(rt_malloc_hint);
+#endif
+
 void rt_free(void *rmem)
 {
+    RT_MEMPROF_FREE(rmem);
     rt_memheap_free(rmem);
 }
 RTM_EXPORT(rt_free);
@@ -691,6 +749,14 @@ void *rt_realloc(void *rmem, rt_size_t newsize)
         }
     }
 
+    if (new_ptr != RT_NULL)
+    {
+        /* the old block may be released inside of rt_memheap_realloc */
+        if (new_ptr != rmem)
+            RT_MEMPROF_FREE(rmem);
+        RT_MEMPROF_ALLOC(new_ptr, newsize);
+    }
+
     return new_ptr;
 }
 RTM_EXPORT(rt_realloc);
@@ -706,12 +772,43 @@ void *rt_calloc(rt_size_t count, rt_size_t size)
     {
         /* clean memory */
         rt_memset(ptr, 0, total_size);
+        RT_MEMPROF_ALLOC(ptr, total_size);
     }
 
     return ptr;
 }
 RTM_EXPORT(rt_calloc);
 
+/**
+ * This function will get the free memory of the system heap, other memory
+ * heaps are not counted.
+ *
+ * @param free the total size of free blocks
+ * @param max_free the size of the largest free block
+ */
+void rt_memory_free_info(rt_uint32_t *free, rt_uint32_t *max_free)
+{
+    struct rt_memheap_item *item;
+    rt_uint32_t size, total = 0, max = 0;
+
+    rt_sem_take(&(_heap.lock), RT_WAITING_FOREVER);
+    for (item = _heap.free_list->next_free;
+         item != _heap.free_list;
+         item = item->next_free)
+    {
+        size = MEMITEM_SIZE(item);
+        total += size;
+        if (size > max)
+            max = size;
+    }
+    rt_sem_release(&(_heap.lock));
+
+    if (free != RT_NULL)
+        *free = total;
+    if (max_free != RT_NULL)
+        *max_free = max;
+}
+
 #endif
 
 #endif
@@ -19,6 +19,10 @@
 #include <rthw.h>
 #include <rtthread.h>
 
+#ifdef __riscv_atomic
+#include "riscv-ops.h"
+#endif
+
 #ifdef RT_USING_MEMPOOL
 
 #ifdef RT_USING_HOOK
@@ -56,6 +60,163 @@ void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block))
 /**@}*/
 #endif
 
+/*
+ * The free list head is one word, so it can be popped and pushed with a
+ * single compare and swap instead of disabling interrupt where the A
+ * extension is available; without it, the list and the free count are
+ * updated in one interrupt disabled section. The bits under
+ * block_mask hold the code of the first free block, its offset in the pool
+ * in words plus 1 (0 for an empty list), the bits above hold a version
+ * which is increased by every pop and push. A free block keeps the code of
+ * the next one in its header word.
+ *
+ * The version defeats ABA: a pop reads the next code out of the first block
+ * before the swap; should the block be popped, another one popped and the
+ * first one pushed back in between, the head code is the same but the
+ * version is not, so the swap fails and the pop starts again.
+ */
+#define MP_CODE_SHIFT           2
+#define MP_CODE_MASK_MAX        0x000FFFFF      /* 4MB pool, 12 bits version */
+
+#if RT_ALIGN_SIZE < 4
+#error "memory pool needs RT_ALIGN_SIZE of 4 at least"
+#endif
+
+rt_inline rt_uint32_t mp_code(struct rt_mempool *mp, rt_uint8_t *block)
+{
+    return ((block - (rt_uint8_t *)mp->start_address) >> MP_CODE_SHIFT) + 1;
+}
+
+rt_inline rt_uint8_t *mp_block(struct rt_mempool *mp, rt_uint32_t code)
+{
+    return (rt_uint8_t *)mp->start_address + ((code - 1) << MP_CODE_SHIFT);
+}
+
+#ifdef __riscv_atomic
+/* replace the free list head if it's still old, the version bits included */
+rt_inline rt_bool_t mp_cas(struct rt_mempool *mp, rt_uint32_t old, rt_uint32_t new)
+{
+    return atomic_cas_w(&mp->block_list, old, new) == old ? RT_TRUE : RT_FALSE;
+}
+#endif
+
+/*
+ * take up to count blocks off the free list, return the number of blocks
+ * taken. It never blocks and can be invoked in ISR.
+ */
+static rt_size_t mp_pop(struct rt_mempool *mp, void **blocks, rt_size_t count)
+{
+    rt_uint32_t head, code;
+    rt_size_t taken;
+#ifdef __riscv_atomic
+    rt_uint8_t *end;
+
+    end = (rt_uint8_t *)mp->start_address +
+          mp->block_total_count * (mp->block_size + sizeof(rt_uint8_t *));
+    while (1)
+    {
+        head = *(volatile rt_uint32_t *)&mp->block_list;
+        code = head & mp->block_mask;
+        for (taken = 0; taken < count && code != 0; taken ++)
+        {
+            /* the code read from a block taken meanwhile may be anything */
+            if (code > mp->block_mask || mp_block(mp, code) >= end)
+                break;
+
+            blocks[taken] = mp_block(mp, code);
+            code = *(volatile rt_uint32_t *)blocks[taken];
+        }
+        if (taken == 0)
+            return 0;
+
+        /* stopped at a bad code, the list has changed */
+        if (taken < count && code != 0)
+            continue;
+
+        if (mp_cas(mp, head, ((head | mp->block_mask) + 1) | code) == RT_TRUE)
+            break;
+    }
+
+    atomic_add_w(&mp->block_free_count, -(rt_base_t)taken);
+#else
+    register rt_base_t level;
+
+    /* without atomics, the list and the count in one section */
+    level = rt_hw_interrupt_disable();
+    head = mp->block_list;
+    code = head & mp->block_mask;
+    for (taken = 0; taken < count && code != 0; taken ++)
+    {
+        blocks[taken] = mp_block(mp, code);
+        code = *(rt_uint32_t *)blocks[taken];
+    }
+    if (taken > 0)
+    {
+        mp->block_list = ((head | mp->block_mask) + 1) | code;
+        mp->block_free_count -= taken;
+    }
+    rt_hw_interrupt_enable(level);
+#endif
+
+    return taken;
+}
+
+/*
+ * put a chain of count blocks, linked from first to last already, on the
+ * free list. It never blocks and can be invoked in ISR.
+ */
+static void mp_push(struct rt_mempool *mp, rt_uint8_t *first, rt_uint8_t *last, rt_size_t count)
+{
+    rt_uint32_t head, code;
+#ifndef __riscv_atomic
+    register rt_base_t level;
+#endif
+
+    code = mp_code(mp, first);
+#ifdef __riscv_atomic
+    do
+    {
+        head = *(volatile rt_uint32_t *)&mp->block_list;
+        *(rt_uint32_t *)last = head & mp->block_mask;
+    } while (mp_cas(mp, head, ((head | mp->block_mask) + 1) | code) == RT_FALSE);
+
+    atomic_add_w(&mp->block_free_count, count);
+#else
+    level = rt_hw_interrupt_disable();
+    head = mp->block_list;
+    *(rt_uint32_t *)last = head & mp->block_mask;
+    mp->block_list = ((head | mp->block_mask) + 1) | code;
+    mp->block_free_count += count;
+    rt_hw_interrupt_enable(level);
+#endif
+}
+
+/* link all blocks of a pool into the free list */
+static void mp_list_init(struct rt_mempool *mp)
+{
+    rt_uint8_t *block_ptr;
+    register rt_size_t offset, stride;
+    rt_uint32_t mask;
+
+    stride    = mp->block_size + sizeof(rt_uint8_t *);
+    block_ptr = (rt_uint8_t *)mp->start_address;
+    for (offset = 0; offset + 1 < mp->block_total_count; offset ++)
+    {
+        *(rt_uint32_t *)(block_ptr + offset * stride) =
+            mp_code(mp, block_ptr + (offset + 1) * stride);
+    }
+    if (mp->block_total_count > 0)
+        *(rt_uint32_t *)(block_ptr + offset * stride) = 0;
+
+    /* the code of last block must fit under the mask */
+    for (mask = 1; mask < mp_code(mp, block_ptr + offset * stride); mask = (mask << 1) | 1)
+        ;
+    RT_ASSERT(mask <= MP_CODE_MASK_MAX);
+
+    mp->block_mask = mask;
+    mp->block_list = mp->block_total_count > 0 ? mp_code(mp, block_ptr) : 0;
+}
+
 /**
  * @addtogroup MM
  */
@@ -80,9 +241,6 @@ rt_err_t rt_mp_init(struct rt_mempool *mp,
                     rt_size_t          size,
                     rt_size_t          block_size)
 {
-    rt_uint8_t *block_ptr;
-    register rt_size_t offset;
-
     /* parameter check */
     RT_ASSERT(mp != RT_NULL);
 
@@ -106,17 +264,7 @@ rt_err_t rt_mp_init(struct rt_mempool *mp,
     mp->suspend_thread_count = 0;
 
     /* initialize free block list */
-    block_ptr = (rt_uint8_t *)mp->start_address;
-    for (offset = 0; offset < mp->block_total_count; offset ++)
-    {
-        *(rt_uint8_t **)(block_ptr + offset * (block_size + sizeof(rt_uint8_t *))) =
-            (rt_uint8_t *)(block_ptr + (offset + 1) * (block_size + sizeof(rt_uint8_t *)));
-    }
-
-    *(rt_uint8_t **)(block_ptr + (offset - 1) * (block_size + sizeof(rt_uint8_t *))) =
-        RT_NULL;
-
-    mp->block_list = block_ptr;
+    mp_list_init(mp);
 
     return RT_EOK;
 }
@@ -186,9 +334,7 @@ rt_mp_t rt_mp_create(const char *name,
                      rt_size_t   block_count,
                      rt_size_t   block_size)
 {
-    rt_uint8_t *block_ptr;
     struct rt_mempool *mp;
-    register rt_size_t offset;
 
     RT_DEBUG_NOT_IN_INTERRUPT;
 
@@ -222,17 +368,7 @@ rt_mp_t rt_mp_create(const char *name,
     mp->suspend_thread_count = 0;
 
     /* initialize free block list */
-    block_ptr = (rt_uint8_t *)mp->start_address;
-    for (offset = 0; offset < mp->block_total_count; offset ++)
-    {
-        *(rt_uint8_t **)(block_ptr + offset * (block_size + sizeof(rt_uint8_t *)))
-            = block_ptr + (offset + 1) * (block_size + sizeof(rt_uint8_t *));
-    }
-
-    *(rt_uint8_t **)(block_ptr + (offset - 1) * (block_size + sizeof(rt_uint8_t *)))
-        = RT_NULL;
-
-    mp->block_list = block_ptr;
+    mp_list_init(mp);
 
     return mp;
 }
@@ -294,7 +430,9 @@ RTM_EXPORT(rt_mp_delete);
 #endif
 
 /**
- * This function will allocate a block from memory pool
+ * This function will allocate a block from memory pool. A free block is
+ * taken without disabling interrupt, the thread is suspended only when the
+ * pool is empty and time is not zero.
  *
  * @param mp the memory pool object
  * @param time the waiting time
@@ -303,86 +441,81 @@ RTM_EXPORT(rt_mp_delete);
  */
 void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
 {
+    void *block;
     rt_uint8_t *block_ptr;
     register rt_base_t level;
     struct rt_thread *thread;
     rt_uint32_t before_sleep = 0;
 
-    /* get current thread */
-    thread = rt_thread_self();
+    if (mp_pop(mp, &block, 1) == 0)
+    {
+        /* get current thread */
+        thread = rt_thread_self();
 
-    /* disable interrupt */
-    level = rt_hw_interrupt_disable();
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
 
-    while (mp->block_free_count == 0)
-    {
-        /* memory block is unavailable. */
-        if (time == 0)
+        while (mp_pop(mp, &block, 1) == 0)
         {
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
+            /* memory block is unavailable. */
+            if (time == 0)
+            {
+                /* enable interrupt */
+                rt_hw_interrupt_enable(level);
 
-            rt_set_errno(-RT_ETIMEOUT);
+                rt_set_errno(-RT_ETIMEOUT);
 
-            return RT_NULL;
-        }
+                return RT_NULL;
+            }
 
-        RT_DEBUG_NOT_IN_INTERRUPT;
+            RT_DEBUG_NOT_IN_INTERRUPT;
 
-        thread->error = RT_EOK;
-
-        /* need suspend thread */
-        rt_thread_suspend(thread);
-        rt_list_insert_after(&(mp->suspend_thread), &(thread->tlist));
-        mp->suspend_thread_count++;
+            thread->error = RT_EOK;
 
-        if (time > 0)
-        {
-            /* get the start tick of timer */
-            before_sleep = rt_tick_get();
-
-            /* init thread timer and start it */
-            rt_timer_control(&(thread->thread_timer),
-                             RT_TIMER_CTRL_SET_TIME,
-                             &time);
-            rt_timer_start(&(thread->thread_timer));
-        }
+            /* need suspend thread */
+            rt_thread_suspend(thread);
+            rt_list_insert_after(&(mp->suspend_thread), &(thread->tlist));
+            mp->suspend_thread_count++;
 
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
+            if (time > 0)
+            {
+                /* get the start tick of timer */
+                before_sleep = rt_tick_get();
 
-        /* do a schedule */
-        rt_schedule();
+                /* init thread timer and start it */
+                rt_timer_control(&(thread->thread_timer),
+                                 RT_TIMER_CTRL_SET_TIME,
+                                 &time);
+                rt_timer_start(&(thread->thread_timer));
+            }
 
-        if (thread->error != RT_EOK)
-            return RT_NULL;
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
 
-        if (time > 0)
-        {
-            time -= rt_tick_get() - before_sleep;
-            if (time < 0)
-                time = 0;
-        }
-        /* disable interrupt */
-        level = rt_hw_interrupt_disable();
-    }
+            /* do a schedule */
+            rt_schedule();
 
-    /* memory block is available. decrease the free block counter */
-    mp->block_free_count--;
+            if (thread->error != RT_EOK)
+                return RT_NULL;
 
-    /* get block from block list */
-    block_ptr = mp->block_list;
-    RT_ASSERT(block_ptr != RT_NULL);
+            if (time > 0)
+            {
+                time -= rt_tick_get() - before_sleep;
+                if (time < 0)
+                    time = 0;
+            }
+            /* disable interrupt */
+            level = rt_hw_interrupt_disable();
+        }
 
-    /* Setup the next free node. */
-    mp->block_list = *(rt_uint8_t **)block_ptr;
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+    }
 
     /* point to memory pool */
+    block_ptr = (rt_uint8_t *)block;
     *(rt_uint8_t **)block_ptr = (rt_uint8_t *)mp;
 
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
-
     RT_OBJECT_HOOK_CALL(rt_mp_alloc_hook,
                         (mp, (rt_uint8_t *)(block_ptr + sizeof(rt_uint8_t *))));
 
@@ -390,35 +523,17 @@ void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
 }
 RTM_EXPORT(rt_mp_alloc);
 
-/**
- * This function will release a memory block
- *
- * @param block the address of memory block to be released
- */
-void rt_mp_free(void *block)
+/* resume up to count threads suspended on the memory pool */
+static void mp_resume(struct rt_mempool *mp, rt_size_t count)
 {
-    rt_uint8_t **block_ptr;
-    struct rt_mempool *mp;
     struct rt_thread *thread;
     register rt_base_t level;
-
-    /* get the control block of pool which the block belongs to */
-    block_ptr = (rt_uint8_t **)((rt_uint8_t *)block - sizeof(rt_uint8_t *));
-    mp        = (struct rt_mempool *)*block_ptr;
-
-    RT_OBJECT_HOOK_CALL(rt_mp_free_hook, (mp, block));
+    rt_bool_t resumed = RT_FALSE;
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    /* increase the free block count */
-    mp->block_free_count ++;
-
-    /* link the block into the block list */
-    *block_ptr = mp->block_list;
-    mp->block_list = (rt_uint8_t *)block_ptr;
-
-    if (mp->suspend_thread_count > 0)
+    while (count > 0 && mp->suspend_thread_count > 0)
     {
         /* get the suspended thread */
         thread = rt_list_entry(mp->suspend_thread.next,
@@ -433,20 +548,142 @@ void rt_mp_free(void *block)
 
         /* decrease suspended thread count */
         mp->suspend_thread_count --;
+        count --;
+        resumed = RT_TRUE;
+    }
 
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
 
-        /* do a schedule */
+    /* do a schedule */
+    if (resumed == RT_TRUE)
         rt_schedule();
+}
+
+/**
+ * This function will release a memory block. The block is put back without
+ * disabling interrupt unless a thread waits on the memory pool.
+ *
+ * @param block the address of memory block to be released
+ */
+void rt_mp_free(void *block)
+{
+    rt_uint8_t **block_ptr;
+    struct rt_mempool *mp;
+
+    /* get the control block of pool which the block belongs to */
+    block_ptr = (rt_uint8_t **)((rt_uint8_t *)block - sizeof(rt_uint8_t *));
+    mp        = (struct rt_mempool *)*block_ptr;
+
+    RT_OBJECT_HOOK_CALL(rt_mp_free_hook, (mp, block));
+
+    /* link the block into the block list */
+    mp_push(mp, (rt_uint8_t *)block_ptr, (rt_uint8_t *)block_ptr, 1);
+
+    /* a waiter suspends with interrupt disabled after the pool is found empty */
+    if (mp->suspend_thread_count > 0)
+        mp_resume(mp, 1);
+}
+RTM_EXPORT(rt_mp_free);
+
+/**
+ * This function will allocate up to count blocks from memory pool with a
+ * single update of the block list. The thread waits as rt_mp_alloc only when
+ * no block is free, then takes the blocks which are free at that time.
+ *
+ * @param mp the memory pool object
+ * @param blocks the array to hold the allocated blocks
+ * @param count the number of blocks wanted
+ * @param time the waiting time
+ *
+ * @return the number of allocated blocks, 0 on allocated failed
+ */
+rt_size_t rt_mp_alloc_batch(rt_mp_t mp, void **blocks, rt_size_t count, rt_int32_t time)
+{
+    rt_uint8_t *block_ptr;
+    rt_size_t index, first = 0, taken;
+
+    RT_ASSERT(mp != RT_NULL);
+    RT_ASSERT(blocks != RT_NULL);
+
+    if (count == 0)
+        return 0;
+
+    taken = mp_pop(mp, blocks, count);
+    if (taken == 0)
+    {
+        if (time == 0)
+        {
+            rt_set_errno(-RT_ETIMEOUT);
+
+            return 0;
+        }
+
+        blocks[0] = rt_mp_alloc(mp, time);
+        if (blocks[0] == RT_NULL)
+            return 0;
+
+        first = 1;
+        taken = 1 + mp_pop(mp, blocks + 1, count - 1);
+    }
 
+    for (index = first; index < taken; index ++)
+    {
+        /* point to memory pool */
+        block_ptr = (rt_uint8_t *)blocks[index];
+        *(rt_uint8_t **)block_ptr = (rt_uint8_t *)mp;
+        blocks[index] = block_ptr + sizeof(rt_uint8_t *);
+
+        RT_OBJECT_HOOK_CALL(rt_mp_alloc_hook, (mp, blocks[index]));
+    }
+
+    return taken;
+}
+RTM_EXPORT(rt_mp_alloc_batch);
+
+/**
+ * This function will release count blocks of one memory pool with a single
+ * update of the block list.
+ *
+ * @param blocks the array of blocks to be released, all from one memory pool
+ * @param count the number of blocks
+ */
+void rt_mp_free_batch(void **blocks, rt_size_t count)
+{
+    rt_uint8_t *block_ptr, *next_ptr;
+    struct rt_mempool *mp;
+    rt_size_t index;
+
+    RT_ASSERT(blocks != RT_NULL);
+
+    if (count == 0)
         return;
+
+    /* get the control block of pool which the blocks belong to */
+    block_ptr = (rt_uint8_t *)blocks[0] - sizeof(rt_uint8_t *);
+    mp        = (struct rt_mempool *)*(rt_uint8_t **)block_ptr;
+
+    /* chain the blocks in array order */
+    for (index = 0; index < count; index ++)
+    {
+        block_ptr = (rt_uint8_t *)blocks[index] - sizeof(rt_uint8_t *);
+        RT_ASSERT(*(struct rt_mempool **)block_ptr == mp);
+
+        RT_OBJECT_HOOK_CALL(rt_mp_free_hook, (mp, blocks[index]));
+
+        if (index + 1 < count)
+        {
+            next_ptr = (rt_uint8_t *)blocks[index + 1] - sizeof(rt_uint8_t *);
+            *(rt_uint32_t *)block_ptr = mp_code(mp, next_ptr);
+        }
     }
 
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
+    mp_push(mp, (rt_uint8_t *)blocks[0] - sizeof(rt_uint8_t *), block_ptr, count);
+
+    if (mp->suspend_thread_count > 0)
+        mp_resume(mp, count);
 }
-RTM_EXPORT(rt_mp_free);
+RTM_EXPORT(rt_mp_free_batch);
 
 /**@}*/
 
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Heap profiler
+ *
+ * Every heap backend reports its allocations and releases through
+ * RT_MEMPROF_ALLOC/RT_MEMPROF_FREE, which record the call site (return
+ * address of rt_malloc), the owner thread and the tick of each live block in
+ * a fixed hash table indexed by block address.
+ *
+ * The memprof command reports the top call sites by bytes and by count, a
+ * size histogram of live blocks, the largest free block and a fragmentation
+ * index of the heap. Call sites are printed as raw addresses, use
+ * tools/memprof.py with the firmware ELF to turn them into function names.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_HEAP) && defined (RT_USING_MEMPROF)
+
+/* live blocks tracked, must be power of 2 */
+#ifndef RT_MEMPROF_RECORDS
+#define RT_MEMPROF_RECORDS      128
+#endif
+
+/* distinct call sites in a report */
+#ifndef RT_MEMPROF_SITES
+#define RT_MEMPROF_SITES        32
+#endif
+
+#define MEMPROF_TOP             5
+#define MEMPROF_HIST_NR         9       /* <=16, <=32, ... <=2048, >2048 */
+
+#if (RT_MEMPROF_RECORDS & (RT_MEMPROF_RECORDS - 1)) != 0
+#error "RT_MEMPROF_RECORDS must be power of 2"
+#endif
+
+struct memprof_record
+{
+    void *ptr;                          /* RT_NULL for an empty slot */
+    void *caller;
+    rt_uint32_t size;
+    rt_tick_t tick;
+    char thread[RT_NAME_MAX];
+};
+
+struct memprof_site
+{
+    void *caller;
+    rt_uint32_t bytes;
+    rt_uint32_t count;
+};
+
+static struct memprof_record memprof_table[RT_MEMPROF_RECORDS];
+static rt_uint32_t memprof_live;        /* records in use */
+static rt_uint32_t memprof_dropped;     /* allocations not recorded, table full */
+
+static struct memprof_site memprof_site[RT_MEMPROF_SITES];
+
+rt_inline rt_uint32_t memprof_hash(void *ptr)
+{
+    rt_uint32_t key = (rt_uint32_t)ptr >> 3;
+
+    return (key ^ (key >> 9)) & (RT_MEMPROF_RECORDS - 1);
+}
+
+/* slot of ptr, or the empty slot where it can be inserted, -1 if full */
+static int memprof_lookup(void *ptr)
+{
+    rt_uint32_t index, probe;
+
+    index = memprof_hash(ptr);
+    for (probe = 0; probe < RT_MEMPROF_RECORDS; probe ++)
+    {
+        if (memprof_table[index].ptr == ptr ||
+            memprof_table[index].ptr == RT_NULL)
+            return index;
+
+        index = (index + 1) & (RT_MEMPROF_RECORDS - 1);
+    }
+
+    return -1;
+}
+
+/**
+ * This function will record an allocated block, it's invoked by the heap
+ * backends through RT_MEMPROF_ALLOC. Recording a block which is already
+ * recorded updates its size and call site (e.g. rt_calloc, rt_realloc).
+ *
+ * @param ptr the allocated block
+ * @param size the requested size
+ * @param caller the return address of the allocation function
+ */
+void rt_memprof_alloc(void *ptr, rt_size_t size, void *caller)
+{
+    register rt_base_t level;
+    struct memprof_record *record;
+    rt_thread_t thread;
+    int index;
+
+    if (ptr == RT_NULL)
+        return;
+
+    thread = rt_interrupt_get_nest() ? RT_NULL : rt_thread_self();
+
+    level = rt_hw_interrupt_disable();
+    index = memprof_lookup(ptr);
+    if (index < 0)
+    {
+        memprof_dropped ++;
+        rt_hw_interrupt_enable(level);
+
+        return;
+    }
+
+    record = &memprof_table[index];
+    if (record->ptr == RT_NULL)
+        memprof_live ++;
+
+    record->ptr    = ptr;
+    record->caller = caller;
+    record->size   = size;
+    record->tick   = rt_tick_get();
+    if (thread != RT_NULL)
+        rt_strncpy(record->thread, thread->name, RT_NAME_MAX);
+    else
+        rt_strncpy(record->thread, "-", RT_NAME_MAX);
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will forget a released block, it's invoked by the heap
+ * backends through RT_MEMPROF_FREE.
+ *
+ * @param ptr the released block
+ */
+void rt_memprof_free(void *ptr)
+{
+    register rt_base_t level;
+    rt_uint32_t hole, index, home, probe;
+    int slot;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    slot = memprof_lookup(ptr);
+    if (slot < 0 || memprof_table[slot].ptr == RT_NULL)
+    {
+        /* allocated before the table had room */
+        rt_hw_interrupt_enable(level);
+
+        return;
+    }
+
+    /* backward shift deletion keeps the probe chains intact */
+    hole  = slot;
+    index = (hole + 1) & (RT_MEMPROF_RECORDS - 1);
+    for (probe = 1; probe < RT_MEMPROF_RECORDS && memprof_table[index].ptr != RT_NULL; probe ++)
+    {
+        home = memprof_hash(memprof_table[index].ptr);
+
+        /* move the entry into the hole unless its home is in (hole, index] */
+        if (((index - home) & (RT_MEMPROF_RECORDS - 1)) >=
+            ((index - hole) & (RT_MEMPROF_RECORDS - 1)))
+        {
+            memprof_table[hole] = memprof_table[index];
+            hole = index;
+        }
+
+        index = (index + 1) & (RT_MEMPROF_RECORDS - 1);
+    }
+    memprof_table[hole].ptr = RT_NULL;
+    memprof_live --;
+
+    rt_hw_interrupt_enable(level);
+}
+
+/* collect call sites of live blocks, return the number of sites */
+static int memprof_collect(rt_uint32_t *hist, rt_uint32_t *bytes)
+{
+    struct memprof_record *record;
+    rt_uint32_t index, size;
+    int nr = 0, site, bucket;
+
+    rt_memset(hist, 0, sizeof(rt_uint32_t) * MEMPROF_HIST_NR);
+    *bytes = 0;
+
+    rt_enter_critical();
+    for (index = 0; index < RT_MEMPROF_RECORDS; index ++)
+    {
+        record = &memprof_table[index];
+        if (record->ptr == RT_NULL)
+            continue;
+
+        for (size = 16, bucket = 0; bucket < MEMPROF_HIST_NR - 1 && record->size > size; bucket ++)
+            size <<= 1;
+        hist[bucket] ++;
+        *bytes += record->size;
+
+        for (site = 0; site < nr; site ++)
+        {
+            if (memprof_site[site].caller == record->caller)
+                break;
+        }
+        if (site == nr)
+        {
+            /* too many sites, the rest is folded into the last one */
+            if (nr == RT_MEMPROF_SITES)
+                site = nr - 1;
+            else
+            {
+                memprof_site[site].caller = record->caller;
+                memprof_site[site].bytes  = 0;
+                memprof_site[site].count  = 0;
+                nr ++;
+            }
+        }
+        memprof_site[site].bytes += record->size;
+        memprof_site[site].count ++;
+    }
+    rt_exit_critical();
+
+    return nr;
+}
+
+/* print the top sites ordered by bytes (by_count == 0) or by count */
+static void memprof_top(int nr, int by_count)
+{
+    rt_uint8_t shown[RT_MEMPROF_SITES];
+    rt_uint32_t key, best_key;
+    int rank, site, best;
+
+    rt_memset(shown, 0, sizeof(shown));
+    for (rank = 0; rank < MEMPROF_TOP && rank < nr; rank ++)
+    {
+        best = -1;
+        best_key = 0;
+        for (site = 0; site < nr; site ++)
+        {
+            key = by_count ? memprof_site[site].count : memprof_site[site].bytes;
+            if (!shown[site] && (best < 0 || key > best_key))
+            {
+                best = site;
+                best_key = key;
+            }
+        }
+
+        shown[best] = 1;
+        rt_kprintf("  0x%08x %8d %6d\n",
+                   memprof_site[best].caller,
+                   memprof_site[best].bytes,
+                   memprof_site[best].count);
+    }
+}
+
+static void memprof_report(void)
+{
+    rt_uint32_t hist[MEMPROF_HIST_NR];
+    rt_uint32_t bytes, free, max_free;
+    int nr, bucket;
+
+    nr = memprof_collect(hist, &bytes);
+
+    rt_kprintf("memprof: %d live blocks, %d bytes requested, %d not tracked\n",
+               memprof_live, bytes, memprof_dropped);
+
+    rt_kprintf("\ntop sites by bytes:\n");
+    rt_kprintf("  caller        bytes  count\n");
+    memprof_top(nr, 0);
+
+    rt_kprintf("\ntop sites by count:\n");
+    rt_kprintf("  caller        bytes  count\n");
+    memprof_top(nr, 1);
+
+    rt_kprintf("\nsize histogram:\n");
+    for (bucket = 0; bucket < MEMPROF_HIST_NR; bucket ++)
+    {
+        if (bucket < MEMPROF_HIST_NR - 1)
+            rt_kprintf("  <= %4d: %d\n", 16 << bucket, hist[bucket]);
+        else
+            rt_kprintf("  >  %4d: %d\n", 16 << (bucket - 1), hist[bucket]);
+    }
+
+    rt_memory_free_info(&free, &max_free);
+    rt_kprintf("\nheap free %d, largest free block %d, fragmentation %d%%\n",
+               free, max_free, free ? 100 - (rt_uint32_t)((rt_uint64_t)max_free * 100 / free) : 0);
+}
+
+static void memprof_list(void)
+{
+    struct memprof_record record;
+    rt_uint32_t index;
+
+    rt_kprintf("caller     address    size     tick       thread\n");
+    rt_kprintf("---------- ---------- -------- ---------- --------\n");
+    for (index = 0; index < RT_MEMPROF_RECORDS; index ++)
+    {
+        /* take a consistent copy, the block may be freed meanwhile */
+        rt_enter_critical();
+        record = memprof_table[index];
+        rt_exit_critical();
+
+        if (record.ptr == RT_NULL)
+            continue;
+
+        rt_kprintf("0x%08x 0x%08x %8d %010d %.*s\n",
+                   record.caller, record.ptr, record.size, record.tick,
+                   RT_NAME_MAX, record.thread);
+    }
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+int memprof(int argc, char **argv)
+{
+    if (argc == 1)
+        memprof_report();
+    else if (argc == 2 && rt_strcmp(argv[1], "-l") == 0)
+        memprof_list();
+    else if (argc == 2 && rt_strcmp(argv[1], "-r") == 0)
+    {
+        register rt_base_t level;
+
+        level = rt_hw_interrupt_disable();
+        rt_memset(memprof_table, 0, sizeof(memprof_table));
+        memprof_live = 0;
+        memprof_dropped = 0;
+        rt_hw_interrupt_enable(level);
+    }
+    else
+    {
+        rt_kprintf("Usage: memprof [-l|-r]\n");
+        rt_kprintf("  -l  list live blocks\n");
+        rt_kprintf("  -r  forget recorded blocks\n");
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(memprof, heap profiler: memprof [-l|-r]);
+#endif
+
+#endif /* end of RT_USING_HEAP && RT_USING_MEMPROF */
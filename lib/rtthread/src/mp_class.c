@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Size class allocator on memory pools.
+ *
+ * A static arena is cut into pages, and each page in use is a rt_mempool of
+ * one size class (16 to 256 bytes). A request is routed to the smallest class
+ * which fits, by a count of leading zeros, and served by rt_mp_alloc from the
+ * first page of that class with a free block; larger requests and requests
+ * finding no page go to the system heap. Allocation and release are O(1),
+ * and a block never splits nor merges, so the pages don't fragment.
+ *
+ * Pages move between classes by demand. Each class counts its allocations,
+ * halved every RT_MP_CLASS_DECAY allocations. A page whose blocks are all
+ * free goes back to the arena unless it's the one spare page of a class in
+ * demand, and a class running out of pages takes a free page of the arena,
+ * or else the spare page of the class in least demand.
+ *
+ * The lists are guarded by the scheduler lock, as pages are set up with
+ * rt_mp_init, so like rt_malloc the allocator can't be used in ISR.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_HEAP) && defined (RT_USING_MEMPOOL) && defined (RT_USING_MP_CLASS)
+
+#ifndef RT_MP_CLASS_PAGE_SIZE
+#define RT_MP_CLASS_PAGE_SIZE           1024
+#endif
+
+#ifndef RT_MP_CLASS_PAGES
+#define RT_MP_CLASS_PAGES               8
+#endif
+
+/* allocations between two halvings of class demand */
+#ifndef RT_MP_CLASS_DECAY
+#define RT_MP_CLASS_DECAY               256
+#endif
+
+#define MP_CLASS_MIN_SHIFT              4       /* 16 bytes */
+#define MP_CLASS_NR                     5       /* up to 256 bytes */
+
+#if RT_MP_CLASS_PAGE_SIZE < 2 * ((1 << (MP_CLASS_MIN_SHIFT + MP_CLASS_NR - 1)) + 8)
+#error "RT_MP_CLASS_PAGE_SIZE must hold two blocks of the largest class"
+#endif
+
+struct mp_class_page
+{
+    struct rt_mempool mp;
+    rt_list_t list;                     /* on class list or free page list */
+    rt_int8_t class;                    /* owner class, -1 when free */
+};
+
+struct mp_class
+{
+    rt_size_t size;
+
+    rt_list_t pages;                    /* pages with free blocks, empty ones last */
+    rt_uint16_t page_count;             /* pages owned */
+    rt_uint16_t empty;                  /* pages owned with all blocks free */
+
+    rt_uint32_t demand;                 /* allocations, decayed */
+    rt_uint32_t alloc;
+    rt_uint32_t heap;                   /* allocations sent to heap, no page */
+};
+
+static struct mp_class mp_class[MP_CLASS_NR] =
+{
+    {16}, {32}, {64}, {128}, {256}
+};
+
+static struct mp_class_page mp_class_page[RT_MP_CLASS_PAGES];
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t mp_class_arena[RT_MP_CLASS_PAGES][RT_MP_CLASS_PAGE_SIZE];
+
+static rt_list_t mp_class_free;         /* pages of no class */
+static rt_uint32_t mp_class_ticks;      /* allocations since last decay */
+static rt_uint32_t mp_class_moves;      /* pages taken from another class */
+
+rt_inline int mp_class_index(rt_size_t size)
+{
+    if (size <= (1 << MP_CLASS_MIN_SHIFT))
+        return 0;
+
+    return 32 - __builtin_clz(size - 1) - MP_CLASS_MIN_SHIFT;
+}
+
+/* give a page of a class back to the arena, the scheduler is locked */
+static void mp_class_page_release(struct mp_class_page *page)
+{
+    mp_class[page->class].page_count --;
+
+    rt_mp_detach(&page->mp);
+    page->class = -1;
+    rt_list_insert_after(&mp_class_free, &page->list);
+}
+
+/* count an allocation of a class, the scheduler is locked */
+rt_inline void mp_class_account(struct mp_class *class)
+{
+    int index;
+
+    class->demand ++;
+    class->alloc ++;
+    if (++ mp_class_ticks == RT_MP_CLASS_DECAY)
+    {
+        for (index = 0; index < MP_CLASS_NR; index ++)
+            mp_class[index].demand >>= 1;
+        mp_class_ticks = 0;
+    }
+}
+
+/* find a page for a class which has none with free blocks, the scheduler is locked */
+static struct mp_class_page *mp_class_page_get(int index)
+{
+    struct mp_class_page *page;
+    struct mp_class *victim = RT_NULL;
+    char name[RT_NAME_MAX];
+    int other;
+
+    if (rt_list_isempty(&mp_class_free))
+    {
+        /* take the spare page of the class in least demand */
+        for (other = 0; other < MP_CLASS_NR; other ++)
+        {
+            if (other == index || mp_class[other].empty == 0)
+                continue;
+
+            if (victim == RT_NULL || mp_class[other].demand < victim->demand)
+                victim = &mp_class[other];
+        }
+        if (victim == RT_NULL)
+            return RT_NULL;
+
+        /* empty pages are at the tail */
+        page = rt_list_entry(victim->pages.prev, struct mp_class_page, list);
+        RT_ASSERT(page->mp.block_free_count == page->mp.block_total_count);
+
+        rt_list_remove(&page->list);
+        victim->empty --;
+        mp_class_page_release(page);
+        mp_class_moves ++;
+    }
+
+    page = rt_list_entry(mp_class_free.next, struct mp_class_page, list);
+    rt_list_remove(&page->list);
+
+    rt_snprintf(name, sizeof(name), "mpc%d", page - mp_class_page);
+    rt_mp_init(&page->mp, name, mp_class_arena[page - mp_class_page],
+               RT_MP_CLASS_PAGE_SIZE, mp_class[index].size);
+    page->class = index;
+
+    mp_class[index].page_count ++;
+    mp_class[index].empty ++;
+    rt_list_insert_after(&mp_class[index].pages, &page->list);
+
+    return page;
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will allocate a block from the smallest size class which
+ * fits, or from the system heap for larger sizes and when no page of the
+ * size class is left.
+ *
+ * @param size the size of memory to be allocated
+ *
+ * @return the allocated memory block or RT_NULL on allocated failed
+ */
+void *rt_mp_class_malloc(rt_size_t size)
+{
+    struct mp_class_page *page;
+    struct mp_class *class;
+    void *block;
+    int index;
+
+    if (size == 0)
+        return RT_NULL;
+
+    index = mp_class_index(size);
+    if (index >= MP_CLASS_NR)
+        return rt_malloc(size);
+
+    class = &mp_class[index];
+
+    rt_enter_critical();
+    mp_class_account(class);
+
+    if (!rt_list_isempty(&class->pages))
+        page = rt_list_entry(class->pages.next, struct mp_class_page, list);
+    else
+    {
+        page = mp_class_page_get(index);
+        if (page == RT_NULL)
+        {
+            class->heap ++;
+            rt_exit_critical();
+
+            return rt_malloc(size);
+        }
+    }
+
+    if (page->mp.block_free_count == page->mp.block_total_count)
+        class->empty --;
+
+    block = rt_mp_alloc(&page->mp, 0);
+    RT_ASSERT(block != RT_NULL);
+
+    /* full pages are off the list until a block is released */
+    if (page->mp.block_free_count == 0)
+        rt_list_remove(&page->list);
+    rt_exit_critical();
+
+    return block;
+}
+RTM_EXPORT(rt_mp_class_malloc);
+
+/**
+ * This function will release a block allocated by rt_mp_class_malloc.
+ *
+ * @param ptr the block to be released
+ */
+void rt_mp_class_free(void *ptr)
+{
+    struct mp_class_page *page;
+    struct mp_class *class;
+    rt_uint8_t *block = (rt_uint8_t *)ptr;
+
+    if (block == RT_NULL)
+        return;
+
+    if (block < &mp_class_arena[0][0] ||
+        block >= &mp_class_arena[0][0] + sizeof(mp_class_arena))
+    {
+        rt_free(ptr);
+
+        return;
+    }
+
+    page  = &mp_class_page[(block - &mp_class_arena[0][0]) / RT_MP_CLASS_PAGE_SIZE];
+    RT_ASSERT(page->class >= 0);
+    class = &mp_class[page->class];
+
+    rt_enter_critical();
+    if (page->mp.block_free_count == 0)
+        rt_list_insert_after(&class->pages, &page->list);
+
+    rt_mp_free(ptr);
+
+    if (page->mp.block_free_count == page->mp.block_total_count)
+    {
+        rt_list_remove(&page->list);
+
+        /* keep one spare page while the class is in demand */
+        if (class->empty > 0 || class->demand == 0)
+            mp_class_page_release(page);
+        else
+        {
+            class->empty ++;
+            rt_list_insert_before(&class->pages, &page->list);
+        }
+    }
+    rt_exit_critical();
+}
+RTM_EXPORT(rt_mp_class_free);
+
+/**@}*/
+
+/**
+ * This function will put all pages of the arena on the free page list.
+ */
+int rt_mp_class_init(void)
+{
+    int index;
+
+    rt_list_init(&mp_class_free);
+    for (index = 0; index < RT_MP_CLASS_PAGES; index ++)
+    {
+        mp_class_page[index].class = -1;
+        rt_list_insert_before(&mp_class_free, &mp_class_page[index].list);
+    }
+
+    for (index = 0; index < MP_CLASS_NR; index ++)
+        rt_list_init(&mp_class[index].pages);
+
+    return 0;
+}
+INIT_BOARD_EXPORT(rt_mp_class_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_mp_class(void)
+{
+    struct mp_class info[MP_CLASS_NR];
+    rt_uint32_t free[MP_CLASS_NR], total[MP_CLASS_NR];
+    rt_uint32_t free_pages, moves;
+    int index, class;
+
+    rt_memset(free, 0, sizeof(free));
+    rt_memset(total, 0, sizeof(total));
+
+    /* take a consistent copy, print it afterwards */
+    rt_enter_critical();
+    rt_memcpy(info, mp_class, sizeof(info));
+    for (index = 0; index < RT_MP_CLASS_PAGES; index ++)
+    {
+        class = mp_class_page[index].class;
+        if (class < 0)
+            continue;
+
+        free[class]  += mp_class_page[index].mp.block_free_count;
+        total[class] += mp_class_page[index].mp.block_total_count;
+    }
+    free_pages = rt_list_len(&mp_class_free);
+    moves = mp_class_moves;
+    rt_exit_critical();
+
+    rt_kprintf("size pages free/total demand alloc      heap\n");
+    rt_kprintf("---- ----- ---------- ------ ---------- ----------\n");
+    for (index = 0; index < MP_CLASS_NR; index ++)
+    {
+        rt_kprintf("%4d %5d %4d/%-5d %6d %010d %010d\n",
+                   info[index].size, info[index].page_count,
+                   free[index], total[index], info[index].demand,
+                   info[index].alloc, info[index].heap);
+    }
+    rt_kprintf("free pages: %d/%d of %d bytes, moved between classes: %d\n",
+               free_pages, RT_MP_CLASS_PAGES, RT_MP_CLASS_PAGE_SIZE, moves);
+}
+MSH_CMD_EXPORT(list_mp_class, list size class allocator usage information);
+#endif
+
+#endif /* end of RT_USING_HEAP && RT_USING_MEMPOOL && RT_USING_MP_CLASS */
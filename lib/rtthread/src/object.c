@@ -53,6 +53,9 @@ enum rt_object_info_type
     RT_Object_Info_Device,                             /**< The object is a device */
 #endif
     RT_Object_Info_Timer,                              /**< The object is a timer. */
+#ifdef RT_USING_TOPIC
+    RT_Object_Info_Topic,                              /**< The object is a topic. */
+#endif
 #ifdef RT_USING_MODULE
     RT_Object_Info_Module,                             /**< The object is a module. */
 #endif
@@ -99,12 +102,383 @@ static struct rt_object_information rt_object_container[RT_Object_Info_Unknown]
 #endif
     /* initialize object container - timer */
     {RT_Object_Class_Timer, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Timer), sizeof(struct rt_timer)},
+#ifdef RT_USING_TOPIC
+    /* initialize object container - topic */
+    {RT_Object_Class_Topic, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Topic), sizeof(struct rt_topic)},
+#endif
 #ifdef RT_USING_MODULE
     /* initialize object container - module */
     {RT_Object_Class_Module, _OBJ_CONTAINER_LIST_INIT(RT_Object_Info_Module), sizeof(struct rt_dlmodule)},
 #endif
 };
 
+#if defined(RT_USING_HEAP) && defined(RT_USING_OBJECT_CACHE)
+/*
+ * Object caches
+ *
+ * rt_object_allocate takes the objects of thread, timer and IPC classes from
+ * a static pool of each class before falling back to RT_KERNEL_MALLOC, and
+ * rt_object_delete gives them back to the pool. Both are O(1): a released
+ * object is pushed on the free list of its pool, using its first word as the
+ * link, and never used objects are handed out in address order.
+ *
+ * The buffers of these objects, thread stacks and mailbox, message queue and
+ * topic pools, are of any size and stay on the heap, but the last
+ * RT_OBJECT_CACHE_BUFFER ones released are kept instead of freed. An object
+ * created again with the same size takes its buffer back without a trip
+ * through the heap, so create/delete churn doesn't fragment it.
+ */
+#ifndef RT_OBJECT_CACHE_THREAD
+#define RT_OBJECT_CACHE_THREAD          4
+#endif
+#ifndef RT_OBJECT_CACHE_TIMER
+#define RT_OBJECT_CACHE_TIMER           4
+#endif
+#ifndef RT_OBJECT_CACHE_SEMAPHORE
+#define RT_OBJECT_CACHE_SEMAPHORE       4
+#endif
+#ifndef RT_OBJECT_CACHE_MUTEX
+#define RT_OBJECT_CACHE_MUTEX           2
+#endif
+#ifndef RT_OBJECT_CACHE_EVENT
+#define RT_OBJECT_CACHE_EVENT           2
+#endif
+#ifndef RT_OBJECT_CACHE_MAILBOX
+#define RT_OBJECT_CACHE_MAILBOX         2
+#endif
+#ifndef RT_OBJECT_CACHE_MESSAGEQUEUE
+#define RT_OBJECT_CACHE_MESSAGEQUEUE    2
+#endif
+#ifndef RT_OBJECT_CACHE_BUFFER
+#define RT_OBJECT_CACHE_BUFFER          4
+#endif
+
+struct rt_object_cache
+{
+    rt_uint8_t *pool;                   /* objects of the pool */
+    rt_uint16_t count;                  /* number of objects in pool */
+    rt_uint16_t used;                   /* objects ever handed out */
+    void *free_list;                    /* objects given back */
+
+    rt_uint16_t nfree;                  /* objects available */
+    rt_uint16_t min_free;               /* low water mark of available objects */
+    rt_uint32_t miss;                   /* allocations fell back to heap */
+};
+
+#if RT_OBJECT_CACHE_THREAD > 0
+static struct rt_thread _thread_cache[RT_OBJECT_CACHE_THREAD];
+#endif
+#if RT_OBJECT_CACHE_TIMER > 0
+static struct rt_timer _timer_cache[RT_OBJECT_CACHE_TIMER];
+#endif
+#if defined(RT_USING_SEMAPHORE) && RT_OBJECT_CACHE_SEMAPHORE > 0
+static struct rt_semaphore _sem_cache[RT_OBJECT_CACHE_SEMAPHORE];
+#endif
+#if defined(RT_USING_MUTEX) && RT_OBJECT_CACHE_MUTEX > 0
+static struct rt_mutex _mutex_cache[RT_OBJECT_CACHE_MUTEX];
+#endif
+#if defined(RT_USING_EVENT) && RT_OBJECT_CACHE_EVENT > 0
+static struct rt_event _event_cache[RT_OBJECT_CACHE_EVENT];
+#endif
+#if defined(RT_USING_MAILBOX) && RT_OBJECT_CACHE_MAILBOX > 0
+static struct rt_mailbox _mb_cache[RT_OBJECT_CACHE_MAILBOX];
+#endif
+#if defined(RT_USING_MESSAGEQUEUE) && RT_OBJECT_CACHE_MESSAGEQUEUE > 0
+static struct rt_messagequeue _mq_cache[RT_OBJECT_CACHE_MESSAGEQUEUE];
+#endif
+
+#define _OBJ_CACHE_INIT(pool)           \
+    {(rt_uint8_t *)(pool), sizeof(pool) / sizeof(pool[0]), 0, RT_NULL, \
+     sizeof(pool) / sizeof(pool[0]), sizeof(pool) / sizeof(pool[0]), 0}
+static struct rt_object_cache rt_object_cache[RT_Object_Info_Unknown] =
+{
+#if RT_OBJECT_CACHE_THREAD > 0
+    [RT_Object_Info_Thread]         = _OBJ_CACHE_INIT(_thread_cache),
+#endif
+#if RT_OBJECT_CACHE_TIMER > 0
+    [RT_Object_Info_Timer]          = _OBJ_CACHE_INIT(_timer_cache),
+#endif
+#if defined(RT_USING_SEMAPHORE) && RT_OBJECT_CACHE_SEMAPHORE > 0
+    [RT_Object_Info_Semaphore]      = _OBJ_CACHE_INIT(_sem_cache),
+#endif
+#if defined(RT_USING_MUTEX) && RT_OBJECT_CACHE_MUTEX > 0
+    [RT_Object_Info_Mutex]          = _OBJ_CACHE_INIT(_mutex_cache),
+#endif
+#if defined(RT_USING_EVENT) && RT_OBJECT_CACHE_EVENT > 0
+    [RT_Object_Info_Event]          = _OBJ_CACHE_INIT(_event_cache),
+#endif
+#if defined(RT_USING_MAILBOX) && RT_OBJECT_CACHE_MAILBOX > 0
+    [RT_Object_Info_MailBox]        = _OBJ_CACHE_INIT(_mb_cache),
+#endif
+#if defined(RT_USING_MESSAGEQUEUE) && RT_OBJECT_CACHE_MESSAGEQUEUE > 0
+    [RT_Object_Info_MessageQueue]   = _OBJ_CACHE_INIT(_mq_cache),
+#endif
+};
+
+/* take an object from the cache of class, RT_NULL if it's empty */
+static struct rt_object *rt_object_cache_alloc(struct rt_object_information *information)
+{
+    register rt_base_t temp;
+    struct rt_object_cache *cache;
+    struct rt_object *object = RT_NULL;
+
+    cache = &rt_object_cache[information - rt_object_container];
+    if (cache->count == 0)
+        return RT_NULL;
+
+    temp = rt_hw_interrupt_disable();
+    if (cache->free_list != RT_NULL)
+    {
+        object = (struct rt_object *)cache->free_list;
+        cache->free_list = *(void **)object;
+    }
+    else if (cache->used < cache->count)
+    {
+        object = (struct rt_object *)(cache->pool + cache->used * information->object_size);
+        cache->used ++;
+    }
+
+    if (object != RT_NULL)
+    {
+        cache->nfree --;
+        if (cache->nfree < cache->min_free)
+            cache->min_free = cache->nfree;
+    }
+    else
+    {
+        cache->miss ++;
+    }
+    rt_hw_interrupt_enable(temp);
+
+    return object;
+}
+
+/* released buffers, replaced round robin when all are taken */
+static struct
+{
+    void *buffer;
+    rt_size_t size;
+} rt_object_buffer[RT_OBJECT_CACHE_BUFFER];
+static rt_uint16_t rt_object_buffer_next;
+static rt_uint32_t rt_object_buffer_hit, rt_object_buffer_miss;
+
+/**
+ * This function will allocate the buffer of a kernel object, a kept buffer
+ * of the same size if there is one.
+ *
+ * @param size the size of buffer
+ *
+ * @return the buffer, RT_NULL if there is no memory even with all kept
+ *         buffers freed
+ */
+void *rt_object_buffer_alloc(rt_size_t size)
+{
+    register rt_base_t temp;
+    void *buffer = RT_NULL;
+    int index;
+
+    temp = rt_hw_interrupt_disable();
+    for (index = 0; index < RT_OBJECT_CACHE_BUFFER; index ++)
+    {
+        if (rt_object_buffer[index].buffer != RT_NULL &&
+            rt_object_buffer[index].size == size)
+        {
+            buffer = rt_object_buffer[index].buffer;
+            rt_object_buffer[index].buffer = RT_NULL;
+            break;
+        }
+    }
+    if (buffer != RT_NULL)
+        rt_object_buffer_hit ++;
+    else
+        rt_object_buffer_miss ++;
+    rt_hw_interrupt_enable(temp);
+
+    if (buffer == RT_NULL)
+        buffer = RT_KERNEL_MALLOC(size);
+    if (buffer == RT_NULL)
+    {
+        /* out of memory, give the kept buffers back to heap and try again */
+        for (index = 0; index < RT_OBJECT_CACHE_BUFFER; index ++)
+        {
+            temp = rt_hw_interrupt_disable();
+            buffer = rt_object_buffer[index].buffer;
+            rt_object_buffer[index].buffer = RT_NULL;
+            rt_hw_interrupt_enable(temp);
+
+            if (buffer != RT_NULL)
+                RT_KERNEL_FREE(buffer);
+        }
+
+        buffer = RT_KERNEL_MALLOC(size);
+    }
+
+    return buffer;
+}
+
+/**
+ * This function will release the buffer of a kernel object. It's kept for
+ * the next object of the same size, the oldest kept one is freed instead.
+ *
+ * @param buffer the buffer
+ * @param size the size of buffer, as allocated
+ */
+void rt_object_buffer_free(void *buffer, rt_size_t size)
+{
+    register rt_base_t temp;
+    void *evict;
+    int index;
+
+    if (buffer == RT_NULL)
+        return;
+
+    temp = rt_hw_interrupt_disable();
+    for (index = 0; index < RT_OBJECT_CACHE_BUFFER; index ++)
+    {
+        if (rt_object_buffer[index].buffer == RT_NULL)
+            break;
+    }
+    if (index == RT_OBJECT_CACHE_BUFFER)
+    {
+        index = rt_object_buffer_next;
+        rt_object_buffer_next = (index + 1) % RT_OBJECT_CACHE_BUFFER;
+    }
+
+    evict = rt_object_buffer[index].buffer;
+    rt_object_buffer[index].buffer = buffer;
+    rt_object_buffer[index].size   = size;
+    rt_hw_interrupt_enable(temp);
+
+    if (evict != RT_NULL)
+        RT_KERNEL_FREE(evict);
+}
+
+/* give an object back to the cache of class, RT_FALSE if it's not from there */
+static rt_bool_t rt_object_cache_free(struct rt_object_information *information,
+                                      struct rt_object *object)
+{
+    register rt_base_t temp;
+    struct rt_object_cache *cache;
+
+    cache = &rt_object_cache[information - rt_object_container];
+    if ((rt_uint8_t *)object < cache->pool ||
+        (rt_uint8_t *)object >= cache->pool + cache->count * information->object_size)
+        return RT_FALSE;
+
+    temp = rt_hw_interrupt_disable();
+    *(void **)object = cache->free_list;
+    cache->free_list = object;
+    cache->nfree ++;
+    rt_hw_interrupt_enable(temp);
+
+    return RT_TRUE;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_obj_cache(void)
+{
+    static const char *const name[] =
+    {
+        "thread", "sem", "mutex", "event", "mailbox", "msgqueue", "timer"
+    };
+    static const enum rt_object_class_type type[] =
+    {
+        RT_Object_Class_Thread, RT_Object_Class_Semaphore, RT_Object_Class_Mutex,
+        RT_Object_Class_Event, RT_Object_Class_MailBox, RT_Object_Class_MessageQueue,
+        RT_Object_Class_Timer
+    };
+    struct rt_object_information *information;
+    struct rt_object_cache *cache;
+    int index;
+
+    rt_kprintf("class    total free min  miss\n");
+    rt_kprintf("-------- ----- ---- ---- ----------\n");
+    for (index = 0; index < sizeof(type) / sizeof(type[0]); index ++)
+    {
+        information = rt_object_get_information(type[index]);
+        if (information == RT_NULL)
+            continue;
+
+        cache = &rt_object_cache[information - rt_object_container];
+        if (cache->count == 0)
+            continue;
+
+        rt_kprintf("%-8s %5d %4d %4d %010d\n", name[index],
+                   cache->count, cache->nfree, cache->min_free, cache->miss);
+    }
+
+    rt_kprintf("\nbuffer   size\n");
+    rt_kprintf("-------- ----------\n");
+    for (index = 0; index < RT_OBJECT_CACHE_BUFFER; index ++)
+    {
+        if (rt_object_buffer[index].buffer != RT_NULL)
+            rt_kprintf("%08x %10d\n", rt_object_buffer[index].buffer, rt_object_buffer[index].size);
+    }
+    rt_kprintf("buffer reused %d, allocated %d\n", rt_object_buffer_hit, rt_object_buffer_miss);
+}
+MSH_CMD_EXPORT(list_obj_cache, list kernel object cache usage);
+#endif
+#endif
+
+#ifdef RT_USING_OBJECT_HASH
+/*
+ * Object name index
+ *
+ * rt_object_find hashes the class and the name (RT_NAME_MAX bytes at most, as
+ * compared) into a table shared by all classes. A bucket chains its objects
+ * through hash_next, the newest first as in the class list, so a duplicated
+ * name finds the same object as a walk of the list did. Objects of modules are
+ * not in the class lists and not in the index either. The table is changed
+ * with interrupts disabled, as the class lists.
+ */
+#ifndef RT_OBJECT_HASH_SIZE
+#define RT_OBJECT_HASH_SIZE             64
+#endif
+
+#if RT_OBJECT_HASH_SIZE & (RT_OBJECT_HASH_SIZE - 1)
+#error "RT_OBJECT_HASH_SIZE must be a power of 2"
+#endif
+
+static struct rt_object *rt_object_hash[RT_OBJECT_HASH_SIZE];
+
+/* FNV-1a of class and name */
+static struct rt_object **rt_object_hash_bucket(const char *name, rt_uint8_t type)
+{
+    rt_uint32_t hash = 2166136261UL;
+    int index;
+
+    hash = (hash ^ (type & ~RT_Object_Class_Static)) * 16777619UL;
+    for (index = 0; index < RT_NAME_MAX && name[index] != '\0'; index ++)
+        hash = (hash ^ (rt_uint8_t)name[index]) * 16777619UL;
+
+    return &rt_object_hash[(hash ^ (hash >> 16)) & (RT_OBJECT_HASH_SIZE - 1)];
+}
+
+/* interrupts are disabled */
+rt_inline void rt_object_hash_insert(struct rt_object *object)
+{
+    struct rt_object **bucket = rt_object_hash_bucket(object->name, object->type);
+
+    object->hash_next = *bucket;
+    *bucket = object;
+}
+
+/* interrupts are disabled, bucket is taken before the type is reset */
+rt_inline void rt_object_hash_remove(struct rt_object **bucket, struct rt_object *object)
+{
+    for (; *bucket != RT_NULL; bucket = &(*bucket)->hash_next)
+    {
+        if (*bucket == object)
+        {
+            *bucket = object->hash_next;
+            break;
+        }
+    }
+}
+#endif
+
 #ifdef RT_USING_HOOK
 static void (*rt_object_attach_hook)(struct rt_object *object);
 static void (*rt_object_detach_hook)(struct rt_object *object);
@@ -289,6 +663,9 @@ void rt_object_init(struct rt_object         *object,
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        rt_object_hash_insert(object);
+#endif
     }
 
     /* unlock interrupt */
@@ -304,12 +681,19 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object **bucket;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = rt_object_hash_bucket(object->name, object->type);
+#endif
+
     /* reset object type */
     object->type = 0;
 
@@ -318,6 +702,9 @@ void rt_object_detach(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    rt_object_hash_remove(bucket, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -347,7 +734,13 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     information = rt_object_get_information(type);
     RT_ASSERT(information != RT_NULL);
 
+#ifdef RT_USING_OBJECT_CACHE
+    object = rt_object_cache_alloc(information);
+    if (object == RT_NULL)
+        object = (struct rt_object *)RT_KERNEL_MALLOC(information->object_size);
+#else
     object = (struct rt_object *)RT_KERNEL_MALLOC(information->object_size);
+#endif
     if (object == RT_NULL)
     {
         /* no memory can be allocated */
@@ -384,6 +777,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        rt_object_hash_insert(object);
+#endif
     }
 
     /* unlock interrupt */
@@ -401,13 +797,28 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_CACHE
+    struct rt_object_information *information;
+#endif
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object **bucket;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
     RT_ASSERT(!(object->type & RT_Object_Class_Static));
 
+#ifdef RT_USING_OBJECT_CACHE
+    information = rt_object_get_information((enum rt_object_class_type)object->type);
+    RT_ASSERT(information != RT_NULL);
+#endif
+
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = rt_object_hash_bucket(object->name, object->type);
+#endif
+
     /* reset object type */
     object->type = 0;
 
@@ -416,10 +827,18 @@ void rt_object_delete(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    rt_object_hash_remove(bucket, object);
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
 
+#ifdef RT_USING_OBJECT_CACHE
+    if (rt_object_cache_free(information, object) == RT_TRUE)
+        return;
+#endif
+
     /* free the memory of object */
     RT_KERNEL_FREE(object);
 }
@@ -476,8 +895,13 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
 rt_object_t rt_object_find(const char *name, rt_uint8_t type)
 {
     struct rt_object *object = RT_NULL;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object **bucket;
+    register rt_base_t temp;
+#else
     struct rt_list_node *node = RT_NULL;
     struct rt_object_information *information = RT_NULL;
+#endif
 
     /* parameter check */
     if ((name == RT_NULL) || (type > RT_Object_Class_Unknown))
@@ -486,6 +910,21 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     /* which is invoke in interrupt status */
     RT_DEBUG_NOT_IN_INTERRUPT;
 
+#ifdef RT_USING_OBJECT_HASH
+    bucket = rt_object_hash_bucket(name, type);
+
+    /* only the chain of one bucket is walked with interrupts disabled */
+    temp = rt_hw_interrupt_disable();
+    for (object = *bucket; object != RT_NULL; object = object->hash_next)
+    {
+        if ((object->type & ~RT_Object_Class_Static) == type &&
+            rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+            break;
+    }
+    rt_hw_interrupt_enable(temp);
+
+    return object;
+#else
     /* enter critical */
     rt_enter_critical();
 
@@ -513,6 +952,7 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     rt_exit_critical();
 
     return RT_NULL;
+#endif
 }
 
 /**@}*/
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Protothread runner
+ *
+ * One kernel thread resumes every protothread which is ready, timed out, or
+ * polls a condition, then sleeps on a semaphore until the earliest timeout.
+ * rt_pt_notify releases the semaphore to start a new round at once. While a
+ * protothread polls a condition the sleep is bounded by RT_PT_POLL_TICKS, so
+ * producers which don't notify are still noticed.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtpt.h>
+
+#ifdef RT_USING_PT
+
+#ifndef RT_PT_THREAD_PRIO
+#define RT_PT_THREAD_PRIO               10
+#endif
+
+#ifndef RT_PT_THREAD_STACK_SIZE
+#define RT_PT_THREAD_STACK_SIZE         1024
+#endif
+
+/* longest sleep while a protothread polls a condition */
+#ifndef RT_PT_POLL_TICKS
+#define RT_PT_POLL_TICKS                10
+#endif
+
+static rt_list_t pt_list;                       /* owned by the runner */
+static rt_list_t pt_start_list;                 /* started, not yet taken by the runner */
+
+static struct rt_semaphore pt_sem;
+static volatile rt_base_t pt_pending;
+
+static struct rt_thread pt_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t pt_thread_stack[RT_PT_THREAD_STACK_SIZE];
+
+/**
+ * This function is invoked by RT_PT_xxx wait macros to set up a wait.
+ *
+ * @param pt the protothread
+ * @param timeout the timeout in ticks, RT_WAITING_FOREVER for none
+ * @param poll whether the condition is polled at each wakeup
+ */
+void rt_pt_wait_prepare(struct rt_pt *pt, rt_int32_t timeout, rt_uint8_t poll)
+{
+    pt->poll = poll;
+    if (timeout < 0)
+        pt->timed = 0;
+    else
+    {
+        pt->timed  = 1;
+        pt->wakeup = rt_tick_get() + timeout;
+    }
+}
+RTM_EXPORT(rt_pt_wait_prepare);
+
+/**
+ * This function is invoked by RT_PT_xxx wait macros to check the timeout.
+ *
+ * @param pt the protothread
+ *
+ * @return RT_TRUE if the wait has timed out
+ */
+rt_bool_t rt_pt_timeout(struct rt_pt *pt)
+{
+    if (!pt->timed)
+        return RT_FALSE;
+
+    return (rt_int32_t)(rt_tick_get() - pt->wakeup) >= 0 ? RT_TRUE : RT_FALSE;
+}
+RTM_EXPORT(rt_pt_timeout);
+
+/**
+ * This function will initialize a protothread, the function is resumed by
+ * the runner once the protothread is started up.
+ *
+ * @param pt the protothread
+ * @param name the name of protothread
+ * @param entry the protothread function
+ * @param parameter the parameter of protothread, available as pt->parameter
+ */
+void rt_pt_init(struct rt_pt *pt,
+                const char   *name,
+                int (*entry)(struct rt_pt *pt),
+                void         *parameter)
+{
+    RT_ASSERT(pt != RT_NULL);
+    RT_ASSERT(entry != RT_NULL);
+
+    rt_list_init(&pt->list);
+    pt->name      = name;
+    pt->entry     = entry;
+    pt->parameter = parameter;
+    pt->lc        = 0;
+    pt->stat      = RT_PT_EXITED;
+    pt->poll      = 0;
+    pt->timed     = 0;
+    pt->result    = RT_EOK;
+}
+RTM_EXPORT(rt_pt_init);
+
+/**
+ * This function will hand a protothread over to the runner. It never blocks
+ * and can be invoked in ISR.
+ *
+ * @param pt the protothread
+ *
+ * @return the operation status, -RT_EBUSY if the protothread is running
+ */
+rt_err_t rt_pt_startup(struct rt_pt *pt)
+{
+    register rt_base_t level;
+
+    RT_ASSERT(pt != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (pt->stat != RT_PT_EXITED)
+    {
+        rt_hw_interrupt_enable(level);
+
+        return -RT_EBUSY;
+    }
+
+    pt->lc   = 0;
+    pt->stat = RT_PT_YIELDED;
+    rt_list_insert_before(&pt_start_list, &pt->list);
+    rt_hw_interrupt_enable(level);
+
+    rt_pt_notify();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_pt_startup);
+
+/**
+ * This function will have the runner resume waiting protothreads at once.
+ * It should be invoked after releasing or sending to a kernel object a
+ * protothread waits for. It never blocks and can be invoked in ISR.
+ */
+void rt_pt_notify(void)
+{
+    register rt_base_t level;
+    rt_bool_t kick = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (!pt_pending)
+    {
+        pt_pending = 1;
+        kick = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (kick == RT_TRUE)
+        rt_sem_release(&pt_sem);
+}
+RTM_EXPORT(rt_pt_notify);
+
+static void pt_thread_entry(void *parameter)
+{
+    struct rt_pt *pt;
+    register rt_base_t level;
+    rt_list_t *node, *next;
+    rt_int32_t sleep, left;
+    rt_tick_t now;
+    int stat;
+
+    while (1)
+    {
+        /* notifications from now on need another round */
+        pt_pending = 0;
+
+        level = rt_hw_interrupt_disable();
+        while (!rt_list_isempty(&pt_start_list))
+        {
+            node = pt_start_list.next;
+            rt_list_remove(node);
+            rt_list_insert_before(&pt_list, node);
+        }
+        rt_hw_interrupt_enable(level);
+
+        sleep = RT_WAITING_FOREVER;
+        for (node = pt_list.next; node != &pt_list; node = next)
+        {
+            next = node->next;
+            pt = rt_list_entry(node, struct rt_pt, list);
+
+            if (pt->stat == RT_PT_YIELDED || pt->poll || rt_pt_timeout(pt))
+            {
+                stat = pt->entry(pt);
+                if (stat == RT_PT_EXITED)
+                {
+                    /* it can be started up again once off the list */
+                    level = rt_hw_interrupt_disable();
+                    rt_list_remove(&pt->list);
+                    pt->stat = RT_PT_EXITED;
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+                pt->stat = stat;
+            }
+
+            if (pt->stat == RT_PT_YIELDED)
+                sleep = 0;
+            else
+            {
+                if (pt->poll && (sleep < 0 || sleep > RT_PT_POLL_TICKS))
+                    sleep = RT_PT_POLL_TICKS;
+                if (pt->timed)
+                {
+                    now  = rt_tick_get();
+                    left = (rt_int32_t)(pt->wakeup - now);
+                    if (left < 0)
+                        left = 0;
+                    if (sleep < 0 || left < sleep)
+                        sleep = left;
+                }
+            }
+        }
+
+        if (sleep == 0)
+            rt_thread_yield();
+        else
+            rt_sem_take(&pt_sem, sleep);
+    }
+}
+
+/**
+ * This function will start the protothread runner.
+ */
+int rt_pt_system_init(void)
+{
+    rt_list_init(&pt_list);
+    rt_list_init(&pt_start_list);
+
+    rt_sem_init(&pt_sem, "pt", 0, RT_IPC_FLAG_FIFO);
+    pt_pending = 0;
+
+    rt_thread_init(&pt_thread,
+                   "pt",
+                   pt_thread_entry,
+                   RT_NULL,
+                   &pt_thread_stack[0],
+                   sizeof(pt_thread_stack),
+                   RT_PT_THREAD_PRIO,
+                   10);
+    rt_thread_startup(&pt_thread);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(rt_pt_system_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_pt(void)
+{
+    struct rt_pt *pt;
+    register rt_base_t level;
+    rt_list_t *node;
+    rt_tick_t now;
+    int starting;
+
+    rt_kprintf("pt       stat    line  wakeup in\n");
+    rt_kprintf("-------- ------- ----- ----------\n");
+
+    now = rt_tick_get();
+    rt_enter_critical();
+    for (node = pt_list.next; node != &pt_list; node = node->next)
+    {
+        pt = rt_list_entry(node, struct rt_pt, list);
+
+        rt_kprintf("%-8.*s ", RT_NAME_MAX, pt->name);
+        if (pt->stat == RT_PT_YIELDED)   rt_kprintf("ready   ");
+        else if (pt->poll)               rt_kprintf("polling ");
+        else                             rt_kprintf("waiting ");
+        rt_kprintf("%05d ", pt->lc);
+        if (pt->timed && pt->stat == RT_PT_WAITING)
+            rt_kprintf("%d\n", (rt_int32_t)(pt->wakeup - now));
+        else
+            rt_kprintf("-\n");
+    }
+    rt_exit_critical();
+
+    level = rt_hw_interrupt_disable();
+    starting = rt_list_len(&pt_start_list);
+    rt_hw_interrupt_enable(level);
+    if (starting)
+        rt_kprintf("%d protothread(s) starting\n", starting);
+}
+FINSH_FUNCTION_EXPORT(list_pt, list protothreads);
+MSH_CMD_EXPORT(list_pt, list protothreads);
+#endif
+
+#endif /* end of RT_USING_PT */
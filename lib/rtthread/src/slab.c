@@ -221,48 +221,135 @@ static struct memusage *memusage = RT_NULL;
 
 static rt_uint32_t heap_start, heap_end;
 
-/* page allocator */
+/*
+ * page allocator
+ *
+ * A binary buddy allocator. The pages after memusage and page_order arrays
+ * are managed in blocks of 2^order pages, with one free list per order. A
+ * block of order k always starts at a page index (counted from page_base,
+ * the first page after the arrays) which is a multiple of 2^k, so its buddy
+ * is found by flipping bit k of the index. Both allocation and release take
+ * at most PAGE_ORDER_MAX split or merge steps.
+ *
+ * Requests that are not a power of two take the smallest block that fits
+ * and give the tail back right away, so rt_page_free(addr, npages) always
+ * releases exactly the pages which were allocated.
+ */
+#define PAGE_ORDER_MAX      12              /* largest block, 2^12 pages */
+#define PAGE_ORDER_FREE     0x80            /* page_order[]: head of a free block */
+
 struct rt_page_head
 {
-    struct rt_page_head *next;      /* next valid page */
-    rt_size_t page;                 /* number of page  */
+    rt_list_t list;                 /* free list of the same order */
 
     /* dummy */
-    char dummy[RT_MM_PAGE_SIZE - (sizeof(struct rt_page_head *) + sizeof(rt_size_t))];
+    char dummy[RT_MM_PAGE_SIZE - sizeof(rt_list_t)];
 };
-static struct rt_page_head *rt_page_list;
+static rt_list_t rt_page_list[PAGE_ORDER_MAX + 1];
+static rt_uint8_t *page_order;      /* order of free block heads, per page */
+static rt_uint32_t page_base;       /* address of the first buddy page */
+static rt_uint32_t page_total;      /* pages managed by buddy allocator */
+static rt_uint32_t page_free_cnt;   /* free pages */
 static struct rt_semaphore heap_sem;
 
+#define page_index(addr)    (((rt_uint32_t)(addr) - page_base) >> RT_MM_PAGE_BITS)
+#define page_addr(index)    ((struct rt_page_head *)(page_base + ((index) << RT_MM_PAGE_BITS)))
+
+/* insert a free block, merged with its buddies as far as possible */
+static void rt_page_insert(rt_uint32_t index, rt_uint32_t order)
+{
+    rt_uint32_t buddy;
+
+    while (order < PAGE_ORDER_MAX)
+    {
+        buddy = index ^ (1UL << order);
+        if (buddy + (1UL << order) > page_total ||
+            page_order[buddy] != (PAGE_ORDER_FREE | order))
+            break;
+
+        /* merge with buddy */
+        rt_list_remove(&page_addr(buddy)->list);
+        page_order[buddy] = 0;
+
+        index &= ~(1UL << order);
+        order ++;
+    }
+
+    page_order[index] = PAGE_ORDER_FREE | order;
+    rt_list_insert_after(&rt_page_list[order], &page_addr(index)->list);
+}
+
+/* release the pages [index, index + npages) as naturally aligned blocks */
+static void rt_page_insert_range(rt_uint32_t index, rt_uint32_t npages)
+{
+    rt_uint32_t order, end = index + npages;
+
+    while (index < end)
+    {
+        for (order = PAGE_ORDER_MAX; order > 0; order --)
+        {
+            if ((index & ((1UL << order) - 1)) == 0 &&
+                index + (1UL << order) <= end)
+                break;
+        }
+
+        rt_page_insert(index, order);
+        index += 1UL << order;
+    }
+
+    page_free_cnt += npages;
+}
+
 void *rt_page_alloc(rt_size_t npages)
 {
-    struct rt_page_head *b, *n;
-    struct rt_page_head **prev;
+    struct rt_page_head *b;
+    rt_uint32_t index, want, order;
 
     if (npages == 0)
         return RT_NULL;
 
+    /* smallest order which holds npages */
+    for (want = 0; want <= PAGE_ORDER_MAX && (1UL << want) < npages; want ++)
+        ;
+    if (want > PAGE_ORDER_MAX)
+        return RT_NULL;
+
     /* lock heap */
     rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-    for (prev = &rt_page_list; (b = *prev) != RT_NULL; prev = &(b->next))
+    for (order = want; order <= PAGE_ORDER_MAX; order ++)
     {
-        if (b->page > npages)
-        {
-            /* splite pages */
-            n       = b + npages;
-            n->next = b->next;
-            n->page = b->page - npages;
-            *prev   = n;
+        if (!rt_list_isempty(&rt_page_list[order]))
             break;
-        }
+    }
 
-        if (b->page == npages)
-        {
-            /* this node fit, remove this node */
-            *prev = b->next;
-            break;
-        }
+    if (order > PAGE_ORDER_MAX)
+    {
+        /* unlock heap */
+        rt_sem_release(&heap_sem);
+
+        return RT_NULL;
     }
 
+    b = rt_list_entry(rt_page_list[order].next, struct rt_page_head, list);
+    rt_list_remove(&b->list);
+    index = page_index(b);
+    page_order[index] = 0;
+    page_free_cnt -= 1UL << order;
+
+    /* split down to the wanted order, upper halves go back to free lists */
+    while (order > want)
+    {
+        order --;
+        page_order[index + (1UL << order)] = PAGE_ORDER_FREE | order;
+        rt_list_insert_after(&rt_page_list[order],
+                             &page_addr(index + (1UL << order))->list);
+        page_free_cnt += 1UL << order;
+    }
+
+    /* give back the tail which is not requested */
+    if (npages < (1UL << want))
+        rt_page_insert_range(index + npages, (1UL << want) - npages);
+
     /* unlock heap */
     rt_sem_release(&heap_sem);
 
@@ -271,52 +358,59 @@ void *rt_page_alloc(rt_size_t npages)
 
 void rt_page_free(void *addr, rt_size_t npages)
 {
-    struct rt_page_head *b, *n;
-    struct rt_page_head **prev;
-
     RT_ASSERT(addr != RT_NULL);
     RT_ASSERT((rt_uint32_t)addr % RT_MM_PAGE_SIZE == 0);
     RT_ASSERT(npages != 0);
+    RT_ASSERT((rt_uint32_t)addr >= page_base);
+    RT_ASSERT(page_index(addr) + npages <= page_total);
+
+    /* lock heap */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+    rt_page_insert_range(page_index(addr), npages);
+
+    /* unlock heap */
+    rt_sem_release(&heap_sem);
+}
+
+/**
+ * This function will get the page allocator information.
+ *
+ * @param total the number of pages managed by page allocator
+ * @param free the number of free pages
+ * @param max_free the number of pages of the largest free block
+ * @param zone the number of pages of a slab zone
+ */
+void rt_page_info(rt_uint32_t *total, rt_uint32_t *free, rt_uint32_t *max_free,
+                  rt_uint32_t *zone)
+{
+    rt_int32_t order;
+
+    if (total != RT_NULL)
+        *total = page_total;
 
-    n = (struct rt_page_head *)addr;
+    if (zone != RT_NULL)
+        *zone = zone_page_cnt;
 
     /* lock heap */
     rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
 
-    for (prev = &rt_page_list; (b = *prev) != RT_NULL; prev = &(b->next))
-    {
-        RT_ASSERT(b->page > 0);
-        RT_ASSERT(b > n || b + b->page <= n);
+    if (free != RT_NULL)
+        *free = page_free_cnt;
 
-        if (b + b->page == n)
+    if (max_free != RT_NULL)
+    {
+        *max_free = 0;
+        for (order = PAGE_ORDER_MAX; order >= 0; order --)
         {
-            if (b + (b->page += npages) == b->next)
+            if (!rt_list_isempty(&rt_page_list[order]))
             {
-                b->page += b->next->page;
-                b->next  = b->next->next;
+                *max_free = 1UL << order;
+                break;
             }
-
-            goto _return;
-        }
-
-        if (b == n + npages)
-        {
-            n->page = b->page + npages;
-            n->next = b->next;
-            *prev   = n;
-
-            goto _return;
         }
-
-        if (b > n + npages)
-            break;
     }
 
-    n->page = npages;
-    n->next = b;
-    *prev   = n;
-
-_return:
     /* unlock heap */
     rt_sem_release(&heap_sem);
 }
@@ -329,8 +423,10 @@ static void rt_page_init(void *addr, rt_size_t npages)
     RT_ASSERT(addr != RT_NULL);
     RT_ASSERT(npages != 0);
 
-    rt_page_list = RT_NULL;
-    rt_page_free(addr, npages);
+    page_base     = (rt_uint32_t)addr;
+    page_total    = npages;
+    page_free_cnt = 0;
+    rt_page_insert_range(0, npages);
 }
 
 /**
@@ -343,10 +439,19 @@ static void rt_page_init(void *addr, rt_size_t npages)
  */
 void rt_system_heap_init(void *begin_addr, void *end_addr)
 {
-    rt_uint32_t limsize, npages;
+    rt_uint32_t limsize, npages, order;
 
     RT_DEBUG_NOT_IN_INTERRUPT;
 
+    /* an empty page allocator, should the heap be unusable */
+    for (order = 0; order <= PAGE_ORDER_MAX; order ++)
+        rt_list_init(&rt_page_list[order]);
+    page_total    = 0;
+    page_free_cnt = 0;
+
+    /* initialize heap semaphore */
+    rt_sem_init(&heap_sem, "heap", 1, RT_IPC_FLAG_FIFO);
+
     /* align begin and end addr to page */
     heap_start = RT_ALIGN((rt_uint32_t)begin_addr, RT_MM_PAGE_SIZE);
     heap_end   = RT_ALIGN_DOWN((rt_uint32_t)end_addr, RT_MM_PAGE_SIZE);
@@ -362,15 +467,9 @@ void rt_system_heap_init(void *begin_addr, void *end_addr)
     limsize = heap_end - heap_start;
     npages  = limsize / RT_MM_PAGE_SIZE;
 
-    /* initialize heap semaphore */
-    rt_sem_init(&heap_sem, "heap", 1, RT_IPC_FLAG_FIFO);
-
     RT_DEBUG_LOG(RT_DEBUG_SLAB, ("heap[0x%x - 0x%x], size 0x%x, 0x%x pages\n",
                                  heap_start, heap_end, limsize, npages));
 
-    /* init pages */
-    rt_page_init((void *)heap_start, npages);
-
     /* calculate zone size */
     zone_size = ZALLOC_MIN_ZONE_SIZE;
     while (zone_size < ZALLOC_MAX_ZONE_SIZE && (zone_size << 1) < (limsize / 1024))
@@ -385,13 +484,38 @@ void rt_system_heap_init(void *begin_addr, void *end_addr)
     RT_DEBUG_LOG(RT_DEBUG_SLAB, ("zone size 0x%x, zone page count 0x%x\n",
                                  zone_size, zone_page_cnt));
 
-    /* allocate memusage array */
-    limsize  = npages * sizeof(struct memusage);
-    limsize  = RT_ALIGN(limsize, RT_MM_PAGE_SIZE);
-    memusage = rt_page_alloc(limsize / RT_MM_PAGE_SIZE);
+    /* memusage and page order arrays are at the beginning of heap */
+    limsize    = npages * (sizeof(struct memusage) + sizeof(rt_uint8_t));
+    limsize    = RT_ALIGN(limsize, RT_MM_PAGE_SIZE);
+    if (limsize / RT_MM_PAGE_SIZE >= npages)
+    {
+        rt_kprintf("rt_system_heap_init, heap too small[0x%x - 0x%x]\n",
+                   (rt_uint32_t)begin_addr, (rt_uint32_t)end_addr);
+
+        return;
+    }
+
+    memusage   = (struct memusage *)heap_start;
+    page_order = (rt_uint8_t *)(memusage + npages);
+    rt_memset(memusage, 0, limsize);
 
     RT_DEBUG_LOG(RT_DEBUG_SLAB, ("memusage 0x%x, size 0x%x\n",
                                  (rt_uint32_t)memusage, limsize));
+
+    /* init pages */
+    rt_page_init((void *)(heap_start + limsize), npages - limsize / RT_MM_PAGE_SIZE);
+
+    /* the largest block is the largest power of 2 in page_total, a zone must fit in it */
+    for (order = 0; order < PAGE_ORDER_MAX && (2UL << order) <= page_total; order ++)
+        ;
+    if (zone_page_cnt > (1 << order))
+    {
+        zone_page_cnt = 1 << order;
+        zone_size     = zone_page_cnt * RT_MM_PAGE_SIZE;
+        zone_limit    = zone_size / 4;
+
+        RT_DEBUG_LOG(RT_DEBUG_SLAB, ("zone size 0x%x for small heap\n", zone_size));
+    }
 }
 
 /*
@@ -666,113 +790,18 @@ rt_inline int zoneindex(rt_size_t *bytes)
 //     return chunk;
 // }
 
-//简化版内存池缓存
-#define SMALL_CACHE_SIZE 4
-#define SMALL_CACHE_THRESHOLD 128 // 小于这个尺寸的内存块使用缓存
-
-// 定义小内存块缓存
-static struct {
-    void* cache[SMALL_CACHE_SIZE];
-    rt_size_t sizes[SMALL_CACHE_SIZE];
-    rt_uint8_t used;
-} small_cache = {0};
-
-void *rt_malloc(rt_size_t size)
+/*
+ * Allocate a chunk from the zone list zi, heap_sem must be held by caller.
+ * The lock is dropped while a new zone is taken from the page allocator, it
+ * is always held again when this function returns.
+ */
+static slab_chunk *slab_zone_alloc(rt_int32_t zi, rt_size_t size)
 {
     slab_zone *z;
-    rt_int32_t zi;
     slab_chunk *chunk;
     struct memusage *kup;
 
-    /* 1. 处理特殊情况：零尺寸 */
-    if (size == 0)
-        return RT_NULL;
-        
-    /* 2. 小内存优化：检查缓存 */
-    if (size <= SMALL_CACHE_THRESHOLD) 
-    {
-        rt_base_t level;
-        /* 临界区保护 */
-        level = rt_hw_interrupt_disable();
-        
-        /* 检查缓存中是否有合适尺寸的块 */
-        for (int i = 0; i < small_cache.used; i++) 
-        {
-            if (small_cache.sizes[i] >= size) 
-            {
-                void* ptr = small_cache.cache[i];
-                
-                /* 将后面的缓存条目前移 */
-                if (i < small_cache.used - 1) {
-                    rt_memmove(&small_cache.cache[i], &small_cache.cache[i+1], 
-                           (small_cache.used - i - 1) * sizeof(void*));
-                    rt_memmove(&small_cache.sizes[i], &small_cache.sizes[i+1], 
-                           (small_cache.used - i - 1) * sizeof(rt_size_t));
-                }
-                
-                small_cache.used--;
-                rt_hw_interrupt_enable(level);
-                return ptr;
-            }
-        }
-        rt_hw_interrupt_enable(level);
-    }
-
-    /* 3. 大内存分配 */
-    if (size >= zone_limit)
-    {
-        size = RT_ALIGN(size, RT_MM_PAGE_SIZE);
-
-        /* 快速失败：过大内存请求预检查 */
-        if (size > (heap_end - heap_start) / 2) {
-            return RT_NULL;  // 请求超过堆空间的一半，直接拒绝
-        }
-
-        chunk = rt_page_alloc(size >> RT_MM_PAGE_BITS);
-        if (chunk == RT_NULL)
-            return RT_NULL;
-
-        /* 设置内存使用信息 */
-        kup = btokup(chunk);
-        kup->type = PAGE_TYPE_LARGE;
-        kup->size = size >> RT_MM_PAGE_BITS;
-
-        RT_DEBUG_LOG(RT_DEBUG_SLAB,
-                     ("malloc a large memory 0x%x, page cnt %d, kup %d\n",
-                      size,
-                      size >> RT_MM_PAGE_BITS,
-                      ((rt_uint32_t)chunk - heap_start) >> RT_MM_PAGE_BITS));
-
-        /* 锁定堆，仅用于更新统计信息 */
-        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
-#ifdef RT_MEM_STATS
-        used_mem += size;
-        if (used_mem > max_mem)
-            max_mem = used_mem;
-#endif
-        rt_sem_release(&heap_sem);
-        RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
-        return chunk;
-    }
-
-    /* 4. 常见尺寸优化 */
-    /* 对常见尺寸使用快速路径 */
-    switch (size) {
-        case 8:  zi = 0; size = 8; break;   // 8字节
-        case 16: zi = 1; size = 16; break;  // 16字节
-        case 32: zi = 2; size = 32; break;  // 32字节
-        case 64: zi = 3; size = 64; break;  // 64字节
-        case 128: zi = 4; size = 128; break; // 128字节
-        default:
-            /* 其他尺寸使用标准计算方法 */
-            zi = zoneindex(&size);
-    }
-    
-    /* 锁定堆进行分配 */
-    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
-    /* 5. 从现有区间分配 */
+    /* 从现有区间分配 */
     if ((z = zone_array[zi]) != RT_NULL)
     {
         RT_ASSERT(z->z_nfree > 0);
@@ -809,12 +838,10 @@ void *rt_malloc(rt_size_t size)
             max_mem = used_mem;
 #endif
 
-        rt_sem_release(&heap_sem);
-        RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
         return chunk;
     }
 
-    /* 6. 分配新区间 */
+    /* 分配新区间 */
     {
         rt_int32_t off;
 
@@ -831,14 +858,13 @@ void *rt_malloc(rt_size_t size)
 
             /* 从页面分配器获取新区间 */
             z = rt_page_alloc(zone_size / RT_MM_PAGE_SIZE);
-            if (z == RT_NULL)
-            {
-                return RT_NULL;
-            }
 
             /* 重新锁定堆 */
             rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
 
+            if (z == RT_NULL)
+                return RT_NULL;
+
             RT_DEBUG_LOG(RT_DEBUG_SLAB, ("alloc a new zone: 0x%x\n",
                                          (rt_uint32_t)z));
 
@@ -887,11 +913,304 @@ void *rt_malloc(rt_size_t size)
 #endif
     }
 
-    rt_sem_release(&heap_sem);
-    RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
     return chunk;
 }
 
+/*
+ * Return a chunk to its zone, heap_sem must be held by caller. The lock is
+ * dropped while a whole free zone is given back to the page allocator, it is
+ * always held again when this function returns.
+ */
+static void slab_zone_free(slab_zone *z, slab_chunk *chunk)
+{
+    struct memusage *kup;
+
+    chunk->c_next  = z->z_freechunk;
+    z->z_freechunk = chunk;
+
+#ifdef RT_MEM_STATS
+    used_mem -= z->z_chunksize;
+#endif
+
+    /*
+     * Bump the number of free chunks.  If it becomes non-zero the zone
+     * must be added back onto the appropriate list.
+     */
+    if (z->z_nfree++ == 0)
+    {
+        z->z_next = zone_array[z->z_zoneindex];
+        zone_array[z->z_zoneindex] = z;
+    }
+
+    /*
+     * If the zone becomes totally free, and there are other zones we
+     * can allocate from, move this zone to the FreeZones list.  Since
+     * this code can be called from an IPI callback, do *NOT* try to mess
+     * with kernel_map here.  Hysteresis will be performed at malloc() time.
+     */
+    if (z->z_nfree == z->z_nmax &&
+        (z->z_next || zone_array[z->z_zoneindex] != z))
+    {
+        slab_zone **pz;
+
+        RT_DEBUG_LOG(RT_DEBUG_SLAB, ("free zone 0x%x\n",
+                                     (rt_uint32_t)z, z->z_zoneindex));
+
+        /* remove zone from zone array list */
+        for (pz = &zone_array[z->z_zoneindex]; z != *pz; pz = &(*pz)->z_next)
+            ;
+        *pz = z->z_next;
+
+        /* reset zone */
+        z->z_magic = -1;
+
+        /* insert to free zone list */
+        z->z_next = zone_free;
+        zone_free = z;
+
+        ++ zone_free_cnt;
+
+        /* release zone to page allocator */
+        if (zone_free_cnt > ZONE_RELEASE_THRESH)
+        {
+            register rt_base_t i;
+
+            z         = zone_free;
+            zone_free = z->z_next;
+            -- zone_free_cnt;
+
+            /* set message usage */
+            for (i = 0, kup = btokup(z); i < zone_page_cnt; i ++)
+            {
+                kup->type = PAGE_TYPE_FREE;
+                kup->size = 0;
+                kup ++;
+            }
+
+            /* unlock heap */
+            rt_sem_release(&heap_sem);
+
+            /* release pages */
+            rt_page_free(z, zone_size / RT_MM_PAGE_SIZE);
+
+            /* lock heap again */
+            rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+        }
+    }
+}
+
+#ifdef RT_USING_SLAB_MAGAZINE
+/*
+ * Per-thread magazines
+ *
+ * Each thread keeps up to RT_SLAB_MAG_SIZE free chunks of every one of the
+ * first RT_SLAB_MAG_ZONES zones (8..64 bytes) in its thread control block.
+ * Only the owner thread touches its magazines, so malloc and free of these
+ * sizes are served without heap_sem. An empty magazine is refilled with
+ * half of RT_SLAB_MAG_SIZE chunks and a full one gives back half of them,
+ * both under a single heap_sem acquisition.
+ *
+ * The chunks held in magazines are still accounted as used memory, they are
+ * given back to the zones when the thread exits, is detached or deleted.
+ */
+#define SLAB_MAG_BATCH      (RT_SLAB_MAG_SIZE / 2)
+
+/* statistics, updated without lock and may lose a few counts */
+static rt_uint32_t slab_mag_hit;        /* requests served by magazines */
+static rt_uint32_t slab_mag_exchange;   /* heap_sem taken to refill or drain */
+
+rt_inline rt_thread_t slab_mag_owner(void)
+{
+    if (rt_interrupt_get_nest() != 0)
+        return RT_NULL;
+
+    return rt_thread_self();
+}
+
+/* fill the empty magazine of zone zi with chunks of size bytes */
+static void slab_mag_fill(rt_thread_t thread, rt_int32_t zi, rt_size_t size)
+{
+    slab_chunk *chunk;
+
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    while (thread->slab_mag_cnt[zi] < SLAB_MAG_BATCH)
+    {
+        chunk = slab_zone_alloc(zi, size);
+        if (chunk == RT_NULL)
+            break;
+
+        chunk->c_next = (slab_chunk *)thread->slab_mag[zi];
+        thread->slab_mag[zi] = chunk;
+        thread->slab_mag_cnt[zi] ++;
+    }
+    slab_mag_exchange ++;
+    rt_sem_release(&heap_sem);
+}
+
+/* give chunks of magazine zi back to zones until count is left, lock held */
+static void slab_mag_drain(rt_thread_t thread, rt_int32_t zi, rt_uint8_t count)
+{
+    slab_chunk *chunk;
+    struct memusage *kup;
+
+    while (thread->slab_mag_cnt[zi] > count)
+    {
+        chunk = (slab_chunk *)thread->slab_mag[zi];
+        thread->slab_mag[zi] = chunk->c_next;
+        thread->slab_mag_cnt[zi] --;
+
+        kup = btokup((rt_uint32_t)chunk & ~RT_MM_PAGE_MASK);
+        slab_zone_free((slab_zone *)(((rt_uint32_t)chunk & ~RT_MM_PAGE_MASK) -
+                                     kup->size * RT_MM_PAGE_SIZE), chunk);
+    }
+}
+
+/**
+ * This function will give all chunks cached in the magazines of a thread
+ * back to the slab zones. It's invoked when the thread exits, is detached
+ * or deleted.
+ *
+ * @param thread the thread
+ */
+void rt_slab_mag_flush(rt_thread_t thread)
+{
+    rt_int32_t zi;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    for (zi = 0; zi < RT_SLAB_MAG_ZONES; zi ++)
+        slab_mag_drain(thread, zi, 0);
+    rt_sem_release(&heap_sem);
+}
+
+/**
+ * This function will get the statistics of per-thread magazines.
+ *
+ * @param hit the number of requests served without heap lock
+ * @param exchange the number of heap lock acquisitions to refill or drain
+ */
+void rt_slab_mag_info(rt_uint32_t *hit, rt_uint32_t *exchange)
+{
+    if (hit != RT_NULL)
+        *hit = slab_mag_hit;
+
+    if (exchange != RT_NULL)
+        *exchange = slab_mag_exchange;
+}
+#endif
+
+/**
+ * This function will allocate a block from system heap memory.
+ * - If the nbytes is less than zero,
+ * or
+ * - If there is no nbytes sized memory valid in system,
+ * the RT_NULL is returned.
+ *
+ * @param size the size of memory to be allocated
+ *
+ * @return the allocated memory
+ */
+void *rt_malloc(rt_size_t size)
+{
+    rt_int32_t zi;
+    slab_chunk *chunk;
+    struct memusage *kup;
+#ifdef RT_USING_SLAB_MAGAZINE
+    rt_thread_t thread;
+#endif
+
+    /* 1. 处理特殊情况：零尺寸 */
+    if (size == 0)
+        return RT_NULL;
+
+    /* 2. 大内存分配 */
+    if (size >= zone_limit)
+    {
+        size = RT_ALIGN(size, RT_MM_PAGE_SIZE);
+
+        /* 快速失败：过大内存请求预检查 */
+        if (size > (heap_end - heap_start) / 2) {
+            return RT_NULL;  // 请求超过堆空间的一半，直接拒绝
+        }
+
+        chunk = rt_page_alloc(size >> RT_MM_PAGE_BITS);
+        if (chunk == RT_NULL)
+            return RT_NULL;
+
+        /* 设置内存使用信息 */
+        kup = btokup(chunk);
+        kup->type = PAGE_TYPE_LARGE;
+        kup->size = size >> RT_MM_PAGE_BITS;
+
+        RT_DEBUG_LOG(RT_DEBUG_SLAB,
+                     ("malloc a large memory 0x%x, page cnt %d, kup %d\n",
+                      size,
+                      size >> RT_MM_PAGE_BITS,
+                      ((rt_uint32_t)chunk - heap_start) >> RT_MM_PAGE_BITS));
+
+        /* 锁定堆，仅用于更新统计信息 */
+        rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+
+#ifdef RT_MEM_STATS
+        used_mem += size;
+        if (used_mem > max_mem)
+            max_mem = used_mem;
+#endif
+        rt_sem_release(&heap_sem);
+        RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
+        RT_MEMPROF_ALLOC(chunk, size);
+        return chunk;
+    }
+
+    /* 3. 常见尺寸优化 */
+    /* 对常见尺寸使用快速路径, 区间号与 zoneindex() 的结果一致 */
+    switch (size) {
+        case 8:  zi = 0; break;     // 8字节
+        case 16: zi = 1; break;     // 16字节
+        case 32: zi = 3; break;     // 32字节
+        case 64: zi = 7; break;     // 64字节
+        case 128: zi = 15; break;   // 128字节
+        default:
+            /* 其他尺寸使用标准计算方法 */
+            zi = zoneindex(&size);
+    }
+
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* 4. 小尺寸优先从本线程的 magazine 分配, 不需要锁 */
+    if (zi < RT_SLAB_MAG_ZONES && (thread = slab_mag_owner()) != RT_NULL)
+    {
+        if (thread->slab_mag_cnt[zi] == 0)
+            slab_mag_fill(thread, zi, size);
+        else
+            slab_mag_hit ++;
+
+        chunk = (slab_chunk *)thread->slab_mag[zi];
+        if (chunk != RT_NULL)
+        {
+            thread->slab_mag[zi] = chunk->c_next;
+            thread->slab_mag_cnt[zi] --;
+
+            RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
+            RT_MEMPROF_ALLOC(chunk, size);
+        }
+
+        return chunk;
+    }
+#endif
+
+    /* 5. 锁定堆从区间分配 */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+    chunk = slab_zone_alloc(zi, size);
+    rt_sem_release(&heap_sem);
+
+    if (chunk != RT_NULL)
+    {
+        RT_OBJECT_HOOK_CALL(rt_malloc_hook, ((char *)chunk, size));
+        RT_MEMPROF_ALLOC(chunk, size);
+    }
+    return chunk;
+}
 RTM_EXPORT(rt_malloc);
 /**
  * This function will change the size of previously allocated memory block.
@@ -930,6 +1249,7 @@ void *rt_realloc(void *ptr, rt_size_t size)
             return RT_NULL;
         rt_memcpy(nptr, ptr, size > osize ? osize : size);
         rt_free(ptr);
+        RT_MEMPROF_ALLOC(nptr, size);
 
         return nptr;
     }
@@ -941,7 +1261,10 @@ void *rt_realloc(void *ptr, rt_size_t size)
 
         zoneindex(&size);
         if (z->z_chunksize == size)
+        {
+            RT_MEMPROF_ALLOC(ptr, size);
             return (ptr); /* same chunk */
+        }
 
         /*
          * Allocate memory for the new request size.  Note that zoneindex has
@@ -953,6 +1276,7 @@ void *rt_realloc(void *ptr, rt_size_t size)
 
         rt_memcpy(nptr, ptr, size > z->z_chunksize ? z->z_chunksize : size);
         rt_free(ptr);
+        RT_MEMPROF_ALLOC(nptr, size);
 
         return nptr;
     }
@@ -982,7 +1306,10 @@ void *rt_calloc(rt_size_t count, rt_size_t size)
 
     /* zero the memory */
     if (p)
+    {
         rt_memset(p, 0, count * size);
+        RT_MEMPROF_ALLOC(p, count * size);
+    }
 
     return p;
 }
@@ -997,14 +1324,17 @@ RTM_EXPORT(rt_calloc);
 void rt_free(void *ptr)
 {
     slab_zone *z;
-    slab_chunk *chunk;
     struct memusage *kup;
+#ifdef RT_USING_SLAB_MAGAZINE
+    rt_thread_t thread;
+#endif
 
     /* free a RT_NULL pointer */
     if (ptr == RT_NULL)
         return ;
 
     RT_OBJECT_HOOK_CALL(rt_free_hook, (ptr));
+    RT_MEMPROF_FREE(ptr);
 
     /* get memory usage */
 #if RT_DEBUG_SLAB
@@ -1045,91 +1375,64 @@ void rt_free(void *ptr)
         return;
     }
 
-    /* lock heap */
-    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
-
     /* zone case. get out zone. */
     z = (slab_zone *)(((rt_uint32_t)ptr & ~RT_MM_PAGE_MASK) -
                       kup->size * RT_MM_PAGE_SIZE);
     RT_ASSERT(z->z_magic == ZALLOC_SLAB_MAGIC);
 
-    chunk          = (slab_chunk *)ptr;
-    chunk->c_next  = z->z_freechunk;
-    z->z_freechunk = chunk;
-
-#ifdef RT_MEM_STATS
-    used_mem -= z->z_chunksize;
-#endif
-
-    /*
-     * Bump the number of free chunks.  If it becomes non-zero the zone
-     * must be added back onto the appropriate list.
-     */
-    if (z->z_nfree++ == 0)
-    {
-        z->z_next = zone_array[z->z_zoneindex];
-        zone_array[z->z_zoneindex] = z;
-    }
-
-    /*
-     * If the zone becomes totally free, and there are other zones we
-     * can allocate from, move this zone to the FreeZones list.  Since
-     * this code can be called from an IPI callback, do *NOT* try to mess
-     * with kernel_map here.  Hysteresis will be performed at malloc() time.
-     */
-    if (z->z_nfree == z->z_nmax &&
-        (z->z_next || zone_array[z->z_zoneindex] != z))
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* small chunk goes to the magazine of current thread */
+    if (z->z_zoneindex < RT_SLAB_MAG_ZONES && (thread = slab_mag_owner()) != RT_NULL)
     {
-        slab_zone **pz;
-
-        RT_DEBUG_LOG(RT_DEBUG_SLAB, ("free zone 0x%x\n",
-                                     (rt_uint32_t)z, z->z_zoneindex));
+        rt_int32_t zi = z->z_zoneindex;
 
-        /* remove zone from zone array list */
-        for (pz = &zone_array[z->z_zoneindex]; z != *pz; pz = &(*pz)->z_next)
-            ;
-        *pz = z->z_next;
-
-        /* reset zone */
-        z->z_magic = -1;
-
-        /* insert to free zone list */
-        z->z_next = zone_free;
-        zone_free = z;
-
-        ++ zone_free_cnt;
-
-        /* release zone to page allocator */
-        if (zone_free_cnt > ZONE_RELEASE_THRESH)
+        if (thread->slab_mag_cnt[zi] >= RT_SLAB_MAG_SIZE)
         {
-            register rt_base_t i;
+            rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
+            slab_mag_drain(thread, zi, RT_SLAB_MAG_SIZE - SLAB_MAG_BATCH);
+            slab_mag_exchange ++;
+            rt_sem_release(&heap_sem);
+        }
+        else
+            slab_mag_hit ++;
 
-            z         = zone_free;
-            zone_free = z->z_next;
-            -- zone_free_cnt;
+        ((slab_chunk *)ptr)->c_next = (slab_chunk *)thread->slab_mag[zi];
+        thread->slab_mag[zi] = ptr;
+        thread->slab_mag_cnt[zi] ++;
 
-            /* set message usage */
-            for (i = 0, kup = btokup(z); i < zone_page_cnt; i ++)
-            {
-                kup->type = PAGE_TYPE_FREE;
-                kup->size = 0;
-                kup ++;
-            }
+        return;
+    }
+#endif
 
-            /* unlock heap */
-            rt_sem_release(&heap_sem);
+    /* lock heap */
+    rt_sem_take(&heap_sem, RT_WAITING_FOREVER);
 
-            /* release pages */
-            rt_page_free(z, zone_size / RT_MM_PAGE_SIZE);
+    slab_zone_free(z, (slab_chunk *)ptr);
 
-            return;
-        }
-    }
     /* unlock heap */
     rt_sem_release(&heap_sem);
 }
 RTM_EXPORT(rt_free);
 
+/**
+ * This function will get the free memory of heap. Free chunks inside of
+ * zones are counted as free but only whole pages make up a free block.
+ *
+ * @param free the total size of free memory
+ * @param max_free the size of the largest free block
+ */
+void rt_memory_free_info(rt_uint32_t *free, rt_uint32_t *max_free)
+{
+    rt_uint32_t max_pages;
+
+    rt_page_info(RT_NULL, RT_NULL, &max_pages, RT_NULL);
+
+    if (free != RT_NULL)
+        *free = heap_end - heap_start - used_mem;
+    if (max_free != RT_NULL)
+        *max_free = max_pages * RT_MM_PAGE_SIZE;
+}
+
 #ifdef RT_MEM_STATS
 void rt_memory_info(rt_uint32_t *total,
                     rt_uint32_t *used,
@@ -1150,9 +1453,14 @@ void rt_memory_info(rt_uint32_t *total,
 
 void list_mem(void)
 {
+    rt_uint32_t free_pages, max_free;
+
+    rt_page_info(RT_NULL, &free_pages, &max_free, RT_NULL);
+
     rt_kprintf("total memory: %d\n", heap_end - heap_start);
     rt_kprintf("used memory : %d\n", used_mem);
     rt_kprintf("maximum allocated memory: %d\n", max_mem);
+    rt_kprintf("free pages  : %d, largest free block %d pages\n", free_pages, max_free);
 }
 FINSH_FUNCTION_EXPORT(list_mem, list memory usage information)
 #endif
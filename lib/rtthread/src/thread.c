@@ -86,6 +86,11 @@ void rt_thread_exit(void)
     /* get current thread */
     thread = rt_current_thread;
 
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* give cached chunks back to the heap */
+    rt_slab_mag_flush(thread);
+#endif
+
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
@@ -169,6 +174,20 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
     thread->cleanup   = 0;
     thread->user_data = 0;
 
+#ifdef RT_USING_STACK_WATERMARK
+    thread->stack_free = thread->stack_size;
+    thread->stack_scan = 0;
+#endif
+
+#ifdef RT_USING_ARENA
+    thread->arena = RT_NULL;
+#endif
+
+#ifdef RT_USING_SLAB_MAGAZINE
+    rt_memset(thread->slab_mag, 0, sizeof(thread->slab_mag));
+    rt_memset(thread->slab_mag_cnt, 0, sizeof(thread->slab_mag_cnt));
+#endif
+
     /* init thread timer */
     rt_timer_init(&(thread->thread_timer),
                   thread->name,
@@ -323,6 +342,11 @@ rt_err_t rt_thread_detach(rt_thread_t thread)
     /* release thread timer */
     rt_timer_detach(&(thread->thread_timer));
 
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* give cached chunks back to the heap */
+    rt_slab_mag_flush(thread);
+#endif
+
     /* change stat */
     thread->stat = RT_THREAD_CLOSE;
 
@@ -374,7 +398,7 @@ rt_thread_t rt_thread_create(const char *name,
     if (thread == RT_NULL)
         return RT_NULL;
 
-    stack_start = (void *)RT_KERNEL_MALLOC(stack_size);
+    stack_start = (void *)RT_KERNEL_BUF_MALLOC(stack_size);
     if (stack_start == RT_NULL)
     {
         /* allocate stack failure */
@@ -422,6 +446,11 @@ rt_err_t rt_thread_delete(rt_thread_t thread)
     /* release thread timer */
     rt_timer_detach(&(thread->thread_timer));
 
+#ifdef RT_USING_SLAB_MAGAZINE
+    /* give cached chunks back to the heap */
+    rt_slab_mag_flush(thread);
+#endif
+
     /* change stat */
     thread->stat = RT_THREAD_CLOSE;
 
@@ -764,38 +793,7 @@ RTM_EXPORT(rt_thread_timeout);
  */
 rt_thread_t rt_thread_find(char *name)
 {
-    struct rt_object_information *information;
-    struct rt_object *object;
-    struct rt_list_node *node;
-
-    /* enter critical */
-    if (rt_thread_self() != RT_NULL)
-        rt_enter_critical();
-
-    /* try to find device object */
-    information = rt_object_get_information(RT_Object_Class_Thread);
-    RT_ASSERT(information != RT_NULL);
-    for (node  = information->object_list.next;
-         node != &(information->object_list);
-         node  = node->next)
-    {
-        object = rt_list_entry(node, struct rt_object, list);
-        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
-        {
-            /* leave critical */
-            if (rt_thread_self() != RT_NULL)
-                rt_exit_critical();
-
-            return (rt_thread_t)object;
-        }
-    }
-
-    /* leave critical */
-    if (rt_thread_self() != RT_NULL)
-        rt_exit_critical();
-
-    /* not found */
-    return RT_NULL;
+    return (rt_thread_t)rt_object_find(name, RT_Object_Class_Thread);
 }
 RTM_EXPORT(rt_thread_find);
 
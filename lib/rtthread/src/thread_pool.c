@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Thread pool
+ *
+ * Short jobs are run by worker threads which are created once, with static
+ * control blocks and stacks, and park on a semaphore between jobs. Launching
+ * a job is a free list pop, a queue insert and a semaphore release, instead
+ * of rt_thread_create (heap allocation of TCB and stack, rt_hw_stack_init),
+ * rt_thread_startup and the deferred cleanup in rt_thread_idle_excute.
+ *
+ * Workers are grouped in priority bands, each band has its own job queue.
+ * A job must return to its worker: it should not call rt_thread_exit, nor
+ * block forever, otherwise the worker is lost for its band.
+ *
+ * With RT_THREAD_POOL_ARENA_SIZE, each worker has a scratch arena, which a
+ * job finds by rt_arena_self and which is reset after each job.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_THREAD_POOL
+
+/* workers in each band */
+#ifndef RT_THREAD_POOL_WORKERS
+#define RT_THREAD_POOL_WORKERS          1
+#endif
+
+#ifndef RT_THREAD_POOL_STACK_SIZE
+#define RT_THREAD_POOL_STACK_SIZE       1024
+#endif
+
+/* jobs submitted and not yet waited for */
+#ifndef RT_THREAD_POOL_JOBS
+#define RT_THREAD_POOL_JOBS             8
+#endif
+
+/* scratch arena of each worker, reset after each job, 0 for none */
+#if defined(RT_USING_ARENA) && !defined(RT_THREAD_POOL_ARENA_SIZE)
+#define RT_THREAD_POOL_ARENA_SIZE       0
+#endif
+
+#ifndef RT_THREAD_POOL_PRIO_HIGH
+#define RT_THREAD_POOL_PRIO_HIGH        6
+#endif
+
+#ifndef RT_THREAD_POOL_PRIO_NORMAL
+#define RT_THREAD_POOL_PRIO_NORMAL      12
+#endif
+
+#ifndef RT_THREAD_POOL_PRIO_LOW
+#define RT_THREAD_POOL_PRIO_LOW         20
+#endif
+
+#define POOL_JOB_FREE                   0x00
+#define POOL_JOB_QUEUED                 0x01
+#define POOL_JOB_RUNNING                0x02
+#define POOL_JOB_DONE                   0x03
+
+struct rt_pool_job
+{
+    rt_list_t list;                     /* node on band queue or free list */
+
+    void (*entry)(void *parameter);
+    void *parameter;
+
+    rt_uint8_t state;
+    rt_uint8_t detached;                /* nobody waits, worker frees the job */
+
+    struct rt_semaphore done;
+};
+
+struct thread_pool_band
+{
+    rt_uint8_t priority;
+
+    rt_list_t queue;                    /* jobs waiting for a worker */
+    struct rt_semaphore sem;            /* queued jobs count */
+
+    rt_uint16_t busy;                   /* workers running a job */
+    rt_uint32_t submitted;
+    rt_uint32_t completed;
+
+    struct rt_thread worker[RT_THREAD_POOL_WORKERS];
+#if defined(RT_USING_ARENA) && RT_THREAD_POOL_ARENA_SIZE > 0
+    struct rt_arena arena[RT_THREAD_POOL_WORKERS];
+#endif
+};
+
+static struct thread_pool_band thread_pool_band[RT_THREAD_POOL_BAND_NR] =
+{
+    {RT_THREAD_POOL_PRIO_HIGH},
+    {RT_THREAD_POOL_PRIO_NORMAL},
+    {RT_THREAD_POOL_PRIO_LOW}
+};
+
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t thread_pool_stack[RT_THREAD_POOL_BAND_NR][RT_THREAD_POOL_WORKERS][RT_THREAD_POOL_STACK_SIZE];
+
+#if defined(RT_USING_ARENA) && RT_THREAD_POOL_ARENA_SIZE > 0
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t thread_pool_arena[RT_THREAD_POOL_BAND_NR][RT_THREAD_POOL_WORKERS][RT_THREAD_POOL_ARENA_SIZE];
+#endif
+
+static struct rt_pool_job thread_pool_job[RT_THREAD_POOL_JOBS];
+static rt_list_t thread_pool_free;
+
+static void thread_pool_worker_entry(void *parameter)
+{
+    struct thread_pool_band *band = (struct thread_pool_band *)parameter;
+    struct rt_pool_job *job;
+    register rt_base_t level;
+    rt_thread_t self;
+    rt_uint8_t priority;
+
+    self = rt_thread_self();
+    while (1)
+    {
+        rt_sem_take(&band->sem, RT_WAITING_FOREVER);
+
+        level = rt_hw_interrupt_disable();
+        RT_ASSERT(!rt_list_isempty(&band->queue));
+        job = rt_list_entry(band->queue.next, struct rt_pool_job, list);
+        rt_list_remove(&job->list);
+        job->state = POOL_JOB_RUNNING;
+        band->busy ++;
+        rt_hw_interrupt_enable(level);
+
+        job->entry(job->parameter);
+
+#if defined(RT_USING_ARENA) && RT_THREAD_POOL_ARENA_SIZE > 0
+        /* release all scratch blocks of the job */
+        rt_arena_reset(self->arena, 0);
+#endif
+
+        /* the job may have changed the priority of its worker */
+        if (self->current_priority != band->priority)
+        {
+            priority = band->priority;
+            rt_thread_control(self, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+        }
+
+        level = rt_hw_interrupt_disable();
+        band->busy --;
+        band->completed ++;
+        if (job->detached)
+        {
+            job->state = POOL_JOB_FREE;
+            rt_list_insert_after(&thread_pool_free, &job->list);
+            rt_hw_interrupt_enable(level);
+        }
+        else
+        {
+            /*
+             * publish and signal the completion in one section, a detacher
+             * must see DONE with the semaphore already released. A waiter
+             * woken by the release may recycle the job, don't touch it after.
+             */
+            job->state = POOL_JOB_DONE;
+            rt_sem_release(&job->done);
+            rt_hw_interrupt_enable(level);
+        }
+    }
+}
+
+/**
+ * @addtogroup Thread
+ */
+
+/**@{*/
+
+/**
+ * This function will queue a job to the workers of a band. It never blocks
+ * and can be invoked in ISR.
+ *
+ * @param entry the job function
+ * @param parameter the parameter of job function
+ * @param band the band of workers, RT_THREAD_POOL_HIGH, RT_THREAD_POOL_NORMAL
+ *        or RT_THREAD_POOL_LOW
+ *
+ * @return the job handle to be waited for or detached, RT_NULL if all jobs
+ *         are in use
+ */
+rt_pool_job_t rt_thread_pool_submit(void (*entry)(void *parameter),
+                                    void       *parameter,
+                                    rt_uint8_t  band)
+{
+    struct rt_pool_job *job;
+    register rt_base_t level;
+
+    RT_ASSERT(entry != RT_NULL);
+    RT_ASSERT(band < RT_THREAD_POOL_BAND_NR);
+
+    level = rt_hw_interrupt_disable();
+    if (rt_list_isempty(&thread_pool_free))
+    {
+        rt_hw_interrupt_enable(level);
+
+        return RT_NULL;
+    }
+
+    job = rt_list_entry(thread_pool_free.next, struct rt_pool_job, list);
+    rt_list_remove(&job->list);
+
+    job->entry     = entry;
+    job->parameter = parameter;
+    job->state     = POOL_JOB_QUEUED;
+    job->detached  = 0;
+    rt_list_insert_before(&thread_pool_band[band].queue, &job->list);
+    thread_pool_band[band].submitted ++;
+    rt_hw_interrupt_enable(level);
+
+    rt_sem_release(&thread_pool_band[band].sem);
+
+    return job;
+}
+RTM_EXPORT(rt_thread_pool_submit);
+
+/**
+ * This function will wait for a job to complete and release its handle.
+ * A job can be waited for by one thread only.
+ *
+ * @param job the job handle returned by rt_thread_pool_submit
+ * @param timeout the waiting time
+ *
+ * @return the error code, the handle remains valid on -RT_ETIMEOUT
+ */
+rt_err_t rt_thread_pool_wait(rt_pool_job_t job, rt_int32_t timeout)
+{
+    register rt_base_t level;
+    rt_err_t result;
+
+    RT_ASSERT(job != RT_NULL);
+    RT_ASSERT(job->state != POOL_JOB_FREE);
+    RT_ASSERT(job->detached == 0);
+
+    result = rt_sem_take(&job->done, timeout);
+    if (result != RT_EOK)
+        return result;
+
+    level = rt_hw_interrupt_disable();
+    job->state = POOL_JOB_FREE;
+    rt_list_insert_after(&thread_pool_free, &job->list);
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_thread_pool_wait);
+
+/**
+ * This function will give up waiting for a job, its handle is released as
+ * soon as the job completes.
+ *
+ * @param job the job handle returned by rt_thread_pool_submit
+ */
+void rt_thread_pool_detach(rt_pool_job_t job)
+{
+    register rt_base_t level;
+    rt_uint8_t state;
+
+    RT_ASSERT(job != RT_NULL);
+    RT_ASSERT(job->state != POOL_JOB_FREE);
+
+    level = rt_hw_interrupt_disable();
+    state = job->state;
+    job->detached = 1;
+    rt_hw_interrupt_enable(level);
+
+    if (state == POOL_JOB_DONE)
+    {
+        /* completed already, consume the completion and release it here */
+        rt_sem_take(&job->done, RT_WAITING_NO);
+
+        level = rt_hw_interrupt_disable();
+        job->state = POOL_JOB_FREE;
+        rt_list_insert_after(&thread_pool_free, &job->list);
+        rt_hw_interrupt_enable(level);
+    }
+}
+RTM_EXPORT(rt_thread_pool_detach);
+
+/**@}*/
+
+/**
+ * This function will initialize the jobs and start the workers of all bands.
+ */
+int rt_thread_pool_init(void)
+{
+    struct thread_pool_band *band;
+    char name[RT_NAME_MAX];
+    int index, worker;
+
+    rt_list_init(&thread_pool_free);
+    for (index = 0; index < RT_THREAD_POOL_JOBS; index ++)
+    {
+        rt_snprintf(name, sizeof(name), "pjob%d", index);
+        rt_sem_init(&thread_pool_job[index].done, name, 0, RT_IPC_FLAG_FIFO);
+        thread_pool_job[index].state = POOL_JOB_FREE;
+        rt_list_insert_before(&thread_pool_free, &thread_pool_job[index].list);
+    }
+
+    for (index = 0; index < RT_THREAD_POOL_BAND_NR; index ++)
+    {
+        band = &thread_pool_band[index];
+
+        rt_list_init(&band->queue);
+        rt_snprintf(name, sizeof(name), "pool%d", index);
+        rt_sem_init(&band->sem, name, 0, RT_IPC_FLAG_FIFO);
+
+        for (worker = 0; worker < RT_THREAD_POOL_WORKERS; worker ++)
+        {
+            rt_snprintf(name, sizeof(name), "pool%d%d", index, worker);
+            rt_thread_init(&band->worker[worker],
+                           name,
+                           thread_pool_worker_entry,
+                           band,
+                           &thread_pool_stack[index][worker][0],
+                           RT_THREAD_POOL_STACK_SIZE,
+                           band->priority,
+                           10);
+#if defined(RT_USING_ARENA) && RT_THREAD_POOL_ARENA_SIZE > 0
+            rt_arena_init(&band->arena[worker], &thread_pool_arena[index][worker][0],
+                          RT_THREAD_POOL_ARENA_SIZE);
+            rt_arena_attach(&band->worker[worker], &band->arena[worker]);
+#endif
+            rt_thread_startup(&band->worker[worker]);
+        }
+    }
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(rt_thread_pool_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_thread_pool(void)
+{
+    struct thread_pool_band *band;
+    register rt_base_t level;
+    rt_uint32_t queued, free;
+    int index;
+
+    rt_kprintf("band pri queued busy submitted  completed\n");
+    rt_kprintf("---- --- ------ ---- ---------- ----------\n");
+    for (index = 0; index < RT_THREAD_POOL_BAND_NR; index ++)
+    {
+        band = &thread_pool_band[index];
+
+        level = rt_hw_interrupt_disable();
+        queued = rt_list_len(&band->queue);
+        rt_hw_interrupt_enable(level);
+
+        rt_kprintf("%4d %3d %6d %4d %010d %010d\n",
+                   index, band->priority, queued, band->busy,
+                   band->submitted, band->completed);
+    }
+
+    level = rt_hw_interrupt_disable();
+    free = rt_list_len(&thread_pool_free);
+    rt_hw_interrupt_enable(level);
+    rt_kprintf("free jobs: %d/%d\n", free, RT_THREAD_POOL_JOBS);
+}
+FINSH_FUNCTION_EXPORT(list_thread_pool, list thread pool usage information);
+MSH_CMD_EXPORT(list_thread_pool, list thread pool usage information);
+#endif
+
+#endif /* end of RT_USING_THREAD_POOL */
@@ -0,0 +1,961 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Two-Level Segregated Fit memory allocator.
+ *
+ * Free blocks are kept in segregated lists indexed by a first level (power of
+ * two of the size) and a second level (linear subdivision of that power of
+ * two). Two bitmaps tell which lists are non-empty, so finding a fitting block
+ * is a couple of bit scans instead of a walk: malloc, free and realloc all run
+ * in bounded time, independent of heap size and fragmentation.
+ *
+ * The algorithm follows "TLSF: a New Dynamic Memory Allocator for Real-Time
+ * Systems", M. Masmano, I. Ripoll, A. Crespo, J. Real, ECRTS 2004.
+ *
+ * Memory layout of a block (the size word is the only overhead of a used
+ * block, prev_phys lives in the tail of the previous block when it is free):
+ *
+ *   prev_phys | size | next_free, prev_free (free) or user data (used) ...
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_TLSF
+
+/* log2 of second level lists per first level, 8 lists by default */
+#ifndef RT_TLSF_SL_INDEX_COUNT_LOG2
+#define RT_TLSF_SL_INDEX_COUNT_LOG2     3
+#endif
+
+/* log2 of the largest block, 1MB by default, a larger region is cut to it */
+#ifndef RT_TLSF_FL_INDEX_MAX
+#define RT_TLSF_FL_INDEX_MAX            20
+#endif
+
+#define TLSF_ALIGN_SIZE_LOG2            2
+#define TLSF_ALIGN_SIZE                 (1 << TLSF_ALIGN_SIZE_LOG2)
+
+#define TLSF_SL_INDEX_COUNT_LOG2        RT_TLSF_SL_INDEX_COUNT_LOG2
+#define TLSF_SL_INDEX_COUNT             (1 << TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_INDEX_MAX               RT_TLSF_FL_INDEX_MAX
+#define TLSF_FL_INDEX_SHIFT             (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_FL_INDEX_COUNT             (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE           (1 << TLSF_FL_INDEX_SHIFT)
+
+struct tlsf_block
+{
+    struct tlsf_block *prev_phys;       /* only valid if the previous block is free */
+    rt_size_t size;                     /* size of payload, low bits are flags */
+
+    struct tlsf_block *next_free;       /* only valid if this block is free */
+    struct tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE_BIT                  0x01
+#define BLOCK_PREV_FREE_BIT             0x02
+
+/* a used block only costs its size word */
+#define BLOCK_HEADER_OVERHEAD           (sizeof(rt_size_t))
+/* user data starts right after the size word */
+#define BLOCK_START_OFFSET              (sizeof(struct tlsf_block *) + sizeof(rt_size_t))
+/* a free block must hold the free list links and the next prev_phys */
+#define BLOCK_SIZE_MIN                  (sizeof(struct tlsf_block) - sizeof(struct tlsf_block *))
+#define BLOCK_SIZE_MAX                  ((rt_size_t)1 << TLSF_FL_INDEX_MAX)
+
+struct rt_tlsf
+{
+    struct tlsf_block null_block;       /* end of every free list */
+
+    rt_uint32_t fl_bitmap;
+    rt_uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+    struct tlsf_block *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+
+    rt_uint8_t *begin;                  /* first byte of the pool */
+    rt_uint8_t *end;                    /* first byte after the pool */
+
+    rt_size_t total;
+    rt_size_t used;
+    rt_size_t max_used;
+
+    struct rt_semaphore lock;
+};
+
+/* index of the highest set bit, -1 if none */
+rt_inline int tlsf_fls(rt_uint32_t word)
+{
+#if defined(__GNUC__)
+    return word ? 31 - __builtin_clz(word) : -1;
+#else
+    int bit = -1;
+
+    while (word)
+    {
+        word >>= 1;
+        bit ++;
+    }
+
+    return bit;
+#endif
+}
+
+/* index of the lowest set bit, -1 if none */
+rt_inline int tlsf_ffs(rt_uint32_t word)
+{
+    return __rt_ffs(word) - 1;
+}
+
+rt_inline rt_size_t block_size(const struct tlsf_block *block)
+{
+    return block->size & ~(BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT);
+}
+
+rt_inline void block_set_size(struct tlsf_block *block, rt_size_t size)
+{
+    block->size = size | (block->size & (BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT));
+}
+
+rt_inline int block_is_last(const struct tlsf_block *block)
+{
+    return block_size(block) == 0;
+}
+
+rt_inline int block_is_free(const struct tlsf_block *block)
+{
+    return block->size & BLOCK_FREE_BIT;
+}
+
+rt_inline void block_set_free(struct tlsf_block *block)
+{
+    block->size |= BLOCK_FREE_BIT;
+}
+
+rt_inline void block_set_used(struct tlsf_block *block)
+{
+    block->size &= ~BLOCK_FREE_BIT;
+}
+
+rt_inline int block_is_prev_free(const struct tlsf_block *block)
+{
+    return block->size & BLOCK_PREV_FREE_BIT;
+}
+
+rt_inline void block_set_prev_free(struct tlsf_block *block)
+{
+    block->size |= BLOCK_PREV_FREE_BIT;
+}
+
+rt_inline void block_set_prev_used(struct tlsf_block *block)
+{
+    block->size &= ~BLOCK_PREV_FREE_BIT;
+}
+
+rt_inline struct tlsf_block *block_from_ptr(const void *ptr)
+{
+    return (struct tlsf_block *)((rt_uint8_t *)ptr - BLOCK_START_OFFSET);
+}
+
+rt_inline void *block_to_ptr(const struct tlsf_block *block)
+{
+    return (void *)((rt_uint8_t *)block + BLOCK_START_OFFSET);
+}
+
+rt_inline struct tlsf_block *offset_to_block(const void *ptr, rt_base_t offset)
+{
+    return (struct tlsf_block *)((rt_uint8_t *)ptr + offset);
+}
+
+rt_inline struct tlsf_block *block_next(const struct tlsf_block *block)
+{
+    RT_ASSERT(!block_is_last(block));
+
+    return offset_to_block(block_to_ptr(block),
+                           block_size(block) - BLOCK_HEADER_OVERHEAD);
+}
+
+rt_inline struct tlsf_block *block_link_next(struct tlsf_block *block)
+{
+    struct tlsf_block *next = block_next(block);
+
+    next->prev_phys = block;
+
+    return next;
+}
+
+rt_inline void block_mark_as_free(struct tlsf_block *block)
+{
+    struct tlsf_block *next = block_link_next(block);
+
+    block_set_prev_free(next);
+    block_set_free(block);
+}
+
+rt_inline void block_mark_as_used(struct tlsf_block *block)
+{
+    struct tlsf_block *next = block_next(block);
+
+    block_set_prev_used(next);
+    block_set_used(block);
+}
+
+/* round up the request to a legal block size, 0 if it's too large */
+rt_inline rt_size_t adjust_request_size(rt_size_t size)
+{
+    rt_size_t aligned;
+
+    if (size == 0 || size >= BLOCK_SIZE_MAX)
+        return 0;
+
+    aligned = RT_ALIGN(size, TLSF_ALIGN_SIZE);
+
+    return aligned < BLOCK_SIZE_MIN ? BLOCK_SIZE_MIN : aligned;
+}
+
+/* the list which a block of this size belongs to */
+rt_inline void mapping_insert(rt_size_t size, int *fli, int *sli)
+{
+    int fl, sl;
+
+    if (size < TLSF_SMALL_BLOCK_SIZE)
+    {
+        /* small blocks are linearly spread over the first level 0 */
+        fl = 0;
+        sl = size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT);
+    }
+    else
+    {
+        fl = tlsf_fls(size);
+        sl = (size >> (fl - TLSF_SL_INDEX_COUNT_LOG2)) ^ (1 << TLSF_SL_INDEX_COUNT_LOG2);
+        fl -= (TLSF_FL_INDEX_SHIFT - 1);
+    }
+
+    *fli = fl;
+    *sli = sl;
+}
+
+/* the first list whose every block is large enough for this size */
+rt_inline void mapping_search(rt_size_t size, int *fli, int *sli)
+{
+    if (size >= TLSF_SMALL_BLOCK_SIZE)
+    {
+        size += (1 << (tlsf_fls(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+
+    mapping_insert(size, fli, sli);
+}
+
+static struct tlsf_block *search_suitable_block(struct rt_tlsf *tlsf, int *fli, int *sli)
+{
+    int fl = *fli;
+    int sl = *sli;
+    rt_uint32_t sl_map, fl_map;
+
+    /* search for a non-empty list in this first level, at or above sl */
+    sl_map = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (!sl_map)
+    {
+        /* then in the higher first levels */
+        fl_map = tlsf->fl_bitmap & (~0UL << (fl + 1));
+        if (!fl_map)
+            return RT_NULL;
+
+        fl = tlsf_ffs(fl_map);
+        *fli = fl;
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+
+    sl = tlsf_ffs(sl_map);
+    *sli = sl;
+
+    return tlsf->blocks[fl][sl];
+}
+
+static void remove_free_block(struct rt_tlsf *tlsf, struct tlsf_block *block, int fl, int sl)
+{
+    struct tlsf_block *prev = block->prev_free;
+    struct tlsf_block *next = block->next_free;
+
+    next->prev_free = prev;
+    prev->next_free = next;
+
+    /* it's the head of the list */
+    if (tlsf->blocks[fl][sl] == block)
+    {
+        tlsf->blocks[fl][sl] = next;
+
+        /* the list is empty now */
+        if (next == &tlsf->null_block)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (!tlsf->sl_bitmap[fl])
+                tlsf->fl_bitmap &= ~(1UL << fl);
+        }
+    }
+}
+
+static void insert_free_block(struct rt_tlsf *tlsf, struct tlsf_block *block, int fl, int sl)
+{
+    struct tlsf_block *current = tlsf->blocks[fl][sl];
+
+    block->next_free = current;
+    block->prev_free = &tlsf->null_block;
+    current->prev_free = block;
+
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= (1UL << fl);
+    tlsf->sl_bitmap[fl] |= (1UL << sl);
+}
+
+rt_inline void block_remove(struct rt_tlsf *tlsf, struct tlsf_block *block)
+{
+    int fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(tlsf, block, fl, sl);
+}
+
+rt_inline void block_insert(struct rt_tlsf *tlsf, struct tlsf_block *block)
+{
+    int fl, sl;
+
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(tlsf, block, fl, sl);
+}
+
+rt_inline int block_can_split(struct tlsf_block *block, rt_size_t size)
+{
+    return block_size(block) >= sizeof(struct tlsf_block) + size;
+}
+
+/* split a block in two, the second one is returned as a free block */
+static struct tlsf_block *block_split(struct tlsf_block *block, rt_size_t size)
+{
+    struct tlsf_block *remaining;
+    rt_size_t remain_size;
+
+    remaining   = offset_to_block(block_to_ptr(block), size - BLOCK_HEADER_OVERHEAD);
+    remain_size = block_size(block) - (size + BLOCK_HEADER_OVERHEAD);
+
+    block_set_size(remaining, remain_size);
+    block_set_size(block, size);
+    block_mark_as_free(remaining);
+
+    return remaining;
+}
+
+/* merge a block into its physical previous one */
+static struct tlsf_block *block_absorb(struct tlsf_block *prev, struct tlsf_block *block)
+{
+    prev->size += block_size(block) + BLOCK_HEADER_OVERHEAD;
+    block_link_next(prev);
+
+    return prev;
+}
+
+static struct tlsf_block *block_merge_prev(struct rt_tlsf *tlsf, struct tlsf_block *block)
+{
+    if (block_is_prev_free(block))
+    {
+        struct tlsf_block *prev = block->prev_phys;
+
+        block_remove(tlsf, prev);
+        block = block_absorb(prev, block);
+    }
+
+    return block;
+}
+
+static struct tlsf_block *block_merge_next(struct rt_tlsf *tlsf, struct tlsf_block *block)
+{
+    struct tlsf_block *next = block_next(block);
+
+    if (block_is_free(next))
+    {
+        block_remove(tlsf, next);
+        block = block_absorb(block, next);
+    }
+
+    return block;
+}
+
+/* give the tail of a free block back to the free lists */
+static void block_trim_free(struct rt_tlsf *tlsf, struct tlsf_block *block, rt_size_t size)
+{
+    if (block_can_split(block, size))
+    {
+        struct tlsf_block *remaining = block_split(block, size);
+
+        block_link_next(block);
+        block_set_prev_free(remaining);
+        block_insert(tlsf, remaining);
+    }
+}
+
+/* give the tail of a used block back to the free lists */
+static void block_trim_used(struct rt_tlsf *tlsf, struct tlsf_block *block, rt_size_t size)
+{
+    if (block_can_split(block, size))
+    {
+        struct tlsf_block *remaining = block_split(block, size);
+
+        block_set_prev_used(remaining);
+        remaining = block_merge_next(tlsf, remaining);
+        block_insert(tlsf, remaining);
+    }
+}
+
+static struct tlsf_block *block_locate_free(struct rt_tlsf *tlsf, rt_size_t size)
+{
+    int fl = 0, sl = 0;
+    struct tlsf_block *block;
+
+    mapping_search(size, &fl, &sl);
+    if (fl >= TLSF_FL_INDEX_COUNT)
+        return RT_NULL;
+
+    block = search_suitable_block(tlsf, &fl, &sl);
+    if (block != RT_NULL && block != &tlsf->null_block)
+    {
+        RT_ASSERT(block_size(block) >= size);
+        remove_free_block(tlsf, block, fl, sl);
+
+        return block;
+    }
+
+    return RT_NULL;
+}
+
+static void *block_prepare_used(struct rt_tlsf *tlsf, struct tlsf_block *block, rt_size_t size)
+{
+    block_trim_free(tlsf, block, size);
+    block_mark_as_used(block);
+
+    tlsf->used += block_size(block) + BLOCK_HEADER_OVERHEAD;
+    if (tlsf->used > tlsf->max_used)
+        tlsf->max_used = tlsf->used;
+
+    return block_to_ptr(block);
+}
+
+/* allocate with the lock held */
+static void *tlsf_alloc(struct rt_tlsf *tlsf, rt_size_t size)
+{
+    struct tlsf_block *block;
+
+    size = adjust_request_size(size);
+    if (size == 0)
+        return RT_NULL;
+
+    block = block_locate_free(tlsf, size);
+    if (block == RT_NULL)
+        return RT_NULL;
+
+    return block_prepare_used(tlsf, block, size);
+}
+
+/* release with the lock held */
+static void tlsf_free(struct rt_tlsf *tlsf, void *ptr)
+{
+    struct tlsf_block *block = block_from_ptr(ptr);
+
+    RT_ASSERT(!block_is_free(block));
+
+    tlsf->used -= block_size(block) + BLOCK_HEADER_OVERHEAD;
+
+    block_mark_as_free(block);
+    block = block_merge_prev(tlsf, block);
+    block = block_merge_next(tlsf, block);
+    block_insert(tlsf, block);
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will initialize a TLSF pool on a memory region. The control
+ * structure of allocator is placed at the beginning of the region.
+ *
+ * @param name the name of the pool lock
+ * @param begin_addr the beginning address of memory region
+ * @param size the size of memory region
+ *
+ * @return the TLSF pool, RT_NULL if the region is too small
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size)
+{
+    struct rt_tlsf *tlsf;
+    struct tlsf_block *block, *next;
+    rt_uint32_t begin_align, end_align, pool_begin;
+    rt_size_t pool_size;
+    int i, j;
+
+    RT_ASSERT(begin_addr != RT_NULL);
+
+    begin_align = RT_ALIGN((rt_uint32_t)begin_addr, TLSF_ALIGN_SIZE);
+    end_align   = RT_ALIGN_DOWN((rt_uint32_t)begin_addr + size, TLSF_ALIGN_SIZE);
+    pool_begin  = RT_ALIGN(begin_align + sizeof(struct rt_tlsf), TLSF_ALIGN_SIZE);
+
+    /* room for the first block and the sentinel */
+    if (end_align <= pool_begin ||
+        end_align - pool_begin < 2 * BLOCK_HEADER_OVERHEAD + BLOCK_SIZE_MIN)
+    {
+        rt_kprintf("tlsf init, error begin address 0x%x, and size %d\n",
+                   (rt_uint32_t)begin_addr, size);
+
+        return RT_NULL;
+    }
+
+    tlsf = (struct rt_tlsf *)begin_align;
+
+    tlsf->null_block.next_free = &tlsf->null_block;
+    tlsf->null_block.prev_free = &tlsf->null_block;
+    tlsf->fl_bitmap = 0;
+    for (i = 0; i < TLSF_FL_INDEX_COUNT; i ++)
+    {
+        tlsf->sl_bitmap[i] = 0;
+        for (j = 0; j < TLSF_SL_INDEX_COUNT; j ++)
+            tlsf->blocks[i][j] = &tlsf->null_block;
+    }
+
+    /* the size word of first block and the sentinel are the overhead */
+    pool_size = end_align - pool_begin - 2 * BLOCK_HEADER_OVERHEAD;
+    if (pool_size >= BLOCK_SIZE_MAX)
+    {
+        /* a free block can't reach BLOCK_SIZE_MAX, the rest of region is left unused */
+        rt_kprintf("tlsf init, %d bytes above RT_TLSF_FL_INDEX_MAX %d are unused\n",
+                   pool_size - (BLOCK_SIZE_MAX - TLSF_ALIGN_SIZE), TLSF_FL_INDEX_MAX);
+        pool_size = BLOCK_SIZE_MAX - TLSF_ALIGN_SIZE;
+    }
+
+    tlsf->begin    = (rt_uint8_t *)pool_begin;
+    tlsf->end      = (rt_uint8_t *)pool_begin + pool_size + 2 * BLOCK_HEADER_OVERHEAD;
+    tlsf->total    = pool_size;
+    tlsf->used     = 0;
+    tlsf->max_used = 0;
+
+    /*
+     * the prev_phys of first block lies before the pool, it's never touched
+     * because the first block is marked as previous used.
+     */
+    block = offset_to_block((void *)pool_begin, -(rt_base_t)BLOCK_HEADER_OVERHEAD);
+    block->size = pool_size;
+    block_set_free(block);
+    block_set_prev_used(block);
+    block_insert(tlsf, block);
+
+    /* zero-sized used sentinel at the end */
+    next = block_link_next(block);
+    next->size = 0;
+    block_set_used(next);
+    block_set_prev_free(next);
+
+    rt_sem_init(&(tlsf->lock), name, 1, RT_IPC_FLAG_FIFO);
+
+    return tlsf;
+}
+RTM_EXPORT(rt_tlsf_init);
+
+/**
+ * This function will detach a TLSF pool, memory in it shall not be used
+ * anymore.
+ *
+ * @param tlsf the TLSF pool
+ */
+void rt_tlsf_detach(rt_tlsf_t tlsf)
+{
+    RT_ASSERT(tlsf != RT_NULL);
+
+    rt_sem_detach(&(tlsf->lock));
+}
+RTM_EXPORT(rt_tlsf_detach);
+
+/**
+ * This function will allocate a block from TLSF pool in bounded time.
+ *
+ * @param tlsf the TLSF pool
+ * @param size the size of memory to be allocated
+ *
+ * @return the allocated memory, RT_NULL if there is no fitting block
+ */
+void *rt_tlsf_alloc(rt_tlsf_t tlsf, rt_size_t size)
+{
+    void *ptr;
+
+    RT_ASSERT(tlsf != RT_NULL);
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    rt_sem_take(&(tlsf->lock), RT_WAITING_FOREVER);
+    ptr = tlsf_alloc(tlsf, size);
+    rt_sem_release(&(tlsf->lock));
+
+    return ptr;
+}
+RTM_EXPORT(rt_tlsf_alloc);
+
+/**
+ * This function will release a block to TLSF pool in bounded time.
+ *
+ * @param tlsf the TLSF pool
+ * @param ptr the memory allocated from this pool
+ */
+void rt_tlsf_free(rt_tlsf_t tlsf, void *ptr)
+{
+    RT_ASSERT(tlsf != RT_NULL);
+
+    if (ptr == RT_NULL)
+        return;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+    RT_ASSERT((rt_uint8_t *)ptr >= tlsf->begin && (rt_uint8_t *)ptr < tlsf->end);
+
+    rt_sem_take(&(tlsf->lock), RT_WAITING_FOREVER);
+    tlsf_free(tlsf, ptr);
+    rt_sem_release(&(tlsf->lock));
+}
+RTM_EXPORT(rt_tlsf_free);
+
+/**
+ * This function will change the size of a block. The block grows in place if
+ * the physical next block is free and large enough, otherwise it's moved.
+ *
+ * @param tlsf the TLSF pool
+ * @param ptr the memory allocated from this pool, or RT_NULL
+ * @param newsize the new size
+ *
+ * @return the new address, RT_NULL on failure (old block is kept)
+ */
+void *rt_tlsf_realloc(rt_tlsf_t tlsf, void *ptr, rt_size_t newsize)
+{
+    struct tlsf_block *block, *next;
+    rt_size_t cursize, combined, adjust;
+    void *new_ptr;
+
+    RT_ASSERT(tlsf != RT_NULL);
+
+    if (ptr == RT_NULL)
+        return rt_tlsf_alloc(tlsf, newsize);
+
+    if (newsize == 0)
+    {
+        rt_tlsf_free(tlsf, ptr);
+
+        return RT_NULL;
+    }
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    adjust = adjust_request_size(newsize);
+    if (adjust == 0)
+        return RT_NULL;
+
+    rt_sem_take(&(tlsf->lock), RT_WAITING_FOREVER);
+
+    block    = block_from_ptr(ptr);
+    next     = block_next(block);
+    cursize  = block_size(block);
+    combined = cursize + block_size(next) + BLOCK_HEADER_OVERHEAD;
+
+    if (adjust > cursize && (!block_is_free(next) || adjust > combined))
+    {
+        /* can't grow in place, move it */
+        new_ptr = tlsf_alloc(tlsf, newsize);
+        if (new_ptr != RT_NULL)
+        {
+            rt_memcpy(new_ptr, ptr, cursize < newsize ? cursize : newsize);
+            tlsf_free(tlsf, ptr);
+        }
+    }
+    else
+    {
+        tlsf->used -= cursize;
+
+        /* absorb the next block if growing */
+        if (adjust > cursize)
+        {
+            block_merge_next(tlsf, block);
+            block_mark_as_used(block);
+        }
+
+        /* give back the tail */
+        block_trim_used(tlsf, block, adjust);
+
+        tlsf->used += block_size(block);
+        if (tlsf->used > tlsf->max_used)
+            tlsf->max_used = tlsf->used;
+
+        new_ptr = ptr;
+    }
+
+    rt_sem_release(&(tlsf->lock));
+
+    return new_ptr;
+}
+RTM_EXPORT(rt_tlsf_realloc);
+
+/**
+ * This function will get the memory usage of a TLSF pool.
+ *
+ * @param tlsf the TLSF pool
+ * @param total the total size of pool
+ * @param used the size in use, block overhead included
+ * @param max_used the maximal size in use
+ */
+void rt_tlsf_info(rt_tlsf_t    tlsf,
+                  rt_uint32_t *total,
+                  rt_uint32_t *used,
+                  rt_uint32_t *max_used)
+{
+    RT_ASSERT(tlsf != RT_NULL);
+
+    if (total != RT_NULL)
+        *total = tlsf->total;
+    if (used != RT_NULL)
+        *used = tlsf->used;
+    if (max_used != RT_NULL)
+        *max_used = tlsf->max_used;
+}
+RTM_EXPORT(rt_tlsf_info);
+
+/**@}*/
+
+#if defined (RT_USING_HEAP) && defined (RT_USING_TLSF_MEM)
+#ifdef RT_USING_HOOK
+static void (*rt_malloc_hook)(void *ptr, rt_size_t size);
+static void (*rt_free_hook)(void *ptr);
+
+/**
+ * @addtogroup Hook
+ */
+
+/**@{*/
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is allocated from heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size))
+{
+    rt_malloc_hook = hook;
+}
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is released to heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_free_sethook(void (*hook)(void *ptr))
+{
+    rt_free_hook = hook;
+}
+
+/**@}*/
+
+#endif
+
+static rt_tlsf_t system_tlsf;
+
+/**
+ * @ingroup SystemInit
+ *
+ * This function will initialize system heap memory.
+ *
+ * @param begin_addr the beginning address of system heap memory.
+ * @param end_addr the end address of system heap memory.
+ */
+void rt_system_heap_init(void *begin_addr, void *end_addr)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    system_tlsf = rt_tlsf_init("heap", begin_addr,
+                               (rt_uint32_t)end_addr - (rt_uint32_t)begin_addr);
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_malloc(rt_size_t size)
+{
+    void *ptr;
+
+    if (size == 0)
+        return RT_NULL;
+
+    ptr = rt_tlsf_alloc(system_tlsf, size);
+    if (ptr != RT_NULL)
+    {
+        RT_OBJECT_HOOK_CALL(rt_malloc_hook, (ptr, size));
+        RT_MEMPROF_ALLOC(ptr, size);
+    }
+    else
+    {
+        RT_DEBUG_LOG(RT_DEBUG_MEM, ("no memory\n"));
+    }
+
+    return ptr;
+}
+RTM_EXPORT(rt_malloc);
+
+/**
+ * This function will change the previously allocated memory block.
+ *
+ * @param rmem pointer to memory allocated by rt_malloc
+ * @param newsize the required new size
+ *
+ * @return the changed memory block address
+ */
+void *rt_realloc(void *rmem, rt_size_t newsize)
+{
+    void *nmem;
+
+    nmem = rt_tlsf_realloc(system_tlsf, rmem, newsize);
+    if (nmem != RT_NULL)
+    {
+        /* the old block has been moved */
+        if (nmem != rmem)
+            RT_MEMPROF_FREE(rmem);
+        RT_MEMPROF_ALLOC(nmem, newsize);
+    }
+    else if (newsize == 0)
+    {
+        /* released, on failure the old block is still in use */
+        RT_MEMPROF_FREE(rmem);
+    }
+
+    return nmem;
+}
+RTM_EXPORT(rt_realloc);
+
+/**
+ * This function will contiguously allocate enough space for count objects
+ * that are size bytes of memory each and returns a pointer to the allocated
+ * memory.
+ *
+ * The allocated memory is filled with bytes of value zero.
+ *
+ * @param count number of objects to allocate
+ * @param size size of the objects to allocate
+ *
+ * @return pointer to allocated memory / NULL pointer if there is an error
+ */
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    void *p;
+
+    /* allocate 'count' objects of size 'size' */
+    p = rt_malloc(count * size);
+
+    /* zero the memory */
+    if (p)
+    {
+        rt_memset(p, 0, count * size);
+        RT_MEMPROF_ALLOC(p, count * size);
+    }
+
+    return p;
+}
+RTM_EXPORT(rt_calloc);
+
+/**
+ * This function will release the previously allocated memory block by
+ * rt_malloc. The released memory block is taken back to system heap.
+ *
+ * @param rmem the address of memory which will be released
+ */
+void rt_free(void *rmem)
+{
+    if (rmem == RT_NULL)
+        return;
+
+    RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
+    RT_MEMPROF_FREE(rmem);
+
+    rt_tlsf_free(system_tlsf, rmem);
+}
+RTM_EXPORT(rt_free);
+
+/**
+ * This function will get the free memory of heap.
+ *
+ * @param free the total size of free blocks
+ * @param max_free the size of the largest free block
+ */
+void rt_memory_free_info(rt_uint32_t *free, rt_uint32_t *max_free)
+{
+    struct tlsf_block *block;
+    rt_uint32_t size, total = 0, max = 0;
+    int fl, sl;
+
+    rt_sem_take(&(system_tlsf->lock), RT_WAITING_FOREVER);
+    for (fl = 0; fl < TLSF_FL_INDEX_COUNT; fl ++)
+    {
+        for (sl = 0; sl < TLSF_SL_INDEX_COUNT; sl ++)
+        {
+            for (block = system_tlsf->blocks[fl][sl];
+                 block != &(system_tlsf->null_block);
+                 block = block->next_free)
+            {
+                size = block_size(block);
+                total += size;
+                if (size > max)
+                    max = size;
+            }
+        }
+    }
+    rt_sem_release(&(system_tlsf->lock));
+
+    if (free != RT_NULL)
+        *free = total;
+    if (max_free != RT_NULL)
+        *max_free = max;
+}
+
+#ifdef RT_MEM_STATS
+void rt_memory_info(rt_uint32_t *total,
+                    rt_uint32_t *used,
+                    rt_uint32_t *max_used)
+{
+    rt_tlsf_info(system_tlsf, total, used, max_used);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_mem(void)
+{
+    rt_uint32_t total, used, max_used;
+
+    rt_tlsf_info(system_tlsf, &total, &used, &max_used);
+
+    rt_kprintf("total memory: %d\n", total);
+    rt_kprintf("used memory : %d\n", used);
+    rt_kprintf("maximum allocated memory: %d\n", max_used);
+}
+FINSH_FUNCTION_EXPORT(list_mem, list memory usage information)
+#endif
+#endif
+
+/**@}*/
+
+#endif /* end of RT_USING_HEAP && RT_USING_TLSF_MEM */
+
+#endif /* end of RT_USING_TLSF */
@@ -0,0 +1,181 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2006-2018, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Decode the deferred binary log of RT_BINLOG (see rtbinlog.h).
+#
+# The formats are taken from the section "rt_binlog" of the firmware by
+# objcopy; every frame in the console capture is formatted with them, and
+# the text between frames is copied as it is.
+#
+# usage: python binlog.py rtthread.elf [capture.bin]
+#        (raw console capture is read from stdin when omitted)
+#
+
+import re
+import os
+import sys
+import struct
+import argparse
+import tempfile
+import subprocess
+
+FRAME_START = 0xff
+ESCAPE = 0xfe
+
+CONV_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z)?([diuxXcspofq%])')
+
+# decimal places of %f and %q at most, as rt_vsnprintf
+FLOAT_PRECISION_MAX = 9
+Q_BITS = 16
+
+def load_formats(objcopy, elf):
+    fd, path = tempfile.mkstemp()
+    os.close(fd)
+    try:
+        subprocess.check_call([objcopy, '-O', 'binary', '--only-section=rt_binlog', elf, path])
+        with open(path, 'rb') as f:
+            return f.read()
+    finally:
+        if os.path.exists(path):
+            os.remove(path)
+
+def format_at(section, offset):
+    end = section.find(b'\0', offset)
+    if offset >= len(section) or end < 0:
+        return None
+    return section[offset:end].decode('utf-8', 'replace')
+
+def signed(value):
+    value &= 0xffffffff
+    return value - (1 << 32) if value & 0x80000000 else value
+
+def float_bits(value):
+    return struct.unpack('<f', struct.pack('<I', value & 0xffffffff))[0]
+
+def render(fmt, args):
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def conv(m):
+        flags, width, prec, _, spec = m.groups()
+        if spec == '%':
+            return '%'
+        if width == '*':
+            width = str(signed(take()))
+        if prec == '*':
+            prec = str(signed(take()))
+        value = take()
+        spec_out = spec
+        if spec in 'di':
+            value, spec_out = signed(value), 'd'
+        elif spec == 'u':
+            value, spec_out = value & 0xffffffff, 'd'
+        elif spec == 'p':
+            value, spec_out, flags = value, 'x', (flags or '') + '0'
+            width = width or '8'
+        elif spec == 'f':
+            value = float_bits(value)
+            if 2.0 ** 64 <= abs(value) < float('inf'):
+                pattern = '%' + (flags or '').replace('0', '') + (width or '') + 's'
+                return pattern % (('-' if value < 0 else '') + 'oor')
+        elif spec == 'q':
+            value, spec_out = signed(value) / float(1 << Q_BITS), 'f'
+        elif spec == 'c':
+            value = chr(value & 0xff)
+        elif spec == 's' and not isinstance(value, str):
+            value = '0x%08x' % value
+        if spec in 'fq' and prec and int(prec) > FLOAT_PRECISION_MAX:
+            prec = str(FLOAT_PRECISION_MAX)
+        pattern = '%' + (flags or '') + (width or '') + ('.' + prec if prec else '') + spec_out
+        return pattern % value
+
+    return CONV_RE.sub(conv, fmt)
+
+def read_number(payload, pos):
+    value, shift = 0, 0
+    while pos < len(payload):
+        byte = payload[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return value, pos
+
+def decode_args(fmt, payload):
+    # an argument is a string for "%s", a number otherwise; '*' takes a number
+    args, pos = [], 0
+    for m in CONV_RE.finditer(fmt):
+        _, width, prec, _, spec = m.groups()
+        if spec == '%':
+            continue
+        for star in (width, prec):
+            if star == '*':
+                value, pos = read_number(payload, pos)
+                args.append(value)
+        if spec == 's' and pos < len(payload):
+            length = payload[pos]
+            args.append(payload[pos + 1:pos + 1 + length].decode('utf-8', 'replace'))
+            pos += 1 + length
+        else:
+            value, pos = read_number(payload, pos)
+            args.append(value)
+    return args
+
+def unescape(data, pos, count):
+    out = bytearray()
+    while len(out) < count and pos < len(data):
+        byte = data[pos]
+        pos += 1
+        if byte == ESCAPE and pos < len(data):
+            byte = data[pos] ^ 0x20
+            pos += 1
+        out.append(byte)
+    return bytes(out), pos
+
+def decode(section, data, out):
+    pos = 0
+    while pos < len(data):
+        start = data.find(b'\xff', pos)
+        if start < 0:
+            start = len(data)
+        out.write(data[pos:start].decode('utf-8', 'replace'))
+        if start == len(data):
+            break
+
+        header, pos = unescape(data, start + 1, 3)
+        if len(header) < 3:
+            break
+        offset = header[0] | header[1] << 8
+        payload, pos = unescape(data, pos, header[2])
+
+        fmt = format_at(section, offset)
+        if fmt is None:
+            out.write('<binlog: unknown format 0x%04x>\n' % offset)
+            continue
+        out.write(render(fmt, decode_args(fmt, payload)))
+
+def main():
+    parser = argparse.ArgumentParser(description='decode RT_BINLOG output')
+    parser.add_argument('elf', help='firmware ELF')
+    parser.add_argument('capture', nargs='?', help='raw console capture, default stdin')
+    parser.add_argument('--objcopy', default='riscv64-unknown-elf-objcopy',
+                        help='objcopy of the toolchain')
+    args = parser.parse_args()
+
+    section = load_formats(args.objcopy, args.elf)
+    if args.capture:
+        with open(args.capture, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read() if hasattr(sys.stdin, 'buffer') else sys.stdin.read()
+
+    decode(section, bytearray(data), sys.stdout)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2006-2018, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Symbolize the output of msh "memprof" / "memprof -l" commands.
+#
+# Every 0xXXXXXXXX word on the console log which addr2line can map to a
+# function of the firmware gets "function (file:line)" appended to its line.
+#
+# usage: python memprof.py rtthread.elf [console.log]
+#        (console log is read from stdin when omitted)
+#
+
+import re
+import sys
+import argparse
+import subprocess
+
+ADDR_RE = re.compile(r'0x[0-9a-fA-F]{8}')
+
+def symbolize(addr2line, elf, addrs):
+    # the recorded address is the return address, step back into the call
+    query = ['0x%x' % (int(a, 16) - 1) for a in addrs]
+    out = subprocess.check_output([addr2line, '-f', '-C', '-s', '-e', elf] + query)
+    lines = out.decode('utf-8', 'replace').splitlines()
+
+    symbols = {}
+    for i, addr in enumerate(addrs):
+        func = lines[2 * i].strip()
+        loc = lines[2 * i + 1].strip()
+        if func != '??':
+            symbols[addr] = '%s (%s)' % (func, loc)
+    return symbols
+
+def main():
+    parser = argparse.ArgumentParser(description='symbolize memprof output')
+    parser.add_argument('elf', help='firmware ELF with debug information')
+    parser.add_argument('log', nargs='?', help='console log, default stdin')
+    parser.add_argument('--addr2line', default='riscv64-unknown-elf-addr2line',
+                        help='addr2line of the toolchain')
+    args = parser.parse_args()
+
+    text = open(args.log).read() if args.log else sys.stdin.read()
+    lines = text.splitlines()
+
+    addrs = sorted(set(a.lower() for l in lines for a in ADDR_RE.findall(l)))
+    symbols = symbolize(args.addr2line, args.elf, addrs) if addrs else {}
+
+    for line in lines:
+        names = [symbols[a.lower()] for a in ADDR_RE.findall(line) if a.lower() in symbols]
+        if names:
+            line = '%s  <- %s' % (line.rstrip(), ', '.join(names))
+        print(line)
+
+if __name__ == '__main__':
+    main()
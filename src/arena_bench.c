@@ -0,0 +1,183 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 临时缓冲区分配对比: 每个任务按 sm3/ex3_sample 的用法申请一组临时缓冲区
+ * (填充块 128 字节, 四个 1KB 图像和一个 2KB 压缩缓冲区, 两个小块),
+ * 任务结束时全部归还, 同时保留一个 48 字节的结果块到之后的任务才释放.
+ *   heap : 每块 rt_malloc, 结束时逐块 rt_free
+ *   arena: 每块 rt_arena_alloc, 结束时一次 rt_arena_reset
+ * 统计每个任务申请+归还临时缓冲区的平均和最坏周期数, 以及测试结束
+ * (结果块仍保留) 时堆的空闲总量和最大空闲块. arena 的区域在测试前从
+ * 堆里一次申请, arena 一行的 heap free 已扣除这部分.
+ */
+
+#ifdef RT_USING_ARENA
+
+#define ARENA_BENCH_JOBS        200
+#define ARENA_BENCH_RESULTS     8
+#define ARENA_BENCH_RESULT_SIZE 48
+
+static const rt_uint16_t arena_bench_mix[] =
+{
+    128, 1024, 1024, 2048, 1024, 1024, 64, 96
+};
+#define ARENA_BENCH_MIX_NR      (sizeof(arena_bench_mix) / sizeof(arena_bench_mix[0]))
+
+struct arena_result
+{
+    rt_uint32_t count;
+    rt_uint64_t total;
+    rt_uint32_t max;
+    rt_uint32_t fail;
+};
+
+static void *arena_bench_keep[ARENA_BENCH_RESULTS];
+
+static void arena_account(struct arena_result *result, rt_uint32_t cycles)
+{
+    result->count ++;
+    result->total += cycles;
+    if (cycles > result->max)
+        result->max = cycles;
+}
+
+/* 保留一个结果块, 挤掉最早的一个 */
+static void arena_keep_result(int job)
+{
+    int index = job % ARENA_BENCH_RESULTS;
+
+    rt_free(arena_bench_keep[index]);
+    arena_bench_keep[index] = rt_malloc(ARENA_BENCH_RESULT_SIZE);
+}
+
+static void arena_release_results(void)
+{
+    int index;
+
+    for (index = 0; index < ARENA_BENCH_RESULTS; index ++)
+    {
+        rt_free(arena_bench_keep[index]);
+        arena_bench_keep[index] = RT_NULL;
+    }
+}
+
+static void arena_report(const char *name, struct arena_result *result)
+{
+    rt_uint32_t free = 0, max_free = 0;
+
+    rt_memory_free_info(&free, &max_free);
+    rt_kprintf("%-6s %10d %10d %10d %10d %6d\n", name,
+               result->count ? (rt_uint32_t)(result->total / result->count) : 0,
+               result->max, free, max_free, result->fail);
+}
+
+static void arena_run_heap(int jobs, struct arena_result *result)
+{
+    void *buf[ARENA_BENCH_MIX_NR];
+    rt_uint32_t start, cycles;
+    int job, i;
+
+    rt_memset(result, 0, sizeof(*result));
+    for (job = 0; job < jobs; job ++)
+    {
+        start = rt_hw_cycle_get();
+        for (i = 0; i < ARENA_BENCH_MIX_NR; i ++)
+            buf[i] = rt_malloc(arena_bench_mix[i]);
+        cycles = rt_hw_cycle_get() - start;
+
+        arena_keep_result(job);
+
+        start = rt_hw_cycle_get();
+        for (i = 0; i < ARENA_BENCH_MIX_NR; i ++)
+        {
+            if (buf[i] == RT_NULL)
+                result->fail ++;
+            rt_free(buf[i]);
+        }
+        cycles += rt_hw_cycle_get() - start;
+
+        arena_account(result, cycles);
+    }
+}
+
+static void arena_run_arena(rt_arena_t arena, int jobs, struct arena_result *result)
+{
+    void *buf[ARENA_BENCH_MIX_NR];
+    rt_uint32_t start, cycles;
+    rt_arena_mark_t mark;
+    int job, i;
+
+    rt_memset(result, 0, sizeof(*result));
+    for (job = 0; job < jobs; job ++)
+    {
+        start = rt_hw_cycle_get();
+        mark = rt_arena_mark(arena);
+        for (i = 0; i < ARENA_BENCH_MIX_NR; i ++)
+            buf[i] = rt_arena_alloc(arena, arena_bench_mix[i]);
+        cycles = rt_hw_cycle_get() - start;
+
+        arena_keep_result(job);
+
+        for (i = 0; i < ARENA_BENCH_MIX_NR; i ++)
+        {
+            if (buf[i] == RT_NULL)
+                result->fail ++;
+        }
+
+        start = rt_hw_cycle_get();
+        rt_arena_reset(arena, mark);
+        cycles += rt_hw_cycle_get() - start;
+
+        arena_account(result, cycles);
+    }
+}
+
+int arena_bench(int argc, char **argv)
+{
+    struct arena_result heap, scratch;
+    rt_arena_t arena;
+    rt_size_t size = 0;
+    int jobs = ARENA_BENCH_JOBS;
+    int i;
+
+    if (argc > 1)
+        jobs = atoi(argv[1]);
+    if (jobs <= 0)
+    {
+        rt_kprintf("Usage: arena_bench [jobs]\n");
+        return -RT_ERROR;
+    }
+
+    for (i = 0; i < ARENA_BENCH_MIX_NR; i ++)
+        size += RT_ALIGN(arena_bench_mix[i], RT_ALIGN_SIZE);
+
+    /* arena 在测试开始前一次申请, 不随任务变化 */
+    arena = rt_arena_create(size);
+    if (arena == RT_NULL)
+    {
+        rt_kprintf("arena create failed, %d bytes\n", size);
+        return -RT_ENOMEM;
+    }
+
+    rt_kprintf("\n临时缓冲区分配 (%d 个任务, 每个 %d 块 %d 字节, 单位: 周期)\n",
+               jobs, ARENA_BENCH_MIX_NR, size);
+    rt_kprintf("method  job avg    job max    heap free  max free   fail\n");
+    rt_kprintf("------ ---------- ---------- ---------- ---------- ------\n");
+
+    arena_run_heap(jobs, &heap);
+    arena_report("heap", &heap);
+    arena_release_results();
+
+    arena_run_arena(arena, jobs, &scratch);
+    arena_report("arena", &scratch);
+    arena_release_results();
+
+    rt_arena_delete(arena);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(arena_bench, scratch arena vs heap per job: arena_bench [jobs]);
+
+#endif /* RT_USING_ARENA */
@@ -0,0 +1,67 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <rtbinlog.h>
+#include <stdlib.h>
+
+/*
+ * 二进制日志对比: 按 kalman_sample 的格式输出 lines 行,
+ * 分别用 rt_kprintf 和 RT_BINLOG, 统计每行的平均周期数和输出字节数.
+ * RT_BINLOG 的输出需要在主机上用 tools/binlog.py 还原.
+ * 周期数包含串口输出的时间, 打开 RT_USING_CONSOLE_ASYNC 时只含写入缓冲区.
+ */
+
+#ifdef RT_USING_BINLOG
+
+#define BINLOG_BENCH_LINES      10
+#define BINLOG_BENCH_FMT        "Sensor1: %d.%02d (bias:%d.%02d) | #%d\n"
+
+int binlog_bench(int argc, char **argv)
+{
+    static const char fmt[] SECTION("rt_binlog") RT_USED = BINLOG_BENCH_FMT;
+    static const rt_uint8_t type[5];
+    rt_ubase_t args[5] = {21, 37, -1, 5, 0};
+    rt_uint32_t start, text_cycles, bin_cycles;
+    rt_size_t text_bytes, bin_bytes;
+    char line[RT_CONSOLEBUF_SIZE];
+    int lines = BINLOG_BENCH_LINES;
+    int i;
+
+    if (argc > 1)
+        lines = atoi(argv[1]);
+    if (lines <= 0)
+    {
+        rt_kprintf("Usage: binlog_bench [lines]\n");
+        return -RT_ERROR;
+    }
+
+    text_cycles = 0;
+    for (i = 0; i < lines; i++)
+    {
+        start = rt_hw_cycle_get();
+        rt_kprintf(BINLOG_BENCH_FMT, 21, 37, -1, 5, i);
+        text_cycles += rt_hw_cycle_get() - start;
+    }
+
+    bin_cycles = 0;
+    for (i = 0; i < lines; i++)
+    {
+        start = rt_hw_cycle_get();
+        RT_BINLOG(BINLOG_BENCH_FMT, 21, 37, -1, 5, i);
+        bin_cycles += rt_hw_cycle_get() - start;
+    }
+
+    /* 每行的字节数 */
+    text_bytes = rt_snprintf(line, sizeof(line), BINLOG_BENCH_FMT, 21, 37, -1, 5, lines - 1);
+    args[4] = lines - 1;
+    bin_bytes = rt_binlog_write(fmt, type, args, 5);
+
+    rt_kprintf("\n日志输出对比 (%d 行, 单位: 周期/行, 字节/行)\n", lines);
+    rt_kprintf("method      cycles  bytes\n");
+    rt_kprintf("rt_kprintf %7d %6d\n", text_cycles / lines, text_bytes);
+    rt_kprintf("RT_BINLOG  %7d %6d\n", bin_cycles / lines, bin_bytes);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(binlog_bench, rt_kprintf vs RT_BINLOG cost per line: binlog_bench [lines]);
+
+#endif /* RT_USING_BINLOG */
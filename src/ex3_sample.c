@@ -71,52 +71,89 @@ void print_compressed_data(unsigned char *compressed, int compressed_size) {
     }
 }
 
+// 一次压缩/解压用到的全部图像缓冲区, 共 6KB, 不放在线程栈上
+struct ex3_buffers {
+    unsigned char original_image[IMAGE_HEIGHT][IMAGE_WIDTH];
+    unsigned char original_1d[IMAGE_WIDTH * IMAGE_HEIGHT];
+    unsigned char compressed_image[IMAGE_WIDTH * IMAGE_HEIGHT * 2];
+    unsigned char decompressed_1d[IMAGE_WIDTH * IMAGE_HEIGHT];
+    unsigned char decompressed_image[IMAGE_HEIGHT][IMAGE_WIDTH];
+};
+
 // 线程入口函数
 void ex3_sample(void *parameter) {
-    unsigned char original_image[IMAGE_HEIGHT][IMAGE_WIDTH];
-    generate_random_gray_matrix(original_image);
+    struct ex3_buffers *buf = RT_NULL;
+#ifdef RT_USING_ARENA
+    // 用线程的 arena (如线程池工作线程), 没有或不够则为这次任务建一个, 结束时一次归还
+    rt_arena_t arena = rt_arena_self();
+    rt_arena_t own = RT_NULL;
+    rt_arena_mark_t mark = 0;
+
+    if (arena != RT_NULL) {
+        mark = rt_arena_mark(arena);
+        buf = (struct ex3_buffers *)rt_arena_alloc(arena, sizeof(*buf));
+    }
+    if (buf == RT_NULL) {
+        arena = own = rt_arena_create(sizeof(*buf));
+        if (arena == RT_NULL) {
+            rt_kprintf("ex3_sample: 内存不足\n");
+            return;
+        }
+        mark = 0;
+        buf = (struct ex3_buffers *)rt_arena_alloc(arena, sizeof(*buf));
+    }
+#else
+    buf = (struct ex3_buffers *)rt_malloc(sizeof(*buf));
+    if (buf == RT_NULL) {
+        rt_kprintf("ex3_sample: 内存不足\n");
+        return;
+    }
+#endif
+
+    generate_random_gray_matrix(buf->original_image);
 
     // 转换为一维数组
-    unsigned char original_1d[IMAGE_WIDTH * IMAGE_HEIGHT];
     for (int y = 0; y < IMAGE_HEIGHT; y++) {
         for (int x = 0; x < IMAGE_WIDTH; x++) {
-            original_1d[y * IMAGE_WIDTH + x] = original_image[y][x];
+            buf->original_1d[y * IMAGE_WIDTH + x] = buf->original_image[y][x];
         }
     }
 
     // 打印压缩前的图像矩阵
     rt_kprintf("压缩前的图像矩阵\n");
-    print_image_matrix(original_image);
+    print_image_matrix(buf->original_image);
 
-    // 分配压缩后图像的内存
-    unsigned char compressed_image[IMAGE_WIDTH * IMAGE_HEIGHT * 2];
     int compressed_size;
 
     // 压缩图像
-    compress_image(original_1d, compressed_image, &compressed_size);
+    compress_image(buf->original_1d, buf->compressed_image, &compressed_size);
     rt_kprintf("图像压缩完成，压缩后大小: %d 字节\n", compressed_size);
 
     // 打印压缩后的数据
     rt_kprintf("压缩后的数据\n");
-    print_compressed_data(compressed_image, compressed_size);
-
-    // 分配解压后图像的内存
-    unsigned char decompressed_1d[IMAGE_WIDTH * IMAGE_HEIGHT];
+    print_compressed_data(buf->compressed_image, compressed_size);
 
     // 解压图像
-    decompress_image(compressed_image, compressed_size, decompressed_1d);
+    decompress_image(buf->compressed_image, compressed_size, buf->decompressed_1d);
     rt_kprintf("图像解压完成\n");
 
     // 将一维解压数组转换为二维矩阵
-    unsigned char decompressed_image[IMAGE_HEIGHT][IMAGE_WIDTH];
     for (int y = 0; y < IMAGE_HEIGHT; y++) {
         for (int x = 0; x < IMAGE_WIDTH; x++) {
-            decompressed_image[y][x] = decompressed_1d[y * IMAGE_WIDTH + x];
+            buf->decompressed_image[y][x] = buf->decompressed_1d[y * IMAGE_WIDTH + x];
         }
     }
 
     // 打印解压后的图像矩阵
     rt_kprintf("解压后的图像矩阵\n");
-    print_image_matrix(decompressed_image);
+    print_image_matrix(buf->decompressed_image);
 
-}
+#ifdef RT_USING_ARENA
+    rt_arena_reset(arena, mark);
+    if (own != RT_NULL) {
+        rt_arena_delete(own);
+    }
+#else
+    rt_free(buf);
+#endif
+}
\ No newline at end of file
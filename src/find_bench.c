@@ -0,0 +1,121 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 对象查找性能测试: 注册 count 个设备 ("fb0" ~ "fbN"), 统计 rt_device_find
+ * 查找最早注册的 (类链表末尾), 最后注册的 (链表头) 和不存在的名字,
+ * 以及 rt_thread_find 查找 tidle 的平均周期数, 括号内为原来按类链表
+ * 逐个 rt_strncmp 的查找. 打开和关闭 RT_USING_OBJECT_HASH 时结果应相同,
+ * 只是周期数不同.
+ */
+
+#ifdef RT_USING_DEVICE
+
+#define FIND_BENCH_COUNT        256
+#define FIND_BENCH_ROUNDS       100
+
+/* 原来的查找: 在调度器锁内遍历类链表 */
+static rt_object_t list_find(const char *name, rt_uint8_t type)
+{
+    struct rt_object_information *information;
+    struct rt_object *object;
+    struct rt_list_node *node;
+
+    rt_enter_critical();
+    information = rt_object_get_information((enum rt_object_class_type)type);
+    for (node  = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        object = rt_list_entry(node, struct rt_object, list);
+        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        {
+            rt_exit_critical();
+            return object;
+        }
+    }
+    rt_exit_critical();
+
+    return RT_NULL;
+}
+
+static void find_bench_one(const char *label, const char *name, rt_uint8_t type, int rounds)
+{
+    rt_uint32_t start, t_find, b_find;
+    rt_object_t found, expect;
+    int r;
+
+    t_find = b_find = 0;
+    found = expect = RT_NULL;
+    for (r = 0; r < rounds; r++)
+    {
+        start = rt_hw_cycle_get();
+        if (type == RT_Object_Class_Thread)
+            found = (rt_object_t)rt_thread_find((char *)name);
+        else
+            found = (rt_object_t)rt_device_find(name);
+        t_find += rt_hw_cycle_get() - start;
+
+        start = rt_hw_cycle_get();
+        expect = list_find(name, type);
+        b_find += rt_hw_cycle_get() - start;
+    }
+
+    rt_kprintf("%-8s %-8s %6d (%6d)%s\n", label, name, t_find / rounds, b_find / rounds,
+               found == expect ? "" : "  MISMATCH");
+}
+
+int find_bench(int argc, char **argv)
+{
+    struct rt_device *devices;
+    char name[RT_NAME_MAX];
+    int count = FIND_BENCH_COUNT;
+    int rounds = FIND_BENCH_ROUNDS;
+    int registered, i;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2)
+        rounds = atoi(argv[2]);
+    if (count <= 0 || count > 9999 || rounds <= 0)
+    {
+        rt_kprintf("Usage: find_bench [count] [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    devices = (struct rt_device *)rt_calloc(count, sizeof(struct rt_device));
+    if (devices == RT_NULL)
+    {
+        rt_kprintf("find_bench: no memory for %d devices\n", count);
+        return -RT_ENOMEM;
+    }
+
+    for (registered = 0; registered < count; registered++)
+    {
+        rt_snprintf(name, sizeof(name), "fb%d", registered);
+        if (rt_device_register(&devices[registered], name, RT_DEVICE_FLAG_RDWR) != RT_EOK)
+            break;
+    }
+
+    rt_kprintf("\n对象查找性能 (%d 个设备, %d 次平均, 单位: 周期, 括号内为遍历类链表)\n",
+               registered, rounds);
+    rt_kprintf("case     name     find   (list)\n");
+
+    find_bench_one("first", "fb0", RT_Object_Class_Device, rounds);
+    rt_snprintf(name, sizeof(name), "fb%d", registered / 2);
+    find_bench_one("middle", name, RT_Object_Class_Device, rounds);
+    rt_snprintf(name, sizeof(name), "fb%d", registered - 1);
+    find_bench_one("last", name, RT_Object_Class_Device, rounds);
+    find_bench_one("missing", "nodev", RT_Object_Class_Device, rounds);
+    find_bench_one("thread", "tidle", RT_Object_Class_Thread, rounds);
+
+    for (i = 0; i < registered; i++)
+        rt_device_unregister(&devices[i]);
+    rt_free(devices);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(find_bench, rt_device_find/rt_thread_find with many objects: find_bench [count] [rounds]);
+
+#endif /* RT_USING_DEVICE */
@@ -1,4 +1,5 @@
 #include <rtthread.h>
+#include <rtbinlog.h>
 #include "kalman_filter.h"
 #include <stdlib.h>  // 添加标准库头文件
 #include <rtthread.h>
@@ -14,9 +15,55 @@ ALIGN(RT_ALIGN_SIZE)
 static char thread_k_stack[THREAD_STACK_SIZE];
 static struct rt_thread thread_k;
 
+/* 显示线程, 订阅滤波结果 */
+ALIGN(RT_ALIGN_SIZE)
+static char thread_d_stack[THREAD_STACK_SIZE];
+static struct rt_thread thread_d;
+
+/* 控制线程, 订阅滤波结果并计算执行量 */
+ALIGN(RT_ALIGN_SIZE)
+static char thread_c_stack[THREAD_STACK_SIZE];
+static struct rt_thread thread_c;
+
+/* 比例控制: 目标值, 增益和执行量限幅 */
+#define KF_CTRL_SETPOINT  50.0f
+#define KF_CTRL_KP        0.5f
+#define KF_CTRL_LIMIT     5.0f
+
 /* 传感器上下文 */
 static multi_kalman_filter_t sensor_filter;
 
+/* 话题样本: 原始测量值与融合估计值 */
+struct kf_raw_sample
+{
+    float z1;
+    float z2;
+};
+
+struct kf_est_sample
+{
+    float x_hat;
+    float bias[2];
+};
+
+/* 每个话题只保存最新一份样本, 订阅者之间不再各自排队拷贝 */
+static struct rt_topic kf_raw_topic;
+static struct rt_topic kf_est_topic;
+static struct kf_raw_sample kf_raw_buf;
+static struct kf_est_sample kf_est_buf;
+
+/* 日志订阅者: 发布时回调, 只记录发布次数 */
+static struct rt_topic_sub kf_log_sub;
+static rt_uint32_t kf_log_count;
+
+/* 控制线程输出的执行量, 超时未收到估计值时回到 0 */
+static volatile float kf_ctrl_output;
+
+static void kf_log_notify(rt_topic_sub_t sub, void *parameter)
+{
+    kf_log_count ++;
+}
+
 /* 模拟传感器读数 */
 static float simulate_sensor1(void)
 {
@@ -43,27 +90,83 @@ static void kalman_thread_entry(void *parameter)
 
     while (1) 
     {
+        struct kf_raw_sample raw;
+        struct kf_est_sample est;
+
         /* 获取传感器数据 */
-        float z1 = simulate_sensor1();
-        float z2 = simulate_sensor2();
+        raw.z1 = simulate_sensor1();
+        raw.z2 = simulate_sensor2();
+        rt_topic_publish(&kf_raw_topic, &raw);
 
         /* 执行卡尔曼滤波 */
-        float result = multi_kalman_update(&sensor_filter, z1, z2);
-
-        /* 输出结果 */
-        rt_kprintf("Sensor1: %d.%02d (bias:%d.%02d) | ",
-            (int)z1, (int)(fabs(z1 - (int)z1) * 100),
-            (int)sensor_filter.bias[0], (int)(fabs(sensor_filter.bias[0] - (int)sensor_filter.bias[0]) * 100));
-        rt_kprintf("Sensor2: %d.%02d (bias:%d.%02d)\n",
-            (int)z2, (int)(fabs(z2 - (int)z2) * 100),
-            (int)sensor_filter.bias[1], (int)(fabs(sensor_filter.bias[1] - (int)sensor_filter.bias[1]) * 100));
-        rt_kprintf("=> Kalman Result: %d.%02d\n\n",
-            (int)result, (int)(fabs(result - (int)result) * 100));
+        est.x_hat = multi_kalman_update(&sensor_filter, raw.z1, raw.z2);
+        est.bias[0] = sensor_filter.bias[0];
+        est.bias[1] = sensor_filter.bias[1];
+        rt_topic_publish(&kf_est_topic, &est);
+
         /* 500ms 采样间隔 */
         rt_thread_mdelay(500);
     }
 }
 
+/* 控制线程入口: 每个新估计值计算一次执行量 */
+static void control_thread_entry(void *parameter)
+{
+    struct rt_topic_sub est_sub;
+    struct kf_est_sample est;
+    float output;
+
+    rt_topic_subscribe(&kf_est_topic, &est_sub, RT_NULL, RT_NULL);
+
+    while (1)
+    {
+        /* 估计值中断时不再按旧值控制 */
+        if (rt_topic_wait(&est_sub, RT_TICK_PER_SECOND) != RT_EOK)
+        {
+            kf_ctrl_output = 0.0f;
+            continue;
+        }
+
+        rt_topic_read(&est_sub, &est);
+        output = KF_CTRL_KP * (KF_CTRL_SETPOINT - est.x_hat);
+        if (output > KF_CTRL_LIMIT)
+            output = KF_CTRL_LIMIT;
+        else if (output < -KF_CTRL_LIMIT)
+            output = -KF_CTRL_LIMIT;
+        kf_ctrl_output = output;
+    }
+}
+
+/* 显示线程入口: 阻塞等待新的估计值 */
+static void display_thread_entry(void *parameter)
+{
+    struct rt_topic_sub raw_sub, est_sub;
+    struct kf_raw_sample raw;
+    struct kf_est_sample est;
+
+    rt_topic_subscribe(&kf_raw_topic, &raw_sub, RT_NULL, RT_NULL);
+    rt_topic_subscribe(&kf_est_topic, &est_sub, RT_NULL, RT_NULL);
+
+    while (1)
+    {
+        if (rt_topic_wait(&est_sub, RT_TICK_PER_SECOND) != RT_EOK)
+        {
+            rt_kprintf("kalman: no sample in 1s\n");
+            continue;
+        }
+
+        rt_topic_read(&est_sub, &est);
+        if (rt_topic_read(&raw_sub, &raw) != RT_EOK)
+            continue;
+
+        /* 输出结果, 打开 RT_USING_BINLOG 时只输出格式串编号和参数 */
+        RT_BINLOG("Sensor1: %.2f (bias:%.2f) | ", raw.z1, est.bias[0]);
+        RT_BINLOG("Sensor2: %.2f (bias:%.2f)\n", raw.z2, est.bias[1]);
+        RT_BINLOG("=> Kalman Result: %.2f (#%d)\n", est.x_hat, kf_log_count);
+        RT_BINLOG("=> Control: %.2f\n\n", kf_ctrl_output);
+    }
+}
+
 /* 卡尔曼示例初始化 */
 int kalman_sample(void)
 {
@@ -74,6 +177,35 @@ int kalman_sample(void)
 
     rt_err_t result;
 
+    /* 创建话题 */
+    rt_topic_init(&kf_raw_topic, "kf_raw", &kf_raw_buf, sizeof(kf_raw_buf), RT_IPC_FLAG_FIFO);
+    rt_topic_init(&kf_est_topic, "kf_est", &kf_est_buf, sizeof(kf_est_buf), RT_IPC_FLAG_FIFO);
+    rt_topic_subscribe(&kf_est_topic, &kf_log_sub, kf_log_notify, RT_NULL);
+
+    /* 控制线程优先级最高, 先于显示线程拿到估计值 */
+    result = rt_thread_init(&thread_c,
+                          "thread_c",
+                          control_thread_entry,
+                          RT_NULL,
+                          thread_c_stack,
+                          sizeof(thread_c_stack),
+                          THREAD_PRIORITY - 2,
+                          THREAD_TIMESLICE);
+    if (result == RT_EOK)
+        rt_thread_startup(&thread_c);
+
+    /* 显示线程优先级高于滤波线程, 先订阅再开始发布 */
+    result = rt_thread_init(&thread_d,
+                          "thread_d",
+                          display_thread_entry,
+                          RT_NULL,
+                          thread_d_stack,
+                          sizeof(thread_d_stack),
+                          THREAD_PRIORITY - 1,
+                          THREAD_TIMESLICE);
+    if (result == RT_EOK)
+        rt_thread_startup(&thread_d);
+
     /* 创建线程 */
     result = rt_thread_init(&thread_k,
                           "thread_k",
@@ -6,6 +6,9 @@
 #include <rtthread.h>
 #include <rthw.h>
 #include "calculator.h"
+#ifdef RT_USING_PT
+#include <rtpt.h>
+#endif
 #include <stdint.h>
 
 #define SegDig_ADDR     0x8000103C
@@ -15,6 +18,31 @@
 #define READ_GPIO(dir) (*(volatile unsigned *)dir)
 #define WRITE_GPIO(dir, value) { (*(volatile unsigned *)dir) = (value); }
 
+#ifdef RT_USING_PT
+// LED闪烁协程, 与其他协程共用 pt 线程的栈, 不再单独占用 512 字节线程栈
+static struct rt_pt pt_led;
+static rt_uint32_t pt_led_count;
+
+static int pt_led_entry(struct rt_pt *pt)
+{
+    RT_PT_BEGIN(pt);
+    while (1)
+    {
+        if (pt_led_count % 2 == 0)
+        {
+            WRITE_GPIO(GPIO_LEDs, 0xAAAA);
+        }
+        else
+        {
+            WRITE_GPIO(GPIO_LEDs, 0x5555);
+        }
+        pt_led_count++;
+        RT_PT_DELAY(pt, rt_tick_from_millisecond(500));
+    }
+    RT_PT_END(pt);
+}
+#endif
+
 // LED闪烁线程
 void thread_led_entry(void *parameter)
 {
@@ -36,7 +64,9 @@ void thread_led_entry(void *parameter)
 
 int main(void)
 {
+#ifndef RT_USING_PT
     rt_thread_t thread_led = RT_NULL;
+#endif
     rt_thread_t calculator_thread = RT_NULL;
     rt_uint32_t sw_v = 0;
     int calculator_running = 0;
@@ -44,10 +74,16 @@ int main(void)
     rt_kprintf("\n\n=== 简易计算器演示程序 ===\n");
     rt_kprintf("按下 SW8 启动计算器\n");  // 改为SW8
     
+#ifdef RT_USING_PT
+    // 启动LED闪烁协程
+    rt_pt_init(&pt_led, "led", pt_led_entry, RT_NULL);
+    rt_pt_startup(&pt_led);
+#else
     // 创建LED闪烁线程
     thread_led = rt_thread_create("led", thread_led_entry, RT_NULL,
                                  512, 1, 5);
     rt_thread_startup(thread_led);
+#endif
     
     // 主循环
     while (1)
@@ -0,0 +1,543 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 堆分配器延迟对比: 同一组随机的申请/释放序列依次跑在各个后端上,
+ * 统计每次 malloc/free 的平均和最坏周期数.
+ * 系统堆 (rt_malloc) 的后端由 rtconfig.h 决定, memheap 和 TLSF 打开时
+ * 额外在一块从系统堆借来的区域上建一个私有堆参与对比; RT_USING_MP_CLASS
+ * 打开时加上按大小分级的内存池分配器.
+ */
+
+#define BENCH_SLOTS         24
+#define BENCH_OPS           2000
+#define BENCH_REGION_SIZE   (12 * 1024)
+
+struct bench_backend
+{
+    const char *name;
+    void *(*alloc)(void *ctx, rt_size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;
+};
+
+struct bench_result
+{
+    rt_uint32_t alloc_count;
+    rt_uint64_t alloc_total;
+    rt_uint32_t alloc_max;
+    rt_uint32_t free_count;
+    rt_uint64_t free_total;
+    rt_uint32_t free_max;
+    rt_uint32_t fail;
+};
+
+/* 固定种子的线性同余发生器, 每个后端看到的序列完全相同 */
+static rt_uint32_t bench_seed;
+
+static rt_uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245 + 12345;
+    return bench_seed >> 8;
+}
+
+/* 大小分布: 70% 小块 8~64, 25% 中块 64~512, 5% 大块 512~2048 */
+static rt_size_t bench_size(void)
+{
+    rt_uint32_t r = bench_rand() % 100;
+
+    if (r < 70)
+        return 8 + bench_rand() % 57;
+    if (r < 95)
+        return 64 + bench_rand() % 449;
+    return 512 + bench_rand() % 1537;
+}
+
+static void bench_run(const struct bench_backend *backend, int ops, struct bench_result *result)
+{
+    void *slot[BENCH_SLOTS];
+    rt_uint32_t start, cycles;
+    int i, index;
+
+    rt_memset(slot, 0, sizeof(slot));
+    rt_memset(result, 0, sizeof(*result));
+    bench_seed = 0x5eed;
+
+    for (i = 0; i < ops; i++)
+    {
+        index = bench_rand() % BENCH_SLOTS;
+
+        if (slot[index] == RT_NULL)
+        {
+            rt_size_t size = bench_size();
+
+            start = rt_hw_cycle_get();
+            slot[index] = backend->alloc(backend->ctx, size);
+            cycles = rt_hw_cycle_get() - start;
+
+            if (slot[index] == RT_NULL)
+            {
+                result->fail ++;
+                continue;
+            }
+
+            result->alloc_count ++;
+            result->alloc_total += cycles;
+            if (cycles > result->alloc_max)
+                result->alloc_max = cycles;
+        }
+        else
+        {
+            start = rt_hw_cycle_get();
+            backend->free(backend->ctx, slot[index]);
+            cycles = rt_hw_cycle_get() - start;
+            slot[index] = RT_NULL;
+
+            result->free_count ++;
+            result->free_total += cycles;
+            if (cycles > result->free_max)
+                result->free_max = cycles;
+        }
+    }
+
+    /* 归还剩余的块, 不计入统计 */
+    for (i = 0; i < BENCH_SLOTS; i++)
+    {
+        if (slot[i] != RT_NULL)
+            backend->free(backend->ctx, slot[i]);
+    }
+}
+
+static void bench_report(const struct bench_backend *backend, int ops)
+{
+    struct bench_result result;
+
+    bench_run(backend, ops, &result);
+
+    rt_kprintf("%-10s %10d %10d %10d %10d %6d\n",
+               backend->name,
+               result.alloc_count ? (rt_uint32_t)(result.alloc_total / result.alloc_count) : 0,
+               result.alloc_max,
+               result.free_count ? (rt_uint32_t)(result.free_total / result.free_count) : 0,
+               result.free_max,
+               result.fail);
+}
+
+/* 系统堆 */
+static void *heap_alloc(void *ctx, rt_size_t size)
+{
+    return rt_malloc(size);
+}
+
+static void heap_free(void *ctx, void *ptr)
+{
+    rt_free(ptr);
+}
+
+/*
+ * 系统堆后端按 mem.c/slab.c/memheap.c/tlsf.c 的编译条件判断. RT_USING_SMALL_MEM
+ * 和 RT_USING_SLAB 同时打开时, 链接的是 mem.c (库中先出现); 此时不能引用
+ * slab.c 中的函数, 否则 slab.o 也被链接进来, rt_malloc 等重复定义.
+ */
+#if defined(RT_USING_TLSF_MEM)
+#define HEAP_BACKEND_NAME   "heap/tlsf"
+#elif defined(RT_USING_MEMHEAP_AS_HEAP)
+#define HEAP_BACKEND_NAME   "heap/mhp"
+#elif defined(RT_USING_SMALL_MEM)
+#define HEAP_BACKEND_NAME   "heap/mem"
+#elif defined(RT_USING_SLAB)
+#define HEAP_BACKEND_NAME   "heap/slab"
+#define BENCH_USING_SLAB
+#else
+#define HEAP_BACKEND_NAME   "heap/mem"
+#endif
+
+#if defined(RT_USING_MEMHEAP) && !defined(RT_USING_MEMHEAP_AS_HEAP)
+static void *memheap_alloc(void *ctx, rt_size_t size)
+{
+    return rt_memheap_alloc((struct rt_memheap *)ctx, size);
+}
+
+static void memheap_free(void *ctx, void *ptr)
+{
+    rt_memheap_free(ptr);
+}
+#endif
+
+#ifdef RT_USING_MP_CLASS
+static void *mp_class_alloc(void *ctx, rt_size_t size)
+{
+    return rt_mp_class_malloc(size);
+}
+
+static void mp_class_free(void *ctx, void *ptr)
+{
+    rt_mp_class_free(ptr);
+}
+#endif
+
+#if defined(RT_USING_TLSF) && !defined(RT_USING_TLSF_MEM)
+static void *tlsf_alloc(void *ctx, rt_size_t size)
+{
+    return rt_tlsf_alloc((rt_tlsf_t)ctx, size);
+}
+
+static void tlsf_free(void *ctx, void *ptr)
+{
+    rt_tlsf_free((rt_tlsf_t)ctx, ptr);
+}
+#endif
+
+int mem_bench(int argc, char **argv)
+{
+    struct bench_backend backend;
+    int ops = BENCH_OPS;
+
+    if (argc > 1)
+        ops = atoi(argv[1]);
+    if (ops <= 0)
+    {
+        rt_kprintf("Usage: mem_bench [ops]\n");
+        return -RT_ERROR;
+    }
+
+    rt_kprintf("\n堆分配器延迟对比 (%d 次操作, 单位: 周期)\n", ops);
+    rt_kprintf("backend    alloc avg  alloc max  free avg   free max   fail\n");
+    rt_kprintf("---------- ---------- ---------- ---------- ---------- ------\n");
+
+    backend.name  = HEAP_BACKEND_NAME;
+    backend.alloc = heap_alloc;
+    backend.free  = heap_free;
+    backend.ctx   = RT_NULL;
+    bench_report(&backend, ops);
+
+#if defined(RT_USING_MEMHEAP) && !defined(RT_USING_MEMHEAP_AS_HEAP)
+    {
+        static struct rt_memheap bench_heap;
+        void *region = rt_malloc(BENCH_REGION_SIZE);
+
+        if (region != RT_NULL &&
+            rt_memheap_init(&bench_heap, "bench", region, BENCH_REGION_SIZE) == RT_EOK)
+        {
+            backend.name  = "memheap";
+            backend.alloc = memheap_alloc;
+            backend.free  = memheap_free;
+            backend.ctx   = &bench_heap;
+            bench_report(&backend, ops);
+
+            rt_memheap_detach(&bench_heap);
+        }
+        rt_free(region);
+    }
+#endif
+
+#if defined(RT_USING_TLSF) && !defined(RT_USING_TLSF_MEM)
+    {
+        rt_tlsf_t tlsf = RT_NULL;
+        void *region = rt_malloc(BENCH_REGION_SIZE);
+
+        if (region != RT_NULL)
+            tlsf = rt_tlsf_init("bench", region, BENCH_REGION_SIZE);
+        if (tlsf != RT_NULL)
+        {
+            backend.name  = "tlsf";
+            backend.alloc = tlsf_alloc;
+            backend.free  = tlsf_free;
+            backend.ctx   = tlsf;
+            bench_report(&backend, ops);
+
+            rt_tlsf_detach(tlsf);
+        }
+        rt_free(region);
+    }
+#endif
+
+#ifdef RT_USING_MP_CLASS
+    /* 256 字节以上仍走系统堆 */
+    backend.name  = "mp_class";
+    backend.alloc = mp_class_alloc;
+    backend.free  = mp_class_free;
+    backend.ctx   = RT_NULL;
+    bench_report(&backend, ops);
+#endif
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(mem_bench, heap allocator latency benchmark: mem_bench [ops]);
+
+/*
+ * 多线程小块抖动测试: 若干同优先级线程按时间片轮转, 各自随机申请/释放
+ * 8~64 字节的小块, 统计每次 malloc/free 的平均周期数. 打开
+ * RT_USING_SLAB_MAGAZINE 时同时给出不加锁完成的次数 (即省下的加锁次数)
+ * 和为补充/归还 magazine 实际加锁的次数.
+ */
+#define CHURN_THREADS_MAX   8
+#define CHURN_SLOTS         16
+#define CHURN_STACK_SIZE    1024
+#define CHURN_PRIORITY      20
+#define CHURN_TIMESLICE     2
+
+struct churn_worker
+{
+    rt_uint32_t seed;
+    int ops;
+    struct bench_result result;
+};
+
+static struct churn_worker churn_worker[CHURN_THREADS_MAX];
+static struct rt_semaphore churn_done;
+
+static void churn_entry(void *parameter)
+{
+    struct churn_worker *worker = (struct churn_worker *)parameter;
+    struct bench_result *result = &worker->result;
+    void *slot[CHURN_SLOTS];
+    rt_uint32_t start, cycles;
+    int i, index;
+
+    rt_memset(slot, 0, sizeof(slot));
+
+    for (i = 0; i < worker->ops; i++)
+    {
+        /* 每个线程独立的随机序列 */
+        worker->seed = worker->seed * 1103515245 + 12345;
+        index = (worker->seed >> 8) % CHURN_SLOTS;
+
+        if (slot[index] == RT_NULL)
+        {
+            rt_size_t size = 8 + (worker->seed >> 16) % 57;
+
+            start = rt_hw_cycle_get();
+            slot[index] = rt_malloc(size);
+            cycles = rt_hw_cycle_get() - start;
+
+            if (slot[index] == RT_NULL)
+            {
+                result->fail ++;
+                continue;
+            }
+
+            result->alloc_count ++;
+            result->alloc_total += cycles;
+            if (cycles > result->alloc_max)
+                result->alloc_max = cycles;
+        }
+        else
+        {
+            start = rt_hw_cycle_get();
+            rt_free(slot[index]);
+            cycles = rt_hw_cycle_get() - start;
+            slot[index] = RT_NULL;
+
+            result->free_count ++;
+            result->free_total += cycles;
+            if (cycles > result->free_max)
+                result->free_max = cycles;
+        }
+    }
+
+    for (i = 0; i < CHURN_SLOTS; i++)
+    {
+        if (slot[i] != RT_NULL)
+            rt_free(slot[i]);
+    }
+
+    rt_sem_release(&churn_done);
+}
+
+int mem_churn(int argc, char **argv)
+{
+    struct bench_result total;
+    rt_thread_t tid;
+    int threads = 4, ops = BENCH_OPS;
+    int i, started = 0;
+#if defined(BENCH_USING_SLAB) && defined(RT_USING_SLAB_MAGAZINE)
+    rt_uint32_t hit, exchange;
+#endif
+
+    if (argc > 1)
+        threads = atoi(argv[1]);
+    if (argc > 2)
+        ops = atoi(argv[2]);
+    if (threads <= 0 || threads > CHURN_THREADS_MAX || ops <= 0)
+    {
+        rt_kprintf("Usage: mem_churn [threads(1~%d)] [ops]\n", CHURN_THREADS_MAX);
+        return -RT_ERROR;
+    }
+
+#if defined(BENCH_USING_SLAB) && defined(RT_USING_SLAB_MAGAZINE)
+    rt_slab_mag_info(&hit, &exchange);
+#endif
+
+    rt_sem_init(&churn_done, "churn", 0, RT_IPC_FLAG_FIFO);
+    for (i = 0; i < threads; i++)
+    {
+        rt_memset(&churn_worker[i], 0, sizeof(churn_worker[i]));
+        churn_worker[i].seed = 0x5eed + i;
+        churn_worker[i].ops  = ops;
+
+        tid = rt_thread_create("churn", churn_entry, &churn_worker[i],
+                               CHURN_STACK_SIZE, CHURN_PRIORITY, CHURN_TIMESLICE);
+        if (tid == RT_NULL)
+            break;
+
+        rt_thread_startup(tid);
+        started ++;
+    }
+
+    for (i = 0; i < started; i++)
+        rt_sem_take(&churn_done, RT_WAITING_FOREVER);
+    rt_sem_detach(&churn_done);
+
+    rt_memset(&total, 0, sizeof(total));
+    for (i = 0; i < started; i++)
+    {
+        total.alloc_count += churn_worker[i].result.alloc_count;
+        total.alloc_total += churn_worker[i].result.alloc_total;
+        if (churn_worker[i].result.alloc_max > total.alloc_max)
+            total.alloc_max = churn_worker[i].result.alloc_max;
+        total.free_count  += churn_worker[i].result.free_count;
+        total.free_total  += churn_worker[i].result.free_total;
+        if (churn_worker[i].result.free_max > total.free_max)
+            total.free_max = churn_worker[i].result.free_max;
+        total.fail        += churn_worker[i].result.fail;
+    }
+
+    rt_kprintf("\n%s 多线程小块抖动 (%d 线程 x %d 次操作, 单位: 周期)\n",
+               HEAP_BACKEND_NAME, started, ops);
+    rt_kprintf("alloc avg  alloc max  free avg   free max   fail\n");
+    rt_kprintf("---------- ---------- ---------- ---------- ------\n");
+    rt_kprintf("%10d %10d %10d %10d %6d\n",
+               total.alloc_count ? (rt_uint32_t)(total.alloc_total / total.alloc_count) : 0,
+               total.alloc_max,
+               total.free_count ? (rt_uint32_t)(total.free_total / total.free_count) : 0,
+               total.free_max,
+               total.fail);
+
+#if defined(BENCH_USING_SLAB) && defined(RT_USING_SLAB_MAGAZINE)
+    {
+        rt_uint32_t hit_now, exchange_now;
+
+        rt_slab_mag_info(&hit_now, &exchange_now);
+        rt_kprintf("magazine: %d 次不加锁完成 (省下的加锁次数), %d 次加锁补充/归还\n",
+                   hit_now - hit, exchange_now - exchange);
+    }
+#else
+    rt_kprintf("magazine 未打开, 每次申请/释放都要加锁 (共 %d 次)\n",
+               total.alloc_count + total.free_count);
+#endif
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(mem_churn, multi-thread small block churn: mem_churn [threads] [ops]);
+
+#ifdef BENCH_USING_SLAB
+/*
+ * 页分配器长时间浸泡测试: 反复随机申请/释放 1~SOAK_MAX_PAGES 页,
+ * 每 SOAK_ZONE_EVERY 次申请中有一次申请一个 slab zone 的页数,
+ * 分 SOAK_WINDOWS 段输出每段的平均/最坏周期数, 以及段末的空闲页数,
+ * 最大空闲块和碎片率 (1 - 最大空闲块 / 空闲页数).
+ */
+#define SOAK_SLOTS          6
+#define SOAK_MAX_PAGES      2
+#define SOAK_ZONE_EVERY     4
+#define SOAK_WINDOWS        8
+
+int mem_soak(int argc, char **argv)
+{
+    struct
+    {
+        void *addr;
+        rt_size_t npages;
+    } slot[SOAK_SLOTS];
+    struct bench_result result;
+    rt_uint32_t start, cycles, free_pages, max_free, zone_pages;
+    int ops = BENCH_OPS * 10, window;
+    int i, index;
+
+    if (argc > 1)
+        ops = atoi(argv[1]);
+    if (ops < SOAK_WINDOWS)
+    {
+        rt_kprintf("Usage: mem_soak [ops]\n");
+        return -RT_ERROR;
+    }
+
+    rt_memset(slot, 0, sizeof(slot));
+    rt_memset(&result, 0, sizeof(result));
+    bench_seed = 0x5eed;
+    window = ops / SOAK_WINDOWS;
+    rt_page_info(RT_NULL, RT_NULL, RT_NULL, &zone_pages);
+
+    rt_kprintf("\n页分配器浸泡测试 (%d 次操作, zone %d 页, 单位: 周期)\n", ops, zone_pages);
+    rt_kprintf("ops        alloc avg  alloc max  free avg   free max   fail   free pg max pg frag%%\n");
+    rt_kprintf("---------- ---------- ---------- ---------- ---------- ------ ------- ------ -----\n");
+
+    for (i = 1; i <= ops; i++)
+    {
+        index = bench_rand() % SOAK_SLOTS;
+
+        if (slot[index].addr == RT_NULL)
+        {
+            if (bench_rand() % SOAK_ZONE_EVERY == 0)
+                slot[index].npages = zone_pages;
+            else
+                slot[index].npages = 1 + bench_rand() % SOAK_MAX_PAGES;
+
+            start = rt_hw_cycle_get();
+            slot[index].addr = rt_page_alloc(slot[index].npages);
+            cycles = rt_hw_cycle_get() - start;
+
+            if (slot[index].addr == RT_NULL)
+            {
+                result.fail ++;
+            }
+            else
+            {
+                result.alloc_count ++;
+                result.alloc_total += cycles;
+                if (cycles > result.alloc_max)
+                    result.alloc_max = cycles;
+            }
+        }
+        else
+        {
+            start = rt_hw_cycle_get();
+            rt_page_free(slot[index].addr, slot[index].npages);
+            cycles = rt_hw_cycle_get() - start;
+            slot[index].addr = RT_NULL;
+
+            result.free_count ++;
+            result.free_total += cycles;
+            if (cycles > result.free_max)
+                result.free_max = cycles;
+        }
+
+        if (i % window == 0)
+        {
+            rt_page_info(RT_NULL, &free_pages, &max_free, RT_NULL);
+            rt_kprintf("%10d %10d %10d %10d %10d %6d %7d %6d %5d\n",
+                       i,
+                       result.alloc_count ? (rt_uint32_t)(result.alloc_total / result.alloc_count) : 0,
+                       result.alloc_max,
+                       result.free_count ? (rt_uint32_t)(result.free_total / result.free_count) : 0,
+                       result.free_max,
+                       result.fail,
+                       free_pages,
+                       max_free,
+                       free_pages ? 100 - max_free * 100 / free_pages : 0);
+            rt_memset(&result, 0, sizeof(result));
+        }
+    }
+
+    for (i = 0; i < SOAK_SLOTS; i++)
+    {
+        if (slot[i].addr != RT_NULL)
+            rt_page_free(slot[i].addr, slot[i].npages);
+    }
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(mem_soak, page allocator soak benchmark: mem_soak [ops]);
+#endif
@@ -0,0 +1,153 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 内存操作性能测试: 对每个长度和源/目的地址偏移, 测量
+ * rt_memcpy, rt_memmove (目的地址在源地址之后, 重叠), rt_memset
+ * 和 rt_memcmp (两块相同, 比较到末尾) 的周期数, 并与逐字节循环对比.
+ * 结果为 rounds 次的平均值, 括号内为字节循环的周期数.
+ */
+
+#define MEMOPS_BENCH_ROUNDS     20
+#define MEMOPS_BENCH_MAX        512
+
+static const rt_uint16_t memops_bench_size[] =
+{
+    4, 16, 64, 256, 512
+};
+#define MEMOPS_BENCH_SIZE_NR    (sizeof(memops_bench_size) / sizeof(memops_bench_size[0]))
+
+/* 源偏移, 目的偏移 */
+static const rt_uint8_t memops_bench_align[][2] =
+{
+    {0, 0}, {1, 1}, {0, 1}, {1, 0}, {2, 1}, {3, 2}
+};
+#define MEMOPS_BENCH_ALIGN_NR   (sizeof(memops_bench_align) / sizeof(memops_bench_align[0]))
+
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t memops_src[MEMOPS_BENCH_MAX + 8];
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t memops_dst[MEMOPS_BENCH_MAX + 8];
+
+/* 对照用的逐字节实现, volatile 防止编译器改写成库函数 */
+static void byte_copy(void *dst, const void *src, rt_size_t n)
+{
+    volatile rt_uint8_t *d = (volatile rt_uint8_t *)dst;
+    const rt_uint8_t *s = (const rt_uint8_t *)src;
+
+    while (n--)
+        *d++ = *s++;
+}
+
+static void byte_copy_backward(void *dst, const void *src, rt_size_t n)
+{
+    volatile rt_uint8_t *d = (volatile rt_uint8_t *)dst + n;
+    const rt_uint8_t *s = (const rt_uint8_t *)src + n;
+
+    while (n--)
+        *--d = *--s;
+}
+
+static void byte_set(void *dst, int c, rt_size_t n)
+{
+    volatile rt_uint8_t *d = (volatile rt_uint8_t *)dst;
+
+    while (n--)
+        *d++ = (rt_uint8_t)c;
+}
+
+static int byte_cmp(const void *a, const void *b, rt_size_t n)
+{
+    const volatile rt_uint8_t *x = (const volatile rt_uint8_t *)a;
+    const rt_uint8_t *y = (const rt_uint8_t *)b;
+    int res = 0;
+
+    while (n-- && (res = *x++ - *y++) == 0)
+        ;
+
+    return res;
+}
+
+int memops_bench(int argc, char **argv)
+{
+    rt_uint32_t start, t_cpy, t_mov, t_set, t_cmp;
+    rt_uint32_t b_cpy, b_mov, b_set, b_cmp;
+    rt_uint8_t *src, *dst;
+    rt_size_t size;
+    int rounds = MEMOPS_BENCH_ROUNDS;
+    int s, a, r, i;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: memops_bench [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    for (i = 0; i < sizeof(memops_src); i++)
+        memops_src[i] = (rt_uint8_t)(i * 7 + 1);
+
+    rt_kprintf("\n内存操作性能 (%d 次平均, 单位: 周期, 括号内为逐字节循环)\n", rounds);
+    rt_kprintf("size s/d    memcpy        memmove       memset        memcmp\n");
+    rt_kprintf("---- --- ------------- ------------- ------------- -------------\n");
+
+    for (s = 0; s < MEMOPS_BENCH_SIZE_NR; s++)
+    {
+        size = memops_bench_size[s];
+        for (a = 0; a < MEMOPS_BENCH_ALIGN_NR; a++)
+        {
+            src = memops_src + memops_bench_align[a][0];
+            dst = memops_dst + memops_bench_align[a][1];
+            t_cpy = t_mov = t_set = t_cmp = 0;
+            b_cpy = b_mov = b_set = b_cmp = 0;
+
+            for (r = 0; r < rounds; r++)
+            {
+                start = rt_hw_cycle_get();
+                rt_memcpy(dst, src, size);
+                t_cpy += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_copy(dst, src, size);
+                b_cpy += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                rt_memcmp(dst, src, size);
+                t_cmp += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_cmp(dst, src, size);
+                b_cmp += rt_hw_cycle_get() - start;
+
+                /* 源和目的在同一缓冲区, 目的在后, 需要从尾部拷贝 */
+                start = rt_hw_cycle_get();
+                rt_memmove(memops_dst + 4 + memops_bench_align[a][1],
+                           memops_dst + memops_bench_align[a][0], size);
+                t_mov += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_copy_backward(memops_dst + 4 + memops_bench_align[a][1],
+                                   memops_dst + memops_bench_align[a][0], size);
+                b_mov += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                rt_memset(dst, 0x5a, size);
+                t_set += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_set(dst, 0x5a, size);
+                b_set += rt_hw_cycle_get() - start;
+            }
+
+            rt_kprintf("%4d %d/%d %5d (%5d) %5d (%5d) %5d (%5d) %5d (%5d)\n",
+                       size, memops_bench_align[a][0], memops_bench_align[a][1],
+                       t_cpy / rounds, b_cpy / rounds, t_mov / rounds, b_mov / rounds,
+                       t_set / rounds, b_set / rounds, t_cmp / rounds, b_cmp / rounds);
+        }
+    }
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(memops_bench, memcpy/memmove/memset/memcmp sweep: memops_bench [rounds]);
@@ -0,0 +1,159 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 内存池性能测试 (80 字节块, 4096 字节内存池, 共 48 块)
+ *   pair : 同一线程反复 rt_mp_alloc + rt_mp_free 一块
+ *   batch: rt_mp_alloc_batch + rt_mp_free_batch 一次 16 块
+ *   sample: 放大的 mempool_sample 模式. 线程 1 申请 50 块, 内存池空时
+ *          挂起; 优先级更低的线程 2 依次释放, 每次释放唤醒线程 1.
+ *          重复 rounds 轮
+ * 结果为每次申请或释放的平均周期数.
+ */
+
+#ifdef RT_USING_MEMPOOL
+
+#define MP_BENCH_ROUNDS         100
+#define MP_BENCH_PTR_NR         50
+#define MP_BENCH_BATCH          16
+#define MP_BENCH_BLOCK_SIZE     80
+
+#define MP_BENCH_PRIORITY       5
+#define MP_BENCH_STACK_SIZE     512
+
+static rt_uint8_t mp_bench_pool[4096];
+static struct rt_mempool mp_bench_mp;
+
+static void *mp_bench_ptr[MP_BENCH_PTR_NR];
+static struct rt_semaphore mp_bench_round;      /* 线程 1 完成一轮申请 */
+static struct rt_semaphore mp_bench_next;       /* 线程 2 释放完一轮 */
+static struct rt_semaphore mp_bench_done;
+static int mp_bench_rounds;
+
+static void mp_bench_report(const char *name, rt_uint32_t cycles, rt_uint32_t ops)
+{
+    rt_kprintf("%-6s %8d %6d.%02d\n", name, ops,
+               cycles / ops, (rt_uint32_t)((rt_uint64_t)cycles * 100 / ops) % 100);
+}
+
+/* 线程 1: 每轮申请 50 块, 内存池空时挂起 */
+static void mp_bench_alloc_entry(void *parameter)
+{
+    int round, i;
+
+    for (round = 0; round < mp_bench_rounds; round++)
+    {
+        for (i = 0; i < MP_BENCH_PTR_NR; i++)
+            mp_bench_ptr[i] = rt_mp_alloc(&mp_bench_mp, RT_WAITING_FOREVER);
+
+        rt_sem_release(&mp_bench_round);
+        rt_sem_take(&mp_bench_next, RT_WAITING_FOREVER);
+    }
+}
+
+/* 线程 2: 依次释放, 前两次释放让线程 1 拿到最后两块 */
+static void mp_bench_release_entry(void *parameter)
+{
+    void *block;
+    int round, i;
+
+    for (round = 0; round < mp_bench_rounds; round++)
+    {
+        for (i = 0; i < MP_BENCH_PTR_NR; i++)
+        {
+            block = mp_bench_ptr[i];
+            mp_bench_ptr[i] = RT_NULL;
+            rt_mp_free(block);
+        }
+
+        rt_sem_take(&mp_bench_round, RT_WAITING_FOREVER);
+        rt_sem_release(&mp_bench_next);
+    }
+
+    rt_sem_release(&mp_bench_done);
+}
+
+int mp_bench(int argc, char **argv)
+{
+    void *blocks[MP_BENCH_BATCH];
+    rt_uint32_t start, cycles, ops;
+    rt_thread_t tid1, tid2;
+    int rounds = MP_BENCH_ROUNDS;
+    int i;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: mp_bench [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    rt_mp_init(&mp_bench_mp, "mpbench", &mp_bench_pool[0], sizeof(mp_bench_pool),
+               MP_BENCH_BLOCK_SIZE);
+
+    rt_kprintf("\n内存池性能 (%d 块, 单位: 周期/次)\n", mp_bench_mp.block_total_count);
+    rt_kprintf("test        ops  cycles\n");
+
+    /* 1. 单块申请 + 释放 */
+    ops = rounds * MP_BENCH_PTR_NR;
+    start = rt_hw_cycle_get();
+    for (i = 0; i < (int)ops; i++)
+        rt_mp_free(rt_mp_alloc(&mp_bench_mp, 0));
+    cycles = rt_hw_cycle_get() - start;
+    mp_bench_report("pair", cycles, ops * 2);
+
+    /* 2. 批量申请 + 释放 */
+    ops = 0;
+    start = rt_hw_cycle_get();
+    for (i = 0; i < rounds * MP_BENCH_PTR_NR / MP_BENCH_BATCH; i++)
+    {
+        if (rt_mp_alloc_batch(&mp_bench_mp, blocks, MP_BENCH_BATCH, 0) != MP_BENCH_BATCH)
+            break;
+        rt_mp_free_batch(blocks, MP_BENCH_BATCH);
+        ops += MP_BENCH_BATCH * 2;
+    }
+    cycles = rt_hw_cycle_get() - start;
+    if (ops)
+        mp_bench_report("batch", cycles, ops);
+
+    /* 3. mempool_sample 模式, 线程 1 优先级高于线程 2 */
+    mp_bench_rounds = rounds;
+    rt_sem_init(&mp_bench_round, "mpbr", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&mp_bench_next, "mpbn", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&mp_bench_done, "mpbd", 0, RT_IPC_FLAG_FIFO);
+
+    tid1 = rt_thread_create("mpalloc", mp_bench_alloc_entry, RT_NULL,
+                            MP_BENCH_STACK_SIZE, MP_BENCH_PRIORITY, 5);
+    tid2 = rt_thread_create("mpfree", mp_bench_release_entry, RT_NULL,
+                            MP_BENCH_STACK_SIZE, MP_BENCH_PRIORITY + 1, 5);
+    if (tid1 == RT_NULL || tid2 == RT_NULL)
+    {
+        rt_kprintf("thread create failed\n");
+        if (tid1 != RT_NULL)
+            rt_thread_delete(tid1);
+        if (tid2 != RT_NULL)
+            rt_thread_delete(tid2);
+    }
+    else
+    {
+        start = rt_hw_cycle_get();
+        rt_thread_startup(tid1);
+        rt_thread_startup(tid2);
+        rt_sem_take(&mp_bench_done, RT_WAITING_FOREVER);
+        cycles = rt_hw_cycle_get() - start;
+        mp_bench_report("sample", cycles, rounds * MP_BENCH_PTR_NR * 2);
+        rt_kprintf("注: sample 含每轮两次挂起/唤醒和信号量同步的时间\n");
+    }
+
+    rt_sem_detach(&mp_bench_round);
+    rt_sem_detach(&mp_bench_next);
+    rt_sem_detach(&mp_bench_done);
+    rt_mp_detach(&mp_bench_mp);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(mp_bench, memory pool alloc/free cost: mp_bench [rounds]);
+
+#endif /* RT_USING_MEMPOOL */
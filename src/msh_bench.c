@@ -0,0 +1,99 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <finsh.h>
+#include <msh.h>
+#include <stdlib.h>
+
+/*
+ * msh 命令分发性能测试: 用 msh_exec 执行空命令 msh_nop, 统计每次的平均
+ * 周期数, 括号内为原来逐个 strncmp 遍历命令表查找同一命令的周期数.
+ * 打开 FINSH_USING_CMD_INDEX 后 msh_exec 的查找为二分查找, 与命令数基本无关.
+ */
+
+#ifdef FINSH_USING_MSH
+
+#define MSH_BENCH_ROUNDS        100
+
+static int msh_nop(int argc, char **argv)
+{
+    return 0;
+}
+MSH_CMD_EXPORT(msh_nop, empty command for msh_bench);
+
+/* 原来的查找: 遍历整个命令表 */
+static struct finsh_syscall *list_get_cmd(const char *cmd, int size)
+{
+    struct finsh_syscall *index;
+
+    for (index = _syscall_table_begin;
+            index < _syscall_table_end;
+            FINSH_NEXT_SYSCALL(index))
+    {
+        if (strncmp(index->name, "__cmd_", 6) != 0) continue;
+
+        if (strncmp(&index->name[6], cmd, size) == 0 &&
+                index->name[6 + size] == '\0')
+            return index;
+    }
+
+    return RT_NULL;
+}
+
+static void msh_bench_one(const char *name, int rounds)
+{
+    rt_uint32_t start, exec_cycles, list_cycles;
+    char line[RT_NAME_MAX * 2];
+    int size, r;
+
+    size = rt_strlen(name);
+    exec_cycles = list_cycles = 0;
+    for (r = 0; r < rounds; r++)
+    {
+        /* msh_exec 会改写命令行 */
+        rt_strncpy(line, name, sizeof(line));
+        start = rt_hw_cycle_get();
+        msh_exec(line, size);
+        exec_cycles += rt_hw_cycle_get() - start;
+
+        start = rt_hw_cycle_get();
+        list_get_cmd(name, size);
+        list_cycles += rt_hw_cycle_get() - start;
+    }
+
+    rt_kprintf("%-16s %7d (%7d)\n", name, exec_cycles / rounds, list_cycles / rounds);
+}
+
+int msh_bench(int argc, char **argv)
+{
+    struct finsh_syscall *index;
+    int rounds = MSH_BENCH_ROUNDS;
+    int count;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: msh_bench [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    count = 0;
+    for (index = _syscall_table_begin;
+            index < _syscall_table_end;
+            FINSH_NEXT_SYSCALL(index))
+    {
+        if (strncmp(index->name, "__cmd_", 6) == 0)
+            count ++;
+    }
+
+    rt_kprintf("\nmsh 命令分发 (%d 个命令, %d 次平均, 单位: 周期, 括号内为遍历命令表)\n",
+               count, rounds);
+    rt_kprintf("command          msh_exec (list)\n");
+
+    msh_bench_one("msh_nop", rounds);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(msh_bench, msh command dispatch cycles: msh_bench [rounds]);
+
+#endif /* FINSH_USING_MSH */
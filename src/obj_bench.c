@@ -0,0 +1,141 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 内核对象创建延迟测试: 反复创建/删除信号量, 互斥量, 事件, 定时器和线程,
+ * 统计每次 create 的平均和最坏周期数. 分别在打开和关闭
+ * RT_USING_OBJECT_CACHE 时运行, 对比对象缓存前后的差别.
+ * 线程删除后由 idle 线程回收, 所以每轮之间让出一个 tick.
+ */
+
+#define OBJ_BENCH_LOOPS     100
+
+struct obj_result
+{
+    rt_uint32_t count;
+    rt_uint64_t total;
+    rt_uint32_t max;
+};
+
+static void obj_account(struct obj_result *result, rt_uint32_t cycles)
+{
+    result->count ++;
+    result->total += cycles;
+    if (cycles > result->max)
+        result->max = cycles;
+}
+
+static void obj_report(const char *name, struct obj_result *result)
+{
+    rt_kprintf("%-10s %10d %10d\n", name,
+               result->count ? (rt_uint32_t)(result->total / result->count) : 0,
+               result->max);
+}
+
+static void obj_bench_entry(void *parameter)
+{
+}
+
+int obj_bench(int argc, char **argv)
+{
+    struct obj_result sem, mutex, event, timer, thread;
+    rt_uint32_t start, cycles;
+    int loops = OBJ_BENCH_LOOPS;
+    int i;
+
+    if (argc > 1)
+        loops = atoi(argv[1]);
+    if (loops <= 0)
+    {
+        rt_kprintf("Usage: obj_bench [loops]\n");
+        return -RT_ERROR;
+    }
+
+    rt_memset(&sem, 0, sizeof(sem));
+    rt_memset(&mutex, 0, sizeof(mutex));
+    rt_memset(&event, 0, sizeof(event));
+    rt_memset(&timer, 0, sizeof(timer));
+    rt_memset(&thread, 0, sizeof(thread));
+
+    for (i = 0; i < loops; i++)
+    {
+        rt_sem_t s;
+        rt_mutex_t m;
+#ifdef RT_USING_EVENT
+        rt_event_t e;
+#endif
+        rt_timer_t t;
+        rt_thread_t tid;
+
+        start = rt_hw_cycle_get();
+        s = rt_sem_create("bsem", 0, RT_IPC_FLAG_FIFO);
+        cycles = rt_hw_cycle_get() - start;
+        if (s != RT_NULL)
+        {
+            obj_account(&sem, cycles);
+            rt_sem_delete(s);
+        }
+
+        start = rt_hw_cycle_get();
+        m = rt_mutex_create("bmtx", RT_IPC_FLAG_FIFO);
+        cycles = rt_hw_cycle_get() - start;
+        if (m != RT_NULL)
+        {
+            obj_account(&mutex, cycles);
+            rt_mutex_delete(m);
+        }
+
+#ifdef RT_USING_EVENT
+        start = rt_hw_cycle_get();
+        e = rt_event_create("bevt", RT_IPC_FLAG_FIFO);
+        cycles = rt_hw_cycle_get() - start;
+        if (e != RT_NULL)
+        {
+            obj_account(&event, cycles);
+            rt_event_delete(e);
+        }
+#endif
+
+        start = rt_hw_cycle_get();
+        t = rt_timer_create("btmr", (void (*)(void *))obj_bench_entry, RT_NULL,
+                            10, RT_TIMER_FLAG_ONE_SHOT);
+        cycles = rt_hw_cycle_get() - start;
+        if (t != RT_NULL)
+        {
+            obj_account(&timer, cycles);
+            rt_timer_delete(t);
+        }
+
+        /* 线程栈仍从堆上申请, 这里计入的是对象 + 栈的总时间 */
+        start = rt_hw_cycle_get();
+        tid = rt_thread_create("bthr", obj_bench_entry, RT_NULL, 512, 20, 10);
+        cycles = rt_hw_cycle_get() - start;
+        if (tid != RT_NULL)
+        {
+            obj_account(&thread, cycles);
+            rt_thread_delete(tid);
+        }
+
+        /* 让 idle 线程回收被删除的线程 */
+        rt_thread_delay(1);
+    }
+
+#ifdef RT_USING_OBJECT_CACHE
+    rt_kprintf("\n对象创建延迟, 对象缓存打开 (%d 轮, 单位: 周期)\n", loops);
+#else
+    rt_kprintf("\n对象创建延迟, 对象缓存关闭 (%d 轮, 单位: 周期)\n", loops);
+#endif
+    rt_kprintf("object     create avg create max\n");
+    rt_kprintf("---------- ---------- ----------\n");
+    obj_report("semaphore", &sem);
+    obj_report("mutex", &mutex);
+#ifdef RT_USING_EVENT
+    obj_report("event", &event);
+#endif
+    obj_report("timer", &timer);
+    obj_report("thread", &thread);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(obj_bench, kernel object create latency: obj_bench [loops]);
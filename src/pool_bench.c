@@ -0,0 +1,136 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 线程池启动延迟测试: 对比两种方式启动一个短任务
+ *   1. rt_thread_create + rt_thread_startup, 任务返回后线程由 idle 回收
+ *   2. rt_thread_pool_submit + rt_thread_pool_wait, 复用已停放的工作线程
+ * 统计从发起到任务函数开始执行的周期数 (启动延迟), 以及完整一轮
+ * (启动 + 执行 + 回收) 的周期数, 同时给出两种方式前后的堆使用量.
+ * 任务运行在 NORMAL 档 (优先级高于 finsh), 发起后立即抢占执行.
+ */
+
+#ifdef RT_USING_THREAD_POOL
+
+#define POOL_BENCH_LOOPS        100
+#define POOL_BENCH_STACK_SIZE   1024
+#define POOL_BENCH_PRIO         12
+
+struct pool_result
+{
+    rt_uint32_t count;
+    rt_uint64_t launch;
+    rt_uint32_t launch_max;
+    rt_uint64_t round;
+};
+
+static volatile rt_uint32_t pool_bench_stamp;
+
+static void pool_bench_job(void *parameter)
+{
+    pool_bench_stamp = rt_hw_cycle_get();
+}
+
+static void pool_account(struct pool_result *result, rt_uint32_t start, rt_uint32_t end)
+{
+    rt_uint32_t launch = pool_bench_stamp - start;
+
+    result->count ++;
+    result->launch += launch;
+    if (launch > result->launch_max)
+        result->launch_max = launch;
+    result->round += end - start;
+}
+
+static void pool_report(const char *name, struct pool_result *result)
+{
+    if (result->count == 0)
+        return;
+
+    rt_kprintf("%-8s %10d %10d %10d\n", name,
+               (rt_uint32_t)(result->launch / result->count),
+               result->launch_max,
+               (rt_uint32_t)(result->round / result->count));
+}
+
+static void pool_heap_used(const char *stage)
+{
+#ifdef RT_USING_HEAP
+    rt_uint32_t total, used, max_used;
+
+    rt_memory_info(&total, &used, &max_used);
+    rt_kprintf("%-16s heap used %d, max used %d\n", stage, used, max_used);
+#endif
+}
+
+int pool_bench(int argc, char **argv)
+{
+    struct pool_result create, pool;
+    rt_uint32_t start;
+    rt_thread_t tid;
+    rt_pool_job_t job;
+    int loops = POOL_BENCH_LOOPS;
+    int i;
+
+    if (argc > 1)
+        loops = atoi(argv[1]);
+    if (loops <= 0)
+    {
+        rt_kprintf("Usage: pool_bench [loops]\n");
+        return -RT_ERROR;
+    }
+
+    rt_memset(&create, 0, sizeof(create));
+    rt_memset(&pool, 0, sizeof(pool));
+
+    pool_heap_used("before");
+
+    /* 1. 每次新建线程 */
+    for (i = 0; i < loops; i++)
+    {
+        start = rt_hw_cycle_get();
+        tid = rt_thread_create("pbench", pool_bench_job, RT_NULL,
+                               POOL_BENCH_STACK_SIZE, POOL_BENCH_PRIO, 10);
+        if (tid == RT_NULL)
+        {
+            rt_kprintf("thread create failed at %d\n", i);
+            break;
+        }
+        rt_thread_startup(tid);
+        /* 任务优先级更高, startup 返回时已执行完毕 */
+        pool_account(&create, start, rt_hw_cycle_get());
+        /* 让 idle 线程回收控制块和栈 */
+        rt_thread_delay(1);
+    }
+
+    pool_heap_used("after create");
+
+    /* 2. 线程池 */
+    for (i = 0; i < loops; i++)
+    {
+        start = rt_hw_cycle_get();
+        job = rt_thread_pool_submit(pool_bench_job, RT_NULL, RT_THREAD_POOL_NORMAL);
+        if (job == RT_NULL)
+        {
+            rt_kprintf("pool submit failed at %d\n", i);
+            break;
+        }
+        rt_thread_pool_wait(job, RT_WAITING_FOREVER);
+        pool_account(&pool, start, rt_hw_cycle_get());
+    }
+
+    pool_heap_used("after pool");
+
+    rt_kprintf("\n任务启动延迟 (%d 轮, 单位: 周期, round 为发起到任务结束)\n", loops);
+    rt_kprintf("method   launch avg launch max  round avg\n");
+    rt_kprintf("-------- ---------- ---------- ----------\n");
+    pool_report("create", &create);
+    pool_report("pool", &pool);
+    rt_kprintf("注: create 的 round 不含 idle 线程回收控制块和栈的时间\n");
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(pool_bench, thread pool launch latency: pool_bench [loops]);
+
+#endif /* RT_USING_THREAD_POOL */
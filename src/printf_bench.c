@@ -0,0 +1,101 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 格式化性能测试: rt_snprintf 按 kalman_sample 等遥测输出常用的格式
+ * 格式化一个参数, 统计每次调用的平均周期数. 作为对照, 给出原来按
+ * 整数拆分浮点数的 "%d.%02d" 写法, 以及逐位除 10 的数字转换.
+ * 最后一列为格式化结果, 用于核对.
+ */
+
+#ifdef RT_PRINTF_FLOAT
+
+#define PRINTF_BENCH_ROUNDS     100
+
+static char printf_bench_line[32];
+
+/* 测量 rounds 次 rt_snprintf 的平均周期数并输出一行 */
+#define PRINTF_BENCH(fmt, ...)                                              \
+    do                                                                      \
+    {                                                                       \
+        cycles = 0;                                                         \
+        for (r = 0; r < rounds; r++)                                        \
+        {                                                                   \
+            start = rt_hw_cycle_get();                                      \
+            rt_snprintf(printf_bench_line, sizeof(printf_bench_line),       \
+                        fmt, __VA_ARGS__);                                  \
+            cycles += rt_hw_cycle_get() - start;                            \
+        }                                                                   \
+        rt_kprintf("%-10s %7d  %s\n", fmt, cycles / rounds, printf_bench_line); \
+    }                                                                       \
+    while (0)
+
+/* 原来的数字转换: 每位一次除 10, 作为对照 */
+static int div10_utoa(char *buf, rt_uint32_t num)
+{
+    char tmp[10];
+    int i = 0, n = 0;
+
+    do
+    {
+        tmp[i++] = '0' + num % 10;
+        num /= 10;
+    }
+    while (num != 0);
+
+    while (i > 0)
+        buf[n++] = tmp[--i];
+    buf[n] = '\0';
+
+    return n;
+}
+
+int printf_bench(int argc, char **argv)
+{
+    /* volatile 防止编译器把参数当作常量 */
+    volatile float value = -12.345f;
+    volatile rt_int32_t small = 7, large = 1234567890;
+    volatile rt_int32_t fixed = -809042;    /* -12.345 的 Q16.16 */
+    rt_uint32_t start, cycles;
+    int rounds = PRINTF_BENCH_ROUNDS;
+    float v;
+    int r;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: printf_bench [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    rt_kprintf("\n格式化性能 (%d 次平均, 单位: 周期/次)\n", rounds);
+    rt_kprintf("format      cycles  result\n");
+
+    PRINTF_BENCH("%d", small);
+    PRINTF_BENCH("%d", large);
+    PRINTF_BENCH("%x", (rt_uint32_t)large);
+    PRINTF_BENCH("%08x", (rt_uint32_t)small);
+    PRINTF_BENCH("%.2f", value);
+    PRINTF_BENCH("%f", value);
+    PRINTF_BENCH("%.2q", fixed);
+
+    /* 原来的写法: 整数部分和两位小数分别按 %d 输出 */
+    v = value;
+    PRINTF_BENCH("%d.%02d", (int)v, (int)((v < (int)v ? (int)v - v : v - (int)v) * 100));
+
+    cycles = 0;
+    for (r = 0; r < rounds; r++)
+    {
+        start = rt_hw_cycle_get();
+        div10_utoa(printf_bench_line, large);
+        cycles += rt_hw_cycle_get() - start;
+    }
+    rt_kprintf("%-10s %7d  %s\n", "div10", cycles / rounds, printf_bench_line);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(printf_bench, rt_snprintf cycles per conversion: printf_bench [rounds]);
+
+#endif /* RT_PRINTF_FLOAT */
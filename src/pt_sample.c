@@ -0,0 +1,95 @@
+#include <rtthread.h>
+#include <rtpt.h>
+
+/*
+ * 协程示例: 两个协程共用 pt 线程, 代替两个各自带栈的线程
+ *   swpoll: 每 50ms 采样一次拨码开关, 变化时释放信号量并通知协程调度器
+ *   swshow: 等待信号量 (最多 5 秒), 打印开关值或超时
+ * 协程中跨等待保存的变量必须放在结构体里, 局部变量不会保留.
+ */
+
+#ifdef RT_USING_PT
+
+#define GPIO_SWs        0x80001400
+#define READ_GPIO(dir)  (*(volatile unsigned *)dir)
+
+struct sw_poll
+{
+    struct rt_pt pt;
+    rt_uint32_t value;
+};
+
+struct sw_show
+{
+    struct rt_pt pt;
+    rt_uint32_t changes;
+};
+
+static struct rt_semaphore sw_sem;
+static struct sw_poll sw_poll;
+static struct sw_show sw_show;
+static int sw_inited = 0;
+
+static int sw_poll_entry(struct rt_pt *pt)
+{
+    struct sw_poll *poll = rt_container_of(pt, struct sw_poll, pt);
+
+    RT_PT_BEGIN(pt);
+    poll->value = READ_GPIO(GPIO_SWs) >> 16;
+    while (1)
+    {
+        RT_PT_DELAY(pt, rt_tick_from_millisecond(50));
+        if ((READ_GPIO(GPIO_SWs) >> 16) != poll->value)
+        {
+            poll->value = READ_GPIO(GPIO_SWs) >> 16;
+            rt_sem_release(&sw_sem);
+            /* 让等待信号量的协程立即恢复 */
+            rt_pt_notify();
+        }
+    }
+    RT_PT_END(pt);
+}
+
+static int sw_show_entry(struct rt_pt *pt)
+{
+    struct sw_show *show = rt_container_of(pt, struct sw_show, pt);
+
+    RT_PT_BEGIN(pt);
+    while (1)
+    {
+        RT_PT_SEM_TAKE(pt, &sw_sem, rt_tick_from_millisecond(5000));
+        if (pt->result == RT_EOK)
+        {
+            show->changes++;
+            rt_kprintf("[pt] 开关值 0x%04x (第 %d 次变化)\n", sw_poll.value, show->changes);
+        }
+        else
+        {
+            rt_kprintf("[pt] 5 秒内开关没有变化\n");
+        }
+    }
+    RT_PT_END(pt);
+}
+
+int pt_sample(void)
+{
+    if (!sw_inited)
+    {
+        rt_sem_init(&sw_sem, "swsem", 0, RT_IPC_FLAG_FIFO);
+        rt_pt_init(&sw_poll.pt, "swpoll", sw_poll_entry, RT_NULL);
+        rt_pt_init(&sw_show.pt, "swshow", sw_show_entry, RT_NULL);
+        sw_inited = 1;
+    }
+
+    if (rt_pt_startup(&sw_poll.pt) != RT_EOK || rt_pt_startup(&sw_show.pt) != RT_EOK)
+    {
+        rt_kprintf("pt_sample 已在运行\n");
+        return -RT_EBUSY;
+    }
+
+    rt_kprintf("pt_sample 已启动, 拨动开关查看输出, list_pt 查看协程状态\n");
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(pt_sample, protothread sample);
+
+#endif /* RT_USING_PT */
@@ -0,0 +1,87 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 堆区域访问延迟测试: 分别用 RT_MEM_FAST (DCCM) 和 RT_MEM_LARGE (外部 RAM)
+ * 申请同样大小的缓冲区, 测量
+ *   write: 顺序写每个字
+ *   read : 顺序读每个字
+ *   chase: 按 64 字节步长的链表指针追逐, 每次访问依赖上一次的结果,
+ *          反映单次访问的真实延迟
+ * 结果为每次访问的平均周期数 (x100 显示两位小数).
+ */
+
+#define REGION_BENCH_KB         4
+#define REGION_BENCH_STRIDE     16      /* 字, 64 字节 */
+
+static void region_run(const char *name, rt_uint32_t hint, rt_uint32_t bytes)
+{
+    volatile rt_uint32_t *buf;
+    rt_uint32_t words, i, start, write, read, chase, sum, idx;
+
+    buf = (volatile rt_uint32_t *)rt_malloc_hint(bytes, hint);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("%-5s 申请 %d 字节失败\n", name, bytes);
+        return;
+    }
+    words = bytes / sizeof(rt_uint32_t);
+
+    start = rt_hw_cycle_get();
+    for (i = 0; i < words; i++)
+        buf[i] = i;
+    write = rt_hw_cycle_get() - start;
+
+    sum = 0;
+    start = rt_hw_cycle_get();
+    for (i = 0; i < words; i++)
+        sum += buf[i];
+    read = rt_hw_cycle_get() - start;
+
+    /* 链表: 每个节点指向下一个步长位置, 最后回到开头 */
+    for (i = 0; i < words; i += REGION_BENCH_STRIDE)
+        buf[i] = (i + REGION_BENCH_STRIDE < words) ? i + REGION_BENCH_STRIDE : 0;
+
+    idx = 0;
+    start = rt_hw_cycle_get();
+    for (i = 0; i < words; i++)
+        idx = buf[idx];
+    chase = rt_hw_cycle_get() - start;
+
+    rt_kprintf("%-5s 0x%08x %4d.%02d %4d.%02d %4d.%02d\n", name, (rt_uint32_t)buf,
+               write / words, (write * 100 / words) % 100,
+               read / words, (read * 100 / words) % 100,
+               chase / words, (chase * 100 / words) % 100);
+
+    /* 防止读循环被优化掉 */
+    if (sum + idx == 0xFFFFFFFF)
+        rt_kprintf("\n");
+
+    rt_free((void *)buf);
+}
+
+int region_bench(int argc, char **argv)
+{
+    int kb = REGION_BENCH_KB;
+
+    if (argc > 1)
+        kb = atoi(argv[1]);
+    if (kb <= 0)
+    {
+        rt_kprintf("Usage: region_bench [kb]\n");
+        return -RT_ERROR;
+    }
+
+#ifndef RT_USING_HEAP_FAST
+    rt_kprintf("RT_USING_HEAP_FAST 未打开, 两次申请都来自系统堆\n");
+#endif
+    rt_kprintf("\n堆区域访问延迟 (%d KB, 单位: 周期/次)\n", kb);
+    rt_kprintf("hint  address      write    read   chase\n");
+    rt_kprintf("----- ---------- ------- ------- -------\n");
+    region_run("fast", RT_MEM_FAST, kb * 1024);
+    region_run("large", RT_MEM_LARGE, kb * 1024);
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(region_bench, heap region access latency: region_bench [kb]);
@@ -105,22 +105,40 @@ void sm3(const uint8_t *message, size_t len, uint8_t digest[32]) {
         sm3_compress(v, block);
     }
 
-    // 填充消息
-    uint8_t *padded_message = (uint8_t *)rt_malloc(padded_len);
+    // 填充消息: 整块已处理, 只需拷贝最后不满 64 字节的部分再加填充, 共 1~2 块
+    size_t tail_len = padded_len - (len - remainder);
+    const uint8_t *tail = message + (len - remainder);
+    uint8_t *padded_message = NULL;
+#ifdef RT_USING_ARENA
+    // 线程有 arena 时从 arena 取临时缓冲区, 结束时一次归还
+    rt_arena_t arena = rt_arena_self();
+    rt_arena_mark_t mark = 0;
+
+    if (arena != RT_NULL) {
+        mark = rt_arena_mark(arena);
+        padded_message = (uint8_t *)rt_arena_alloc(arena, tail_len);
+        if (padded_message == NULL) {
+            arena = RT_NULL;    // arena 空间不够, 改用堆
+        }
+    }
+#endif
+    if (padded_message == NULL) {
+        padded_message = (uint8_t *)rt_malloc(tail_len);
+    }
     if (padded_message == NULL) {
         return;
     }
-    memcpy(padded_message, message, len);
-    padded_message[len] = 0x80;
-    for (i = len + 1; i < len + padding_len; i++) {
+    memcpy(padded_message, tail, remainder);
+    padded_message[remainder] = 0x80;
+    for (i = remainder + 1; i < remainder + padding_len; i++) {
         padded_message[i] = 0;
     }
     for (i = 0; i < 8; i++) {
-        padded_message[len + padding_len + i] = (bit_len >> ((7 - i) * 8)) & 0xff;
+        padded_message[remainder + padding_len + i] = (bit_len >> ((7 - i) * 8)) & 0xff;
     }
 
     // 处理填充后的消息块
-    for (i = 0; i < padded_len / 64; i++) {
+    for (i = 0; i < tail_len / 64; i++) {
         for (j = 0; j < 16; j++) {
             block[j] = (padded_message[i * 64 + j * 4] << 24) |
                        (padded_message[i * 64 + j * 4 + 1] << 16) |
@@ -137,9 +155,21 @@ void sm3(const uint8_t *message, size_t len, uint8_t digest[32]) {
         }
     }
 
+#ifdef RT_USING_ARENA
+    if (arena != RT_NULL) {
+        rt_arena_reset(arena, mark);
+        return;
+    }
+#endif
     rt_free(padded_message);
 }
 
+#ifdef RT_USING_ARENA
+// 示例线程的临时缓冲区, 填充最多 2 块
+static uint8_t sm3_arena_buffer[128];
+static struct rt_arena sm3_arena;
+#endif
+
 // SM3 示例函数，作为线程入口
 void sm3_sample(void *parameter) {
     const uint8_t message[] = "!Hello, SM3";
@@ -147,7 +177,16 @@ void sm3_sample(void *parameter) {
     uint8_t digest[32];
     int i;
 
+#ifdef RT_USING_ARENA
+    rt_arena_t old;
+
+    rt_arena_init(&sm3_arena, sm3_arena_buffer, sizeof(sm3_arena_buffer));
+    old = rt_arena_attach(RT_NULL, &sm3_arena);
+    sm3(message, strlen((const char *)message), digest);
+    rt_arena_attach(RT_NULL, old);
+#else
     sm3(message, strlen((const char *)message), digest);
+#endif
 
     rt_kprintf("SM3 digest: ");
     for (i = 0; i < 32; i++) {
@@ -0,0 +1,134 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdlib.h>
+
+/*
+ * 字符串函数性能测试: rt_strlen, rt_strcmp, rt_strncmp 与原来的逐字节
+ * 实现对比. 短字符串取对象名长度 (7 字节), 长字符串取一行控制台输出
+ * (120 字节); 比较的两个字符串内容相同, 一直比较到结尾, 第二个字符串
+ * 分别按对齐和不对齐 (偏移 1) 两种情况测试.
+ * 结果为 rounds 次的平均周期数, 括号内为逐字节实现.
+ */
+
+#define STR_BENCH_ROUNDS        100
+#define STR_BENCH_LONG          120
+
+static const rt_uint16_t str_bench_len[] =
+{
+    7, STR_BENCH_LONG
+};
+#define STR_BENCH_LEN_NR        (sizeof(str_bench_len) / sizeof(str_bench_len[0]))
+
+ALIGN(RT_ALIGN_SIZE)
+static char str_bench_a[STR_BENCH_LONG + 8];
+ALIGN(RT_ALIGN_SIZE)
+static char str_bench_b[STR_BENCH_LONG + 8];
+
+/* 原来的逐字节实现, 作为对照 */
+static rt_size_t byte_strlen(const char *s)
+{
+    const volatile char *sc;
+
+    for (sc = s; *sc != '\0'; ++sc) /* nothing */
+        ;
+
+    return sc - s;
+}
+
+static rt_int32_t byte_strcmp(const char *cs, const char *ct)
+{
+    const volatile char *s = cs;
+
+    while (*s && *s == *ct)
+        s++, ct++;
+
+    return (*s - *ct);
+}
+
+static rt_int32_t byte_strncmp(const char *cs, const char *ct, rt_ubase_t count)
+{
+    const volatile char *s = cs;
+    signed char res = 0;
+
+    while (count)
+    {
+        if ((res = *s - *ct++) != 0 || !*s++)
+            break;
+        count--;
+    }
+
+    return res;
+}
+
+int str_bench(int argc, char **argv)
+{
+    rt_uint32_t start, t_len, t_cmp, t_ncmp, b_len, b_cmp, b_ncmp;
+    const char *a, *b;
+    int rounds = STR_BENCH_ROUNDS;
+    int l, offset, r, i;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: str_bench [rounds]\n");
+        return -RT_ERROR;
+    }
+
+    rt_kprintf("\n字符串函数性能 (%d 次平均, 单位: 周期, 括号内为逐字节实现)\n", rounds);
+    rt_kprintf(" len ct    strlen        strcmp        strncmp\n");
+    rt_kprintf("---- -- ------------- ------------- -------------\n");
+
+    for (l = 0; l < STR_BENCH_LEN_NR; l++)
+    {
+        for (offset = 0; offset < 2; offset++)
+        {
+            a = str_bench_a;
+            b = str_bench_b + offset;
+            for (i = 0; i < str_bench_len[l]; i++)
+            {
+                str_bench_a[i] = 'a' + i % 26;
+                str_bench_b[i + offset] = 'a' + i % 26;
+            }
+            str_bench_a[i] = '\0';
+            str_bench_b[i + offset] = '\0';
+
+            t_len = t_cmp = t_ncmp = 0;
+            b_len = b_cmp = b_ncmp = 0;
+            for (r = 0; r < rounds; r++)
+            {
+                start = rt_hw_cycle_get();
+                rt_strlen(a);
+                t_len += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_strlen(a);
+                b_len += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                rt_strcmp(a, b);
+                t_cmp += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_strcmp(a, b);
+                b_cmp += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                rt_strncmp(a, b, STR_BENCH_LONG + 1);
+                t_ncmp += rt_hw_cycle_get() - start;
+
+                start = rt_hw_cycle_get();
+                byte_strncmp(a, b, STR_BENCH_LONG + 1);
+                b_ncmp += rt_hw_cycle_get() - start;
+            }
+
+            rt_kprintf("%4d %2s %5d (%5d) %5d (%5d) %5d (%5d)\n",
+                       str_bench_len[l], offset ? "+1" : "0",
+                       t_len / rounds, b_len / rounds, t_cmp / rounds, b_cmp / rounds,
+                       t_ncmp / rounds, b_ncmp / rounds);
+        }
+    }
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(str_bench, strlen/strcmp/strncmp word vs byte: str_bench [rounds]);